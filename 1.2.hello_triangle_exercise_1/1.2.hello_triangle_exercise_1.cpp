@@ -7,7 +7,7 @@
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-void frame_buffer_size_callback(GLFWwindow* window, int height, int width);
+void frame_buffer_size_callback(GLFWwindow* window, int width, int height);
 void process_input(GLFWwindow* window);
 
 float vertices[] =
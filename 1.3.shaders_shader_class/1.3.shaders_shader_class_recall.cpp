@@ -3,6 +3,29 @@
 #include <iostream>
 
 #include "Shader.h"
+#include "Context.h"
+#include "Benchmark.h"
+#include "BenchSuite.h"
+#include "FrameProfiler.h"
+#include "FixedTimestep.h"
+#include "FramePacer.h"
+#include "GoldenTest.h"
+#include "InputQueue.h"
+#include "RedrawScheduler.h"
+#include "ResizeManager.h"
+#include "SampleScenes.h"
+#include "Scene.h"
+#include "ShaderTranspiler.h"
+#include "SoftwarePresenter.h"
+#include "SoftwareRasterizer.h"
+#include "GLDebug.h"
+#include "GLResources.h"
+#include "VertexFormat.h"
+#include "MeshCooker.h"
+#include "MeshWelder.h"
+
+#include <cstdlib>
+#include <cstring>
 
 // window
 const int SCR_WIDTH{ 800 };
@@ -10,105 +33,388 @@ const int SCR_HEIGHT{ 600 };
 const char* WINDOW_NAME{ "recall_exercise" };
 
 // triangle
-const float vertices[]
-{	// vertex position  // vertex color
-	 0.0,  0.5, 0.0,	1.0, 0.0, 0.0,
-	-0.5, -0.5, 0.0,	0.0, 1.0, 0.0,
-	 0.5, -0.5, 0.0,	0.0, 0.0, 1.0
+struct ColorVertex
+{
+	float position[3];
+	float color[3];
+	typedef VertexFormat<attrib::Float<3>, attrib::Float<3>> Format;
+};
+VERTEX_FORMAT_CHECK(ColorVertex);
+
+const ColorVertex vertices[]
+{	// vertex position		// vertex color
+	{{  0.0f,  0.5f, 0.0f },	{ 1.0f, 0.0f, 0.0f }},
+	{{ -0.5f, -0.5f, 0.0f },	{ 0.0f, 1.0f, 0.0f }},
+	{{  0.5f, -0.5f, 0.0f },	{ 0.0f, 0.0f, 1.0f }}
 };
 
 // shader src paths
 //const char* vertexPath = "Y:/dev/learn_opengl/1.3.shaders_shader_class/shaders/vertex_shader.vert";
 //const char* fragmentPath = "Y:/dev/learn_opengl/1.3.shaders_shader_class/shaders/fragment_shader.frag";
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void process_input(GLFWwindow* window);
 
-int main()
+int main(int argc, char* argv[])
 {
-	// init and configure glfw
-	glfwInit();
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	bool benchDraws = false;
+	bool benchStrips = false;
+	bool benchLod = false;
+	bool benchSuite = false;
+	bool golden = false;
+	bool quantized = false;
+	bool software = false;
+	unsigned int softwareThreads = 0;
+	bool profile = false;
+	const char* profileCsv = NULL;
+	const char* sceneName = NULL;
+	int sceneCycle = 0;
 
+	SceneRegistry registry;
+	registerSampleScenes(registry);
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--bench-draws") == 0)
+			benchDraws = true;
+		else if (std::strcmp(argv[i], "--bench-strips") == 0)
+			benchStrips = true;
+		else if (std::strcmp(argv[i], "--bench-lod") == 0)
+			benchLod = true;
+		else if (std::strcmp(argv[i], "--bench-suite") == 0)
+			benchSuite = true;
+		else if (std::strcmp(argv[i], "--golden") == 0)
+			golden = true;
+		else if (std::strcmp(argv[i], "--quantized") == 0)
+			quantized = true;
+		else if (std::strcmp(argv[i], "--software") == 0)
+			software = true;
+		else if (std::strcmp(argv[i], "--software-threads") == 0 && i + 1 < argc)
+			softwareThreads = (unsigned int)std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--scene") == 0 && i + 1 < argc)
+			sceneName = argv[++i];
+		else if (std::strcmp(argv[i], "--scene-cycle") == 0 && i + 1 < argc)
+			sceneCycle = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--list-scenes") == 0)
+		{
+			registry.print();
+			return 0;
+		}
+		else if (std::strcmp(argv[i], "--profile") == 0)
+			profile = true;
+		else if (std::strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc)
+		{
+			profile = true;
+			profileCsv = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--bench-mesh-optimizer") == 0)
+		{
+			// CPU only, runs before any window is created
+			benchmarkMeshOptimizer(1024);
+			return 0;
+		}
+		else if (std::strcmp(argv[i], "--bench-weld") == 0)
+		{
+			benchmarkWelder(1500);
+			return 0;
+		}
+		else if (std::strcmp(argv[i], "--bench-meshlets") == 0)
+		{
+			benchmarkMeshletCulling(1024);
+			return 0;
+		}
+		else if (std::strcmp(argv[i], "--bench-software") == 0)
+		{
+			benchmarkSoftwareRasterizer(250000);
+			return 0;
+		}
+		else if (std::strcmp(argv[i], "--weld") == 0 && i + 3 < argc)
+		{
+			// --weld <soup.raw> <vertex bytes> <output prefix> [grid size]
+			float gridSize = i + 4 < argc ? (float)std::atof(argv[i + 4]) : 0.0f;
+			return weldFile(argv[i + 1], (std::size_t)std::atoi(argv[i + 2]), argv[i + 3], gridSize) ? 0 : -1;
+		}
+		else if (std::strcmp(argv[i], "--transpile") == 0 && i + 2 < argc)
+		{
+			// --transpile <output.cpp> <shader>..., the shaders the software rasterizer can run
+			return transpileShaders(std::vector<std::string>(argv + i + 2, argv + argc), argv[i + 1]) ? 0 : -1;
+		}
+	}
 
-	// create window
-	GLFWwindow* window;
-	window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, WINDOW_NAME, NULL, NULL);
-	if (window == NULL)
+	// --scene picks the scene to start with (or the only one to test), --quantized is a shorthand
+	int sceneIndex = registry.find(sceneName != NULL ? sceneName
+		: quantized ? "1.3.shaders_shader_class_quantized" : "1.3.shaders_shader_class");
+	if (sceneIndex < 0)
 	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
+		std::cout << "ERROR::SCENE::NOT_FOUND " << sceneName << ", --list-scenes shows them" << std::endl;
 		return -1;
 	}
 
-	glfwMakeContextCurrent(window);
-	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+	if (golden && software)
+	{
+		// the CPU backend against the same goldens, no context (or GPU) needed
+		GoldenOptions goldenOptions = parseGoldenOptions(argc, argv, GoldenOptions());
+		SoftwareRasterizer raster(softwareThreads);
+		raster.resize(goldenOptions.width, goldenOptions.height);
+		std::vector<Scene*> scenes;
+		std::vector<GoldenScene> goldenScenes;
+		InputMapper noInput;
+		for (int i = 0; i < registry.size(); i++)
+		{
+			if (sceneName != NULL && i != sceneIndex)
+				continue;
+			const SceneInfo& info = registry.get(i);
+			Scene* scene = info.factory();
+			scenes.push_back(scene);
+
+			GoldenScene golden;
+			golden.name = info.name;
+			golden.budgetMs = info.budgetMs;
+			golden.renderImage = [scene, &noInput, &raster](double time, GoldenImage& image)
+			{
+				SimulationStep step{ (unsigned long long)(time * 60.0 + 0.5), 1.0 / 60.0, time, time };
+				scene->update(step, noInput);
+				if (!scene->renderSoftware(raster, 1.0))
+				{
+					image = GoldenImage();
+					return;
+				}
+				raster.finish();
+				std::vector<unsigned char> rgba((std::size_t)raster.getWidth() * raster.getHeight() * 4);
+				raster.readPixels(rgba.data());
+				imageFromRgba(rgba.data(), raster.getWidth(), raster.getHeight(), image);
+			};
+			goldenScenes.push_back(golden);
+		}
+		bool passed = runGoldenTests(goldenScenes, goldenOptions);
+		raster.printStats();
+		for (Scene* scene : scenes)
+		{
+			delete scene;
+		}
+		return passed ? 0 : -1;
+	}
+
+	// create window and context (--no-error / --validate override the build default,
+	// --headless renders into an FBO without a window)
+	ContextOptions contextOptions;
+	contextOptions.width = SCR_WIDTH;
+	contextOptions.height = SCR_HEIGHT;
+	contextOptions.title = WINDOW_NAME;
+	contextOptions = parseContextOptions(argc, argv, contextOptions);
 
-	// load glad 
-	gladLoadGL();
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	ContextProvider* context = createContextProvider(contextOptions);
+	if (context == NULL)
 	{
-		std::cout << "Failed to load GLAD!" << std::endl;
+		return -1;
 	}
+	GLFWwindow* window = context->getWindow();
 
 	int nrAttribute;
 	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &nrAttribute);
 	std::cout << "Maximum vertex attributes : " << nrAttribute << std::endl;
 
-	// Shaders
-	// -------
-	Shader newShader = Shader("vertex_shader.vert", "fragment_shader.frag");
+	if (benchDraws || benchStrips || benchLod || benchSuite)
+	{
+		// Shaders
+		// -------
+		Shader newShader = Shader(quantized ? "vertex_shader_quantized.vert" : "vertex_shader.vert", "fragment_shader.frag");
+
+		// create VBO and VAO (DSA when available, nothing stays bound either way)
+		unsigned int VBO, VAO;
+		if (quantized)
+		{
+			// unorm16 positions + rgba8 colors, the shader gets the bounds to undo the quantization
+			CookedMesh<CookedColorVertex> cooked = cookColorMesh(&vertices[0].position[0], 3);
+			cooked.report.print("triangle");
+			VBO = createBuffer(cooked.vertices.size() * sizeof(CookedColorVertex), cooked.vertices.data());
+			VAO = createVertexArray(CookedColorVertex::Format::layout(), VBO);
 
-	// generate and bind VAO and VBO
-	unsigned int VBO, VAO;
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
-	// you need to bind the Vertex Array Object to set vertex buffers
-	glBindVertexArray(VAO);
+			newShader.addUniformVec3("uPositionScale", cooked.positionScale);
+			newShader.addUniformVec3("uPositionBias", cooked.positionBias);
+		}
+		else
+		{
+			// stride and offsets come from ColorVertex::Format
+			VBO = createBuffer(sizeof(vertices), vertices);
+			VAO = createVertexArray(ColorVertex::Format::layout(), VBO);
+		}
 
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+		bool written = true;
+		if (benchDraws)
+			benchmarkDrawCalls(*context, newShader, VAO, 10000, 100);
+		if (benchStrips)
+			benchmarkStripDraws(*context, newShader, 512, 50);
+		if (benchLod)
+			benchmarkLodChain(256);
+		if (benchSuite)
+			written = runBenchSuite(*context, parseBenchOptions(argc, argv, BenchOptions()));
+		delete context;
+		return written ? 0 : -1;
+	}
+
+	if (golden)
+	{
+		// every registered scene, or only --scene
+		bool passed = false;
+		{
+			SceneResources resources(*context);
+			std::vector<Scene*> scenes;
+			std::vector<GoldenScene> goldenScenes;
+			InputMapper noInput;
+			for (int i = 0; i < registry.size(); i++)
+			{
+				if (sceneName != NULL && i != sceneIndex)
+					continue;
+				const SceneInfo& info = registry.get(i);
+				Scene* scene = info.factory();
+				scenes.push_back(scene);
+				if (!scene->init(resources))
+					std::cout << "ERROR::SCENE::INIT_FAILED " << info.name << std::endl;
 
-	// configure vertex attributes
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),(void*)(sizeof(float)*3));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
+				GoldenScene golden;
+				golden.name = info.name;
+				golden.budgetMs = info.budgetMs;
+				golden.render = [scene, &noInput](double time)
+				{
+					// one 1/60 step per frame, drawn at the step itself
+					SimulationStep step{ (unsigned long long)(time * 60.0 + 0.5), 1.0 / 60.0, time, time };
+					scene->update(step, noInput);
+					scene->render(1.0);
+				};
+				goldenScenes.push_back(golden);
+			}
+			passed = runGoldenTests(*context, goldenScenes, parseGoldenOptions(argc, argv, GoldenOptions()));
+			for (Scene* scene : scenes)
+			{
+				scene->shutdown(resources);
+				delete scene;
+			}
+		}
+		delete context;
+		return passed ? 0 : -1;
+	}
 
-	// render loop
-	while (!glfwWindowShouldClose(window))
+	// render loop, --profile prints per pass CPU / GPU timings and pacing, redraw, resize and
+	// simulation stats on exit.
+	// --on-demand only redraws after input or a resize, or every frame while the scene animates.
+	// Left / Right (or --scene-cycle <frames>) switch scenes in place, --software draws them
+	// with the CPU rasterizer (--software-threads <n>, all cores by default)
 	{
-		process_input(window);
+		// scoped so queries, fences and scene resources are deleted while the context is alive
+		FrameProfiler profiler(profile);
+		FramePacer pacer(*context, parsePacingOptions(argc, argv, PacingOptions()));
+		// input first, so the redraw scheduler's callbacks chain to it
+		InputQueue input(window);
+		InputMapper mapper;
+		int quitAction = mapper.bindAction("quit", InputEventType::Key, GLFW_KEY_ESCAPE);
+		int nextAction = mapper.bindAction("next_scene", InputEventType::Key, GLFW_KEY_RIGHT);
+		int previousAction = mapper.bindAction("previous_scene", InputEventType::Key, GLFW_KEY_LEFT);
+		mapper.bindAction("next_scene", InputEventType::Key, GLFW_KEY_PAGE_DOWN);
+		mapper.bindAction("previous_scene", InputEventType::Key, GLFW_KEY_PAGE_UP);
+		// resizes are applied once per frame, --offscreen renders through a pooled target
+		ResizeOptions resizeOptions = parseResizeOptions(argc, argv, ResizeOptions());
+		SceneResources resources(*context, resizeOptions.bucket);
+		ResizeManager resize(*context, resources.getTargets(), resizeOptions);
+		SceneLauncher launcher(registry, resources);
+		launcher.switchTo(sceneIndex);
+		RedrawScheduler redraw(*context, parseRedrawOptions(argc, argv, RedrawOptions()));
+		redraw.setAnimated(launcher.isAnimated());
+		// the simulation steps at --sim-rate, rendering interpolates between its last two states
+		FixedTimestep simulation(parseTimestepOptions(argc, argv, TimestepOptions()), context->getTime());
+		// only with --software, its worker threads would idle through every GL run
+		SoftwareRasterizer* raster = software ? new SoftwareRasterizer(softwareThreads) : NULL;
+		SoftwarePresenter presenter;
+		unsigned long long frame = 0;
+		while (!context->shouldClose())
+		{
+			if (!redraw.waitForRedraw())
+				continue;
+			// the idle gap isn't dropped time to catch up on. one step stays due, for the input that woke us
+			if (redraw.resumedFromIdle())
+				simulation.resync(context->getTime() - simulation.getStep());
 
-		glClearColor(0.25, 0.3, 0.5, 1.0);
-		glClear(GL_COLOR_BUFFER_BIT);
-		
-		newShader.addUniformFloat("uTime", glfwGetTime());
+			profiler.beginFrame();
+			profiler.beginCpu("pacing");
+			pacer.beginFrame();
+			profiler.endCpu();
 
+			context->pollEvents();
+			int switchTo = -1;
+			if (sceneCycle > 0 && frame > 0 && frame % sceneCycle == 0)
+				switchTo = (launcher.getActiveIndex() + 1) % registry.size();
+			profiler.beginCpu("simulation");
+			simulation.advance(context->getTime(), [&](const SimulationStep& step)
+			{
+				// input stamped up to the end of the step, so a press lands in the step it happened in
+				mapper.update(input, step.realTime);
+				if (mapper.wasPressed(quitAction) && window != NULL)
+					glfwSetWindowShouldClose(window, GLFW_TRUE);
+				if (mapper.wasPressed(nextAction))
+					switchTo = (launcher.getActiveIndex() + 1) % registry.size();
+				if (mapper.wasPressed(previousAction))
+					switchTo = (launcher.getActiveIndex() + registry.size() - 1) % registry.size();
+				launcher.update(step, mapper);
+			});
+			profiler.endCpu();
 
-		glBindVertexArray(VAO);
-		newShader.useShader();
-		glDrawArrays(GL_TRIANGLES, 0, 3);
-		
-		glfwSwapBuffers(window);
-		glfwPollEvents();
-	}
+			if (switchTo >= 0)
+			{
+				profiler.beginCpu("switch");
+				launcher.switchTo(switchTo);
+				redraw.setAnimated(launcher.isAnimated());
+				redraw.requestRedraw();
+				profiler.endCpu();
+			}
+			resize.beginFrame();
 
-	glfwTerminate();
-	return 0;
-}
+			{
+				ProfileScope scope(profiler, "scene");
+				resize.bindSceneTarget();
+				if (!software)
+				{
+					launcher.render(simulation.getAlpha());
+				}
+				else
+				{
+					raster->resize(resize.getSceneWidth(), resize.getSceneHeight());
+					if (!launcher.renderSoftware(*raster, simulation.getAlpha()))
+						raster->clear(1.0f, 0.0f, 1.0f, 1.0f);
+					raster->finish();
+					presenter.present(*raster);
+				}
+			}
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-	glViewport(0, 0, width, height);
-}
+			if (resizeOptions.offscreen)
+			{
+				ProfileScope scope(profiler, "present");
+				resize.present();
+			}
+			// on demand, keep drawing until a held back scene target has caught up
+			if (resize.isResizing())
+				redraw.requestRedraw();
 
-void process_input(GLFWwindow* window)
-{
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(window, GLFW_TRUE);
+			profiler.beginCpu("swap");
+			pacer.endFrame();
+			profiler.endCpu();
+			profiler.endFrame();
+			frame++;
+		}
+
+		if (profile)
+		{
+			profiler.flush();
+			profiler.printSummary();
+			pacer.printStats();
+			redraw.printStats();
+			resize.printStats();
+			simulation.printStats();
+			if (software)
+				raster->printStats();
+			if (profileCsv != NULL)
+				profiler.writeCsv(profileCsv);
+		}
+		delete raster;
 	}
+
+	delete context;
+	return 0;
 }
@@ -0,0 +1,514 @@
+#include "BenchSuite.h"
+#include "GLDebug.h"
+#include "GLExtensions.h"
+#include "GLResources.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+#include "VertexFormat.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+
+typedef VertexFormat<attrib::Float<3>> PositionFormat;
+
+BenchOptions parseBenchOptions(int argc, char* argv[], BenchOptions options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--bench-json") == 0 && i + 1 < argc)
+			options.jsonPath = argv[++i];
+		else if (std::strcmp(argv[i], "--bench-filter") == 0 && i + 1 < argc)
+			options.filter = argv[++i];
+		else if (std::strcmp(argv[i], "--bench-min-time") == 0 && i + 1 < argc)
+			options.minSeconds = std::atof(argv[++i]);
+	}
+	return options;
+}
+
+// Runner
+// ------
+struct BenchRun
+{
+	ContextProvider& context;
+	const BenchOptions& options;
+	std::vector<BenchResult>& results;
+
+	bool selected(const std::string& name) const
+	{
+		return options.filter == NULL || name.find(options.filter) != std::string::npos;
+	}
+
+	// times frame() until minSeconds have passed, returns the new result for counters
+	BenchResult& run(const std::string& name, const std::function<void()>& frame)
+	{
+		using clock = std::chrono::steady_clock;
+		for (int i = 0; i < 3; i++)
+		{
+			glClear(GL_COLOR_BUFFER_BIT);
+			frame();
+			glFinish();
+		}
+
+		double realSeconds = 0.0;
+		double cpuSeconds = 0.0;
+		long long iterations = 0;
+		while ((realSeconds < options.minSeconds && iterations < options.maxFrames) || iterations == 0)
+		{
+			clock::time_point start = clock::now();
+			glClear(GL_COLOR_BUFFER_BIT);
+			frame();
+			clock::time_point submitted = clock::now();
+			glFinish();
+			clock::time_point finished = clock::now();
+			context.pollEvents();
+
+			cpuSeconds += std::chrono::duration<double>(submitted - start).count();
+			realSeconds += std::chrono::duration<double>(finished - start).count();
+			iterations++;
+		}
+		glCheckError();
+
+		BenchResult result;
+		result.name = name;
+		result.iterations = iterations;
+		result.realUs = realSeconds * 1e6 / iterations;
+		result.cpuUs = cpuSeconds * 1e6 / iterations;
+		results.push_back(result);
+		return results.back();
+	}
+};
+
+// Scenes
+// ------
+// side x side quads over clip space, 2 * side^2 triangles
+static void makeGrid(unsigned int side, std::vector<float>& positions, std::vector<unsigned int>& indices)
+{
+	for (unsigned int y = 0; y <= side; y++)
+	{
+		for (unsigned int x = 0; x <= side; x++)
+		{
+			positions.push_back(-1.0f + 2.0f * x / side);
+			positions.push_back(-1.0f + 2.0f * y / side);
+			positions.push_back(0.0f);
+		}
+	}
+	for (unsigned int y = 0; y < side; y++)
+	{
+		for (unsigned int x = 0; x < side; x++)
+		{
+			unsigned int i = y * (side + 1) + x;
+			unsigned int cell[6] = { i, i + 1, i + side + 1, i + 1, i + side + 2, i + side + 1 };
+			indices.insert(indices.end(), cell, cell + 6);
+		}
+	}
+}
+
+// where draw i of count goes, a tiny triangle on a grid so raster cost stays negligible
+static void drawOffset(int i, int count, float* offset)
+{
+	int side = (int)std::ceil(std::sqrt((double)count));
+	offset[0] = -0.95f + 1.9f * (i % side) / side;
+	offset[1] = -0.95f + 1.9f * (i / side) / side;
+	offset[2] = 0.01f;
+}
+
+static const float triangle[] = { 0.0f, 1.0f, 0.0f, -1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 0.0f };
+
+static void benchTriangles(BenchRun& bench)
+{
+	const unsigned int sides[] = { 16, 64, 256, 512 };
+	Shader shader("bench.vert", "fragment_shader.frag");
+	const float full[3] = { 0.0f, 0.0f, 1.0f };
+	for (unsigned int side : sides)
+	{
+		std::string name = "BM_Triangles/" + std::to_string(2 * side * side);
+		if (!bench.selected(name))
+			continue;
+
+		std::vector<float> positions;
+		std::vector<unsigned int> indices;
+		makeGrid(side, positions, indices);
+		unsigned int VBO = createBuffer(positions.size() * sizeof(float), positions.data());
+		unsigned int EBO = createBuffer(indices.size() * sizeof(unsigned int), indices.data());
+		unsigned int VAO = createVertexArray(PositionFormat::layout(), VBO, EBO);
+
+		GLsizei count = (GLsizei)indices.size();
+		BenchResult& result = bench.run(name, [&]()
+		{
+			shader.useShader();
+			shader.setUniformVec3(shader.getUniformLocation("uOffset"), full);
+			bindVertexArray(VAO);
+			glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)0);
+		});
+		result.counters.push_back(std::make_pair("triangles_per_second", count / 3 / (result.realUs * 1e-6)));
+
+		deleteVertexArray(VAO);
+		deleteBuffer(VBO);
+		deleteBuffer(EBO);
+	}
+	deleteProgram(shader.getID());
+}
+
+static void benchDraws(BenchRun& bench, unsigned int VAO)
+{
+	const int counts[] = { 100, 1000, 10000 };
+	Shader shader("bench.vert", "fragment_shader.frag");
+	GLint offsetLocation = shader.getUniformLocation("uOffset");
+	for (int count : counts)
+	{
+		std::string name = "BM_Draws/" + std::to_string(count);
+		if (!bench.selected(name))
+			continue;
+
+		BenchResult& result = bench.run(name, [&]()
+		{
+			shader.useShader();
+			bindVertexArray(VAO);
+			for (int i = 0; i < count; i++)
+			{
+				float offset[3];
+				drawOffset(i, count, offset);
+				shader.setUniformVec3(offsetLocation, offset);
+				glDrawArrays(GL_TRIANGLES, 0, 3);
+			}
+		});
+		result.counters.push_back(std::make_pair("draws_per_second", count / (result.realUs * 1e-6)));
+		result.counters.push_back(std::make_pair("cpu_ns_per_draw", result.cpuUs * 1e3 / count));
+	}
+	deleteProgram(shader.getID());
+}
+
+static void benchPrograms(BenchRun& bench, unsigned int VAO)
+{
+	const int programCounts[] = { 1, 4, 16 };
+	const int drawCount = 1000;
+	for (int programCount : programCounts)
+	{
+		std::string name = "BM_Programs/" + std::to_string(programCount);
+		if (!bench.selected(name))
+			continue;
+
+		// separately linked copies of the same program, what matters is the switch
+		std::vector<Shader> shaders;
+		std::vector<GLint> locations;
+		for (int p = 0; p < programCount; p++)
+		{
+			shaders.push_back(Shader("bench.vert", "fragment_shader.frag"));
+			locations.push_back(shaders.back().getUniformLocation("uOffset"));
+		}
+
+		BenchResult& result = bench.run(name, [&]()
+		{
+			bindVertexArray(VAO);
+			for (int i = 0; i < drawCount; i++)
+			{
+				Shader& shader = shaders[i % programCount];
+				float offset[3];
+				drawOffset(i, drawCount, offset);
+				shader.useShader();
+				shader.setUniformVec3(locations[i % programCount], offset);
+				glDrawArrays(GL_TRIANGLES, 0, 3);
+			}
+		});
+		result.counters.push_back(std::make_pair("cpu_ns_per_draw", result.cpuUs * 1e3 / drawCount));
+
+		for (Shader& shader : shaders)
+		{
+			deleteProgram(shader.getID());
+		}
+	}
+}
+
+static void benchUniforms(BenchRun& bench, unsigned int VAO)
+{
+	const int drawCount = 1000;
+	float time = 0.0f;
+
+	if (bench.selected("BM_Uniforms/lookup"))
+	{
+		// what the samples do: name lookups and a GL call for every uniform of every draw
+		Shader shader("bench.vert", "fragment_shader.frag");
+		BenchResult& result = bench.run("BM_Uniforms/lookup", [&]()
+		{
+			time += 0.016f;
+			shader.useShader();
+			bindVertexArray(VAO);
+			for (int i = 0; i < drawCount; i++)
+			{
+				float offset[3];
+				drawOffset(i, drawCount, offset);
+				shader.addUniformFloat("uTime", time);
+				shader.addUniformVec3("uOffset", offset);
+				glDrawArrays(GL_TRIANGLES, 0, 3);
+			}
+		});
+		result.counters.push_back(std::make_pair("cpu_ns_per_draw", result.cpuUs * 1e3 / drawCount));
+		deleteProgram(shader.getID());
+	}
+
+	if (bench.selected("BM_Uniforms/shadowed"))
+	{
+		// cached locations, uTime only reaches GL once per frame
+		Shader shader("bench.vert", "fragment_shader.frag");
+		GLint timeLocation = shader.getUniformLocation("uTime");
+		GLint offsetLocation = shader.getUniformLocation("uOffset");
+		BenchResult& result = bench.run("BM_Uniforms/shadowed", [&]()
+		{
+			time += 0.016f;
+			shader.useShader();
+			bindVertexArray(VAO);
+			for (int i = 0; i < drawCount; i++)
+			{
+				float offset[3];
+				drawOffset(i, drawCount, offset);
+				shader.setUniformFloat(timeLocation, time);
+				shader.setUniformVec3(offsetLocation, offset);
+				glDrawArrays(GL_TRIANGLES, 0, 3);
+			}
+		});
+		result.counters.push_back(std::make_pair("cpu_ns_per_draw", result.cpuUs * 1e3 / drawCount));
+		deleteProgram(shader.getID());
+	}
+
+	if (bench.selected("BM_Uniforms/ubo"))
+	{
+		// every draw's block written once per frame, each draw binds its own range
+		Shader shader("bench_ubo.vert", "fragment_shader.frag");
+		glUniformBlockBinding(shader.getID(), glGetUniformBlockIndex(shader.getID(), "DrawData"), 0);
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		GLsizeiptr stride = (16 + alignment - 1) / alignment * alignment;
+
+		std::vector<float> blocks(stride / sizeof(float) * drawCount);
+		unsigned int UBO = createBuffer(stride * drawCount, NULL, true);
+		BenchResult& result = bench.run("BM_Uniforms/ubo", [&]()
+		{
+			time += 0.016f;
+			for (int i = 0; i < drawCount; i++)
+			{
+				float* block = &blocks[i * stride / sizeof(float)];
+				drawOffset(i, drawCount, block);
+				block[3] = time;
+			}
+			updateBuffer(UBO, 0, stride * drawCount, blocks.data());
+
+			shader.useShader();
+			bindVertexArray(VAO);
+			for (int i = 0; i < drawCount; i++)
+			{
+				glBindBufferRange(GL_UNIFORM_BUFFER, 0, UBO, i * stride, 16);
+				glDrawArrays(GL_TRIANGLES, 0, 3);
+			}
+		});
+		result.counters.push_back(std::make_pair("cpu_ns_per_draw", result.cpuUs * 1e3 / drawCount));
+		deleteBuffer(UBO);
+		deleteProgram(shader.getID());
+	}
+}
+
+static void benchUploads(BenchRun& bench)
+{
+	// a soup of tiny triangles, rewritten and drawn every frame
+	const int triangleCount = 16384;
+	std::vector<float> soup;
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> position(-0.95f, 0.95f);
+	for (int t = 0; t < triangleCount; t++)
+	{
+		float x = position(random), y = position(random);
+		for (int v = 0; v < 9; v += 3)
+		{
+			soup.push_back(x + triangle[v] * 0.005f);
+			soup.push_back(y + triangle[v + 1] * 0.005f);
+			soup.push_back(0.0f);
+		}
+	}
+	const GLsizeiptr bytes = soup.size() * sizeof(float);
+	const GLsizei vertexCount = triangleCount * 3;
+	const float identity[3] = { 0.0f, 0.0f, 1.0f };
+
+	Shader shader("bench.vert", "fragment_shader.frag");
+	GLint offsetLocation = shader.getUniformLocation("uOffset");
+
+	// glBufferData / glBufferSubData need mutable storage, so not createBuffer (immutable with DSA)
+	const char* mutableNames[] = { "BM_Upload/buffer_data", "BM_Upload/sub_data" };
+	for (int strategy = 0; strategy < 2; strategy++)
+	{
+		if (!bench.selected(mutableNames[strategy]))
+			continue;
+
+		unsigned int VBO;
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+		glBufferData(GL_COPY_WRITE_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		unsigned int VAO = createVertexArray(PositionFormat::layout(), VBO);
+
+		BenchResult& result = bench.run(mutableNames[strategy], [&]()
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+			if (strategy == 0)
+				glBufferData(GL_COPY_WRITE_BUFFER, bytes, soup.data(), GL_STREAM_DRAW);
+			else
+				glBufferSubData(GL_COPY_WRITE_BUFFER, 0, bytes, soup.data());
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+			shader.useShader();
+			shader.setUniformVec3(offsetLocation, identity);
+			bindVertexArray(VAO);
+			glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+		});
+		result.counters.push_back(std::make_pair("upload_MB_per_second", bytes / (result.realUs * 1e-6) / (1 << 20)));
+
+		deleteVertexArray(VAO);
+		deleteBuffer(VBO);
+	}
+
+	// StreamBuffer picks its path from GLExt at construction, so the 3.3 one can be forced
+	const char* streamNames[] = { "BM_Upload/map_unsynchronized", "BM_Upload/persistent" };
+	for (int strategy = 0; strategy < 2; strategy++)
+	{
+		if (!bench.selected(streamNames[strategy]))
+			continue;
+		if (strategy == 1 && !GLExt.bufferStorage)
+		{
+			std::cout << "BENCHMARK::SUITE " << streamNames[strategy] << " skipped, no ARB_buffer_storage" << std::endl;
+			continue;
+		}
+
+		bool bufferStorage = GLExt.bufferStorage;
+		GLExt.bufferStorage = strategy == 1;
+		StreamBuffer stream(bytes * 3);
+		GLExt.bufferStorage = bufferStorage;
+		unsigned int VAO = createVertexArray(PositionFormat::layout(), stream.getID());
+
+		BenchResult& result = bench.run(streamNames[strategy], [&]()
+		{
+			StreamAllocation allocation = stream.map(bytes, PositionFormat::stride);
+			std::memcpy(allocation.ptr, soup.data(), bytes);
+			stream.unmap(bytes);
+
+			shader.useShader();
+			shader.setUniformVec3(offsetLocation, identity);
+			bindVertexArray(VAO);
+			glDrawArrays(GL_TRIANGLES, (GLint)(allocation.offset / PositionFormat::stride), vertexCount);
+			stream.endFrame();
+		});
+		result.counters.push_back(std::make_pair("upload_MB_per_second", bytes / (result.realUs * 1e-6) / (1 << 20)));
+
+		deleteVertexArray(VAO);
+	}
+	deleteProgram(shader.getID());
+}
+
+bool runBenchSuite(ContextProvider& context, const BenchOptions& options)
+{
+	std::vector<BenchResult> results;
+	BenchRun bench{ context, options, results };
+
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	unsigned int VBO = createBuffer(sizeof(triangle), triangle);
+	unsigned int VAO = createVertexArray(PositionFormat::layout(), VBO);
+
+	benchTriangles(bench);
+	benchDraws(bench, VAO);
+	benchPrograms(bench, VAO);
+	benchUniforms(bench, VAO);
+	benchUploads(bench);
+
+	deleteVertexArray(VAO);
+	deleteBuffer(VBO);
+
+	for (const BenchResult& result : results)
+	{
+		std::cout << "BENCHMARK::SUITE " << result.name
+			<< " iterations=" << result.iterations
+			<< " real_us=" << result.realUs
+			<< " cpu_us=" << result.cpuUs;
+		for (const std::pair<std::string, double>& counter : result.counters)
+		{
+			std::cout << " " << counter.first << "=" << counter.second;
+		}
+		std::cout << std::endl;
+	}
+
+	if (options.jsonPath != NULL)
+		return writeBenchJson(options.jsonPath, context, results);
+	return true;
+}
+
+// JSON
+// ----
+static std::string jsonString(const char* text)
+{
+	std::string quoted = "\"";
+	for (const char* c = text; c != NULL && *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			quoted += '\\';
+		if ((unsigned char)*c >= 0x20)
+			quoted += *c;
+	}
+	return quoted + "\"";
+}
+
+bool writeBenchJson(const char* path, const ContextProvider& context, const std::vector<BenchResult>& results)
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR::BENCHMARK::JSON_NOT_WRITABLE " << path << std::endl;
+		return false;
+	}
+
+	char date[32];
+	std::time_t now = std::time(NULL);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	file << "{\n  \"context\": {\n"
+		<< "    \"date\": " << jsonString(date) << ",\n"
+		<< "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+		<< "    \"library_build_type\": \"release\",\n"
+#else
+		<< "    \"library_build_type\": \"debug\",\n"
+#endif
+		<< "    \"gl_version\": " << jsonString((const char*)glGetString(GL_VERSION)) << ",\n"
+		<< "    \"gl_renderer\": " << jsonString((const char*)glGetString(GL_RENDERER)) << ",\n"
+		<< "    \"headless\": " << (context.getWindow() == NULL ? "true" : "false") << ",\n"
+		<< "    \"no_error\": " << (isNoErrorContext() ? "true" : "false") << ",\n"
+		<< "    \"debug_checks\": " << GL_DEBUG_CHECKS << ",\n"
+		<< "    \"direct_state_access\": " << (GLExt.directStateAccess ? "true" : "false") << "\n"
+		<< "  },\n  \"benchmarks\": [";
+
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const BenchResult& result = results[i];
+		file << (i > 0 ? ",\n" : "\n") << "    {\n"
+			<< "      \"name\": " << jsonString(result.name.c_str()) << ",\n"
+			<< "      \"run_name\": " << jsonString(result.name.c_str()) << ",\n"
+			<< "      \"run_type\": \"iteration\",\n"
+			<< "      \"repetitions\": 1,\n"
+			<< "      \"repetition_index\": 0,\n"
+			<< "      \"threads\": 1,\n"
+			<< "      \"iterations\": " << result.iterations << ",\n"
+			<< "      \"real_time\": " << result.realUs << ",\n"
+			<< "      \"cpu_time\": " << result.cpuUs << ",\n"
+			<< "      \"time_unit\": \"us\"";
+		for (const std::pair<std::string, double>& counter : result.counters)
+		{
+			file << ",\n      " << jsonString(counter.first.c_str()) << ": " << counter.second;
+		}
+		file << "\n    }";
+	}
+	file << "\n  ]\n}\n";
+	return true;
+}
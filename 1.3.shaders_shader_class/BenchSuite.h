@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Context.h"
+
+// Benchmark suite
+// ---------------
+/// \note: sweeps of the submission and upload paths, meant to run on the headless backend:
+///			BM_Triangles/<n>     one draw of an n triangle grid
+///			BM_Draws/<n>         n draws of a tiny triangle, one uniform update each
+///			BM_Programs/<n>      1000 draws switching between n programs every draw
+///			BM_Uniforms/<how>    1000 draws: addUniform* by name (lookup), cached location +
+///			                     shadowed value (shadowed), one UBO upload + range per draw (ubo)
+///			BM_Upload/<how>      ~590KB of vertices streamed and drawn each frame with
+///			                     glBufferData orphaning, glBufferSubData, StreamBuffer on its
+///			                     3.3 unsynchronized map path and StreamBuffer persistent
+///		   Every iteration is one frame ending in glFinish. real_time is the whole frame,
+///		   cpu_time only the submission before glFinish, both in microseconds.
+///		   The JSON has the layout of Google Benchmark's --benchmark_format=json (context +
+///		   benchmarks, counters as extra keys), so its compare.py can diff two runs.
+///
+///		   --bench-suite --headless [--bench-json out.json] [--bench-filter Draws] [--bench-min-time 0.5]
+struct BenchOptions
+{
+	const char* jsonPath{ NULL };
+	const char* filter{ NULL };	// only benchmarks whose name contains it
+	double minSeconds{ 0.25 };	// per benchmark, after warm up
+	int maxFrames{ 2000 };
+};
+
+BenchOptions parseBenchOptions(int argc, char* argv[], BenchOptions options);
+
+struct BenchResult
+{
+	std::string name;
+	long long iterations{ 0 };
+	double realUs{ 0.0 };
+	double cpuUs{ 0.0 };
+	std::vector<std::pair<std::string, double>> counters;
+};
+
+// runs every benchmark matching the filter, prints them and writes the JSON if asked.
+// false if the JSON couldn't be written
+bool runBenchSuite(ContextProvider& context, const BenchOptions& options);
+
+bool writeBenchJson(const char* path, const ContextProvider& context, const std::vector<BenchResult>& results);
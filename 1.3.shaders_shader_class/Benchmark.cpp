@@ -0,0 +1,493 @@
+#include "Benchmark.h"
+#include "GLDebug.h"
+#include "GLResources.h"
+#include "MeshOptimizer.h"
+#include "MeshWelder.h"
+#include "Meshlets.h"
+#include "MeshSimplifier.h"
+#include "SoftwareRasterizer.h"
+#include "Stripifier.h"
+#include "VertexFormat.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+void benchmarkDrawCalls(ContextProvider& context, Shader& shader, unsigned int VAO, int drawCount, int frameCount)
+{
+	using clock = std::chrono::steady_clock;
+	double submitSeconds = 0.0;
+	double finishSeconds = 0.0;
+
+	shader.useShader();
+	bindVertexArray(VAO);
+
+	// one warm up frame so shader and buffer residency is not part of the timing
+	for (int frame = -1; frame < frameCount; frame++)
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		clock::time_point start = clock::now();
+		for (int i = 0; i < drawCount; i++)
+		{
+			shader.addUniformFloat("uTime", (float)i);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		}
+		clock::time_point submitted = clock::now();
+		glFinish();
+		clock::time_point finished = clock::now();
+
+		if (frame >= 0)
+		{
+			submitSeconds += std::chrono::duration<double>(submitted - start).count();
+			finishSeconds += std::chrono::duration<double>(finished - submitted).count();
+		}
+
+		context.swapBuffers();
+		context.pollEvents();
+	}
+	glCheckError();
+
+	double draws = (double)drawCount * frameCount;
+	std::cout << "BENCHMARK::DRAW_CALLS"
+		<< " no_error=" << isNoErrorContext()
+		<< " debug_checks=" << GL_DEBUG_CHECKS
+		<< " draws=" << drawCount << "x" << frameCount
+		<< " cpu_ns_per_draw=" << submitSeconds * 1e9 / draws
+		<< " finish_ms_per_frame=" << finishSeconds * 1e3 / frameCount << std::endl;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printCacheStats(const char* pass, const std::vector<unsigned int>& indices, std::size_t vertexCount, double seconds,
+	const std::vector<float>* positions = NULL)
+{
+	VertexCacheStats stats = analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+	std::cout << "BENCHMARK::MESH_OPTIMIZER::" << pass
+		<< " acmr=" << stats.acmr
+		<< " atvr=" << stats.atvr;
+	if (positions != NULL)
+	{
+		OverdrawStats overdraw = analyzeOverdraw(indices.data(), indices.size(), positions->data(), vertexCount, 3 * sizeof(float));
+		std::cout << " overdraw=" << overdraw.overdraw;
+	}
+	std::cout << " ms=" << seconds * 1e3 << std::endl;
+}
+
+// unit UV sphere, counter clockwise seen from outside
+static void makeSphere(unsigned int segments, std::vector<float>& positions, std::vector<unsigned int>& indices)
+{
+	for (unsigned int ring = 0; ring <= segments; ring++)
+	{
+		float theta = 3.14159265f * ring / segments;
+		for (unsigned int segment = 0; segment <= segments; segment++)
+		{
+			float phi = 2.0f * 3.14159265f * segment / segments;
+			positions.push_back(std::sin(theta) * std::cos(phi));
+			positions.push_back(std::cos(theta));
+			positions.push_back(std::sin(theta) * std::sin(phi));
+		}
+	}
+	for (unsigned int ring = 0; ring < segments; ring++)
+	{
+		for (unsigned int segment = 0; segment < segments; segment++)
+		{
+			unsigned int i = ring * (segments + 1) + segment;
+			unsigned int j = i + segments + 1;
+			unsigned int quad[6] = { i, i + 1, j, i + 1, j + 1, j };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+}
+
+void benchmarkMeshOptimizer(unsigned int segments)
+{
+	// bumps give the sphere overhangs, so it hides parts of itself and draw order matters
+	std::vector<float> positions;
+	std::vector<unsigned int> triangles;
+	makeSphere(segments, positions, triangles);
+	for (std::size_t v = 0; v < positions.size(); v += 3)
+	{
+		float* p = &positions[v];
+		float bump = 1.0f + 0.4f * std::sin(6.0f * p[0]) * std::sin(6.0f * p[1]) * std::sin(6.0f * p[2]);
+		for (int axis = 0; axis < 3; axis++)
+			p[axis] *= bump;
+	}
+
+	// shuffle whole triangles, fixed seed so runs compare
+	std::vector<unsigned int> order(triangles.size() / 3);
+	for (std::size_t t = 0; t < order.size(); t++)
+		order[t] = (unsigned int)t;
+	std::shuffle(order.begin(), order.end(), std::mt19937(1234));
+
+	std::vector<unsigned int> indices(triangles.size());
+	for (std::size_t t = 0; t < order.size(); t++)
+	{
+		for (int k = 0; k < 3; k++)
+			indices[t * 3 + k] = triangles[order[t] * 3 + k];
+	}
+
+	std::size_t vertexCount = positions.size() / 3;
+	std::cout << "BENCHMARK::MESH_OPTIMIZER triangles=" << indices.size() / 3 << " vertices=" << vertexCount << std::endl;
+	printCacheStats("SHUFFLED", indices, vertexCount, 0.0, &positions);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertexCount);
+	printCacheStats("VERTEX_CACHE", indices, vertexCount, secondsSince(start), &positions);
+
+	start = std::chrono::steady_clock::now();
+	optimizeOverdraw(indices.data(), indices.data(), indices.size(), positions.data(), vertexCount, 3 * sizeof(float));
+	printCacheStats("OVERDRAW", indices, vertexCount, secondsSince(start), &positions);
+
+	std::vector<float> fetchOrdered(positions.size());
+	start = std::chrono::steady_clock::now();
+	std::size_t written = optimizeVertexFetch(fetchOrdered.data(), indices.data(), indices.size(), positions.data(), vertexCount, 3 * sizeof(float));
+	printCacheStats("VERTEX_FETCH", indices, written, secondsSince(start));
+}
+
+void benchmarkWelder(unsigned int gridSize)
+{
+	std::vector<float> soup;
+	soup.reserve((std::size_t)gridSize * gridSize * 6 * 6);
+	for (unsigned int y = 0; y < gridSize; y++)
+	{
+		for (unsigned int x = 0; x < gridSize; x++)
+		{
+			unsigned int corners[6][2] = { { x, y }, { x + 1, y }, { x, y + 1 }, { x + 1, y }, { x + 1, y + 1 }, { x, y + 1 } };
+			for (int c = 0; c < 6; c++)
+			{
+				float vertex[6] = { (float)corners[c][0] / gridSize, (float)corners[c][1] / gridSize, 0.0f, 0.0f, 0.0f, 1.0f };
+				soup.insert(soup.end(), vertex, vertex + 6);
+			}
+		}
+	}
+
+	std::size_t vertexCount = soup.size() / 6;
+	unsigned int cores = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	unsigned int threadCounts[2] = { 1, cores };
+	for (unsigned int threads : threadCounts)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		WeldedMesh mesh = weldVertices(soup.data(), vertexCount, 6 * sizeof(float), 0.0f, threads);
+		double seconds = secondsSince(start);
+
+		std::cout << "BENCHMARK::WELD threads=" << threads
+			<< " triangles=" << vertexCount / 3
+			<< " vertices=" << vertexCount << "->" << mesh.vertexCount
+			<< " index_bits=" << (mesh.fitsIndex16() ? 16 : 32)
+			<< " ms=" << seconds * 1e3 << std::endl;
+	}
+}
+
+void benchmarkMeshletCulling(unsigned int segments)
+{
+	std::vector<float> positions;
+	std::vector<unsigned int> indices;
+	makeSphere(segments, positions, indices);
+	std::size_t vertexCount = positions.size() / 3;
+	optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertexCount);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	MeshletMesh mesh = buildMeshlets(indices.data(), indices.size(), positions.data(), vertexCount, 3 * sizeof(float));
+	double buildSeconds = secondsSince(start);
+
+	// camera at z = 1.6 looking down -z, 45 degree fov: the back half faces away and the rim is off screen
+	CullCamera camera = { { 0.0f, 0.0f, 1.6f }, {} };
+	float f = 1.0f / std::tan(0.5f * 45.0f * 3.14159265f / 180.0f);
+	float nearPlane = 0.1f, farPlane = 100.0f;
+	float viewProjection[16] =
+	{
+		f, 0.0f, 0.0f, 0.0f,
+		0.0f, f, 0.0f, 0.0f,
+		0.0f, 0.0f, (farPlane + nearPlane) / (nearPlane - farPlane), -1.0f,
+		0.0f, 0.0f, 2.0f * farPlane * nearPlane / (nearPlane - farPlane), 0.0f
+	};
+	// view is a translation by -camera.z, so only the last column changes
+	for (int row = 0; row < 4; row++)
+		viewProjection[12 + row] += viewProjection[8 + row] * -camera.position[2];
+	extractFrustumPlanes(viewProjection, camera.planes);
+
+	std::vector<unsigned int> visible(mesh.meshlets.size());
+	const int iterations = 100;
+	std::size_t visibleCount = 0;
+	double seconds[2];
+	for (int simd = 0; simd < 2; simd++)
+	{
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			visibleCount = simd ? cullMeshlets(mesh, camera, visible.data()) : cullMeshletsScalar(mesh, camera, visible.data());
+		seconds[simd] = secondsSince(start) / iterations;
+	}
+
+	std::vector<unsigned int> visibleIndices;
+	buildVisibleIndices(mesh, visible.data(), visibleCount, visibleIndices);
+
+	std::cout << "BENCHMARK::MESHLETS triangles=" << indices.size() / 3
+		<< " meshlets=" << mesh.meshlets.size()
+		<< " build_ms=" << buildSeconds * 1e3
+		<< " visible_meshlets=" << visibleCount
+		<< " submitted_triangles=" << visibleIndices.size() / 3
+		<< " cull_scalar_us=" << seconds[0] * 1e6
+		<< " cull_simd_us=" << seconds[1] * 1e6 << std::endl;
+}
+
+void benchmarkLodChain(unsigned int segments)
+{
+	std::vector<float> positions;
+	std::vector<unsigned int> indices;
+	makeSphere(segments, positions, indices);
+	std::size_t vertexCount = positions.size() / 3;
+
+	// one page holds the sphere and every level, as the halving levels add up to less than it
+	typedef VertexFormat<attrib::Float<3>> PositionFormat;
+	BufferArena arena(PositionFormat::layout(), (unsigned int)vertexCount, (unsigned int)indices.size() * 2);
+	MeshAllocation base = arena.allocate(positions.data(), (unsigned int)vertexCount, indices.data(), (unsigned int)indices.size());
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	LodChain chain = buildLodChain(arena, base, indices.data(), indices.size(), positions.data(), vertexCount,
+		3 * sizeof(float), 8);
+	double seconds = secondsSince(start);
+	glCheckError();
+
+	std::vector<std::size_t> triangles;
+	for (std::size_t level = 0; level < chain.levels.size(); level++)
+	{
+		triangles.push_back((std::size_t)chain.levels[level].mesh.indexCount / 3);
+		std::cout << "BENCHMARK::LOD level=" << level << " triangles=" << triangles.back()
+			<< " error=" << chain.levels[level].error << std::endl;
+	}
+	std::cout << "BENCHMARK::LOD_CHAIN levels=" << chain.levels.size() << " ms=" << seconds * 1e3 << std::endl;
+
+	// dense scene: 1000 copies spread from 1.5 to 50 units away, the camera dollying back and
+	// forth a little every frame. Each object keeps last frame's level, as a renderer would
+	const int frames = 120;
+	LodSettings settings;
+	float budgets[3] = { 0.5f, 1.0f, 4.0f };
+	float hystereses[2] = { 0.0f, settings.hysteresis };
+	for (float budget : budgets)
+	{
+		for (float hysteresis : hystereses)
+		{
+			settings.pixelError = budget;
+			settings.hysteresis = hysteresis;
+			std::vector<int> levels(1000, -1);
+			std::size_t full = 0, selected = 0, switches = 0;
+			for (int frame = 0; frame < frames; frame++)
+			{
+				float dolly = 1.0f + 0.05f * std::sin(frame * 0.3f);
+				for (std::size_t object = 0; object < levels.size(); object++)
+				{
+					float distance = (1.5f + 48.5f * object / 999.0f) * dolly;
+					int level = selectLod(chain, distance, levels[object], settings);
+					if (levels[object] >= 0 && level != levels[object])
+						switches++;
+					levels[object] = level;
+					full += triangles[0];
+					selected += triangles[level];
+				}
+			}
+			std::cout << "BENCHMARK::LOD_SELECTION pixel_error=" << budget
+				<< " hysteresis=" << hysteresis
+				<< " triangles=" << selected / frames << "/" << full / frames
+				<< " (" << 100.0 * selected / full << "%)"
+				<< " switches_per_frame=" << (double)switches / frames << std::endl;
+		}
+	}
+
+	freeLodChain(arena, chain);
+	arena.free(base);
+}
+
+void benchmarkStripDraws(ContextProvider& context, Shader& shader, unsigned int gridSize, int frameCount)
+{
+	unsigned int side = gridSize + 1;
+	std::vector<float> positions;
+	for (unsigned int y = 0; y < side; y++)
+	{
+		for (unsigned int x = 0; x < side; x++)
+		{
+			positions.push_back(-1.0f + 2.0f * x / gridSize);
+			positions.push_back(-1.0f + 2.0f * y / gridSize);
+			positions.push_back(0.0f);
+		}
+	}
+	std::vector<unsigned int> list;
+	for (unsigned int y = 0; y < gridSize; y++)
+	{
+		for (unsigned int x = 0; x < gridSize; x++)
+		{
+			unsigned int i = y * side + x;
+			unsigned int cell[6] = { i, i + 1, i + side, i + 1, i + side + 1, i + side };
+			list.insert(list.end(), cell, cell + 6);
+		}
+	}
+	std::size_t vertexCount = positions.size() / 3;
+	optimizeVertexCache(list.data(), list.data(), list.size(), vertexCount);
+
+	// what chooseIndexEncoding() keeps is drawn as is, the other encoding is built to compare against
+	IndexEncoding chosen = chooseIndexEncoding(list.data(), list.size(), vertexCount);
+	bool choseStrip = chosen.mode == GL_TRIANGLE_STRIP;
+	std::vector<unsigned int> other;
+	if (choseStrip)
+	{
+		other = list;
+	}
+	else
+	{
+		other.resize(stripifyBound(list.size()));
+		other.resize(stripify(other.data(), list.data(), list.size()));
+	}
+
+	// one VBO, one VAO + EBO per encoding
+	typedef VertexFormat<attrib::Float<3>> PositionFormat;
+	unsigned int VAOs[2], EBOs[2];
+	const std::vector<unsigned int>* encodings[2] = { choseStrip ? &other : &chosen.indices, choseStrip ? &chosen.indices : &other };
+	unsigned int VBO = createBuffer(positions.size() * sizeof(float), positions.data());
+	for (int e = 0; e < 2; e++)
+	{
+		EBOs[e] = createBuffer(encodings[e]->size() * sizeof(unsigned int), encodings[e]->data());
+		VAOs[e] = createVertexArray(PositionFormat::layout(), VBO, EBOs[e]);
+	}
+
+	shader.useShader();
+	const char* names[2] = { "LIST", "STRIP" };
+	GLenum modes[2] = { GL_TRIANGLES, GL_TRIANGLE_STRIP };
+	double msPerDraw[2];
+	for (int e = 0; e < 2; e++)
+	{
+		bindVertexArray(VAOs[e]);
+		if (modes[e] == GL_TRIANGLE_STRIP)
+			enablePrimitiveRestart(GL_UNSIGNED_INT);
+
+		double seconds = 0.0;
+		for (int frame = -1; frame < frameCount; frame++)
+		{
+			glClear(GL_COLOR_BUFFER_BIT);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			glDrawElements(modes[e], (GLsizei)encodings[e]->size(), GL_UNSIGNED_INT, (void*)0);
+			glFinish();
+			if (frame >= 0)
+				seconds += secondsSince(start);
+
+			context.swapBuffers();
+			context.pollEvents();
+		}
+		disablePrimitiveRestart();
+
+		msPerDraw[e] = seconds * 1e3 / frameCount;
+		std::cout << "BENCHMARK::STRIPS::" << names[e]
+			<< " triangles=" << list.size() / 3
+			<< " index_bytes=" << encodings[e]->size() * sizeof(unsigned int)
+			<< " ms_per_draw=" << msPerDraw[e] << std::endl;
+	}
+	// the choice only sees sizes and ACMR, this is how it did on this driver
+	int faster = msPerDraw[1] < msPerDraw[0] ? 1 : 0;
+	std::cout << "BENCHMARK::STRIPS chosen=" << names[choseStrip ? 1 : 0]
+		<< " faster=" << names[faster]
+		<< " agrees=" << (faster == (choseStrip ? 1 : 0) ? 1 : 0)
+		<< " acmr=" << chosen.acmr
+		<< " strip_to_list_ms=" << msPerDraw[1] / msPerDraw[0] << std::endl;
+
+	for (int e = 0; e < 2; e++)
+	{
+		deleteVertexArray(VAOs[e]);
+		deleteBuffer(EBOs[e]);
+	}
+	deleteBuffer(VBO);
+}
+
+void benchmarkSoftwareRasterizer(unsigned int triangleCount)
+{
+	const int width = 1920, height = 1080;
+	const int frameCount = 10;
+
+	// triangles up to about 40 pixels across, anywhere on the target, position + color
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<float> vertices((std::size_t)triangleCount * 3 * 5);
+	std::vector<unsigned int> indices((std::size_t)triangleCount * 3);
+	for (unsigned int t = 0; t < triangleCount; t++)
+	{
+		float x = unit(random) * 2.0f - 1.0f, y = unit(random) * 2.0f - 1.0f;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			float* vertex = &vertices[((std::size_t)t * 3 + corner) * 5];
+			vertex[0] = x + (unit(random) - 0.5f) * 40.0f / width;
+			vertex[1] = y + (unit(random) - 0.5f) * 40.0f / height;
+			vertex[2] = unit(random);
+			vertex[3] = unit(random);
+			vertex[4] = unit(random);
+			indices[t * 3 + corner] = t * 3 + corner;
+		}
+	}
+
+	RasterPipeline pipeline;
+	pipeline.varyingCount = 3;
+	pipeline.vertex = [&vertices](unsigned int index, RasterVertex& out)
+	{
+		const float* vertex = &vertices[(std::size_t)index * 5];
+		out.position[0] = vertex[0];
+		out.position[1] = vertex[1];
+		out.position[2] = 0.0f;
+		out.position[3] = 1.0f;
+		out.varyings[0] = vertex[2];
+		out.varyings[1] = vertex[3];
+		out.varyings[2] = vertex[4];
+	};
+	pipeline.fragment = [](const FragmentLanes& in, FragmentColor& out)
+	{
+		out.r = in.varyings[0];
+		out.g = in.varyings[1];
+		out.b = in.varyings[2];
+		out.a = Float8(1.0f);
+	};
+
+	unsigned int cores = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	std::vector<unsigned int> threadCounts;
+	for (unsigned int threads = 1; threads < cores; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(cores);
+
+	std::vector<unsigned char> reference, image((std::size_t)width * height * 4);
+	double singleThreadMs = 0.0;
+	for (unsigned int threads : threadCounts)
+	{
+		SoftwareRasterizer raster(threads);
+		raster.resize(width, height);
+		// one warm up frame, the bins and setups grow to size in it
+		for (int frame = -1; frame < frameCount; frame++)
+		{
+			if (frame == 0)
+				raster.resetStats();
+			raster.clear(0.0f, 0.0f, 0.0f, 1.0f);
+			raster.draw(pipeline, indices.data(), (unsigned int)indices.size());
+			raster.finish();
+		}
+
+		raster.readPixels(image.data());
+		if (reference.empty())
+			reference = image;
+
+		RasterStats stats = raster.getStats();
+		double totalMs = (stats.vertexMs + stats.binningMs + stats.rasterMs) / frameCount;
+		if (threads == 1)
+			singleThreadMs = totalMs;
+		std::cout << "BENCHMARK::SOFTWARE_RASTER simd=" << simdLanesName()
+			<< " threads=" << threads
+			<< " triangles=" << triangleCount
+			<< " vertex_ms=" << stats.vertexMs / frameCount
+			<< " binning_ms=" << stats.binningMs / frameCount
+			<< " raster_ms=" << stats.rasterMs / frameCount
+			<< " total_ms=" << totalMs
+			<< " speedup=" << singleThreadMs / totalMs
+			<< " steals_per_frame=" << (double)stats.steals / frameCount
+			<< " identical=" << (image == reference ? 1 : 0) << std::endl;
+	}
+}
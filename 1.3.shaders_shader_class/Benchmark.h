@@ -0,0 +1,62 @@
+#pragma once
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "Context.h"
+#include "Shader.h"
+
+// Draw call benchmark
+// -------------------
+/// \note: measures the CPU side cost of submitting drawCount draws per frame, each with
+///		   a uniform update, so a no-error context can be compared against a validating one:
+///		   run with --bench-draws --no-error and --bench-draws --validate.
+///		   The glFinish wait at the end of each frame is timed separately.
+void benchmarkDrawCalls(ContextProvider& context, Shader& shader, unsigned int VAO, int drawCount, int frameCount);
+
+// Mesh optimizer benchmark
+// ------------------------
+/// \note: CPU only, no context needed. Builds a bumpy UV sphere with about 2 * segments^2
+///		   triangles, shuffled (the worst case for the vertex cache, like a mesh exported
+///		   without any ordering), then reports ACMR / ATVR and timings for every pass, and
+///		   for the passes that reorder triangles the overdraw from 6 axis views
+///		   (analyzeOverdraw). The bumps matter, a convex mesh never overdraws itself.
+void benchmarkMeshOptimizer(unsigned int segments);
+
+// Vertex welding benchmark
+// ------------------------
+/// \note: CPU only. Welds the triangle soup of a gridSize x gridSize grid
+///		   (position + normal floats, 6 vertices per cell) with 1 thread and with all cores.
+void benchmarkWelder(unsigned int gridSize);
+
+// Meshlet culling benchmark
+// -------------------------
+/// \note: CPU only. Builds meshlets for a UV sphere with about 2 * segments^2 triangles and
+///		   culls them from a camera close enough that part of the sphere is off screen,
+///		   SSE against the scalar loop, and reports how many triangles would be submitted.
+void benchmarkMeshletCulling(unsigned int segments);
+
+// LOD benchmark
+// -------------
+/// \note: needs a context, the levels are uploaded. Builds a LOD chain for a UV sphere with
+///		   buildLodChain, then runs the per frame selector over 1000 spheres at increasing
+///		   distance for a few frames of a dollying camera, for a few pixel error budgets with
+///		   and without hysteresis. Reports how many triangles would be drawn and how often
+///		   objects switch level.
+void benchmarkLodChain(unsigned int segments);
+
+// Strip vs list draw benchmark
+// ----------------------------
+/// \note: needs a context. Draws a cache optimized gridSize x gridSize grid as an indexed
+///		   triangle list and as restart separated strips, frameCount times each with a
+///		   glFinish per frame, so on llvmpipe the time includes the vertex work. The encoding
+///		   chooseIndexEncoding() keeps is the one drawn, the other is built to compare; the
+///		   summary prints the choice next to the one measured faster.
+void benchmarkStripDraws(ContextProvider& context, Shader& shader, unsigned int gridSize, int frameCount);
+
+// Software rasterizer benchmark
+// -----------------------------
+/// \note: CPU only. Draws triangleCount small vertex colored triangles scattered over a
+///		   1920x1080 target with 1, 2, 4, ... threads up to every core, and reports the time
+///		   of each phase (vertex, binning, raster), the speedup over one thread, the steals
+///		   and whether the image came out the same as with one thread.
+void benchmarkSoftwareRasterizer(unsigned int triangleCount);
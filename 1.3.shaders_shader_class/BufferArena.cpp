@@ -0,0 +1,268 @@
+#include "BufferArena.h"
+#include "GLResources.h"
+
+#include <iostream>
+#include <iterator>
+
+// Offset allocator
+// ----------------
+OffsetAllocator::OffsetAllocator(unsigned int capacity)
+	: capacity(capacity), used(0)
+{
+	if (capacity > 0)
+		freeBlocks[0] = capacity;
+}
+
+unsigned int OffsetAllocator::allocate(unsigned int size)
+{
+	// nothing to place, any offset will do
+	if (size == 0)
+		return 0;
+
+	for (std::map<unsigned int, unsigned int>::iterator it = freeBlocks.begin(); it != freeBlocks.end(); ++it)
+	{
+		if (it->second < size)
+			continue;
+
+		unsigned int offset = it->first;
+		unsigned int remaining = it->second - size;
+		freeBlocks.erase(it);
+		if (remaining > 0)
+			freeBlocks[offset + size] = remaining;
+
+		used += size;
+		return offset;
+	}
+	return INVALID;
+}
+
+void OffsetAllocator::free(unsigned int offset, unsigned int size)
+{
+	if (size == 0)
+		return;
+	used -= size;
+
+	std::map<unsigned int, unsigned int>::iterator next = freeBlocks.lower_bound(offset);
+
+	// merge with the block right after
+	if (next != freeBlocks.end() && offset + size == next->first)
+	{
+		size += next->second;
+		next = freeBlocks.erase(next);
+	}
+
+	// merge with the block right before
+	if (next != freeBlocks.begin())
+	{
+		std::map<unsigned int, unsigned int>::iterator prev = std::prev(next);
+		if (prev->first + prev->second == offset)
+		{
+			prev->second += size;
+			return;
+		}
+	}
+	freeBlocks[offset] = size;
+}
+
+AllocatorStats OffsetAllocator::getStats() const
+{
+	AllocatorStats stats;
+	stats.capacity = capacity;
+	stats.used = used;
+	stats.freeBlocks = (unsigned int)freeBlocks.size();
+	for (const std::pair<const unsigned int, unsigned int>& block : freeBlocks)
+	{
+		if (block.second > stats.largestFreeBlock)
+			stats.largestFreeBlock = block.second;
+	}
+
+	unsigned int freeTotal = capacity - used;
+	stats.fragmentation = freeTotal > 0 ? 1.0f - (float)stats.largestFreeBlock / freeTotal : 0.0f;
+	return stats;
+}
+
+// Buffer arena
+// ------------
+BufferArena::BufferArena(const VertexLayout& layout, unsigned int pageVertexCount, unsigned int pageIndexCount,
+	VertexArrayCache* vertexArrays)
+	: layout(layout), vertexSize(layout.stride), pageVertexCount(pageVertexCount), pageIndexCount(pageIndexCount),
+	  meshCount(0), vertexArrays(vertexArrays)
+{
+}
+
+BufferArena::~BufferArena()
+{
+	for (Page& page : pages)
+	{
+		if (vertexArrays)
+		{
+			vertexArrays->detach(page.VBO);
+			vertexArrays->detach(page.EBO);
+		}
+		else
+			deleteVertexArray(page.VAO);
+		deleteBuffer(page.VBO);
+		deleteBuffer(page.EBO);
+	}
+}
+
+int BufferArena::createPage(unsigned int vertexCount, unsigned int indexCount)
+{
+	Page page{ 0, 0, 0, OffsetAllocator(vertexCount), OffsetAllocator(indexCount) };
+
+	// pages are filled piecewise, so their storage has to stay updatable
+	page.VBO = createBuffer((GLsizeiptr)vertexCount * vertexSize, NULL, true);
+	page.EBO = createBuffer((GLsizeiptr)indexCount * sizeof(unsigned int), NULL, true);
+	if (!vertexArrays)
+		page.VAO = createVertexArray(layout, page.VBO, page.EBO);
+
+	pages.push_back(page);
+	return (int)pages.size() - 1;
+}
+
+MeshAllocation BufferArena::allocate(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+	MeshAllocation mesh;
+	unsigned int vertexOffset = OffsetAllocator::INVALID;
+	unsigned int indexOffset = OffsetAllocator::INVALID;
+
+	for (int i = 0; i < (int)pages.size() && !mesh.isValid(); i++)
+	{
+		vertexOffset = pages[i].vertices.allocate(vertexCount);
+		if (vertexOffset == OffsetAllocator::INVALID)
+			continue;
+
+		indexOffset = pages[i].indices.allocate(indexCount);
+		if (indexOffset == OffsetAllocator::INVALID)
+		{
+			pages[i].vertices.free(vertexOffset, vertexCount);
+			continue;
+		}
+		mesh.page = i;
+	}
+
+	if (!mesh.isValid())
+	{
+		// meshes bigger than a page get a page of their own
+		unsigned int vertexCapacity = vertexCount > pageVertexCount ? vertexCount : pageVertexCount;
+		unsigned int indexCapacity = indexCount > pageIndexCount ? indexCount : pageIndexCount;
+		mesh.page = createPage(vertexCapacity, indexCapacity);
+		vertexOffset = pages[mesh.page].vertices.allocate(vertexCount);
+		indexOffset = pages[mesh.page].indices.allocate(indexCount);
+	}
+
+	mesh.baseVertex = (GLint)vertexOffset;
+	mesh.firstIndex = indexOffset;
+	mesh.vertexCount = (GLsizei)vertexCount;
+	mesh.indexCount = (GLsizei)indexCount;
+
+	const Page& page = pages[mesh.page];
+	if (vertexCount > 0)
+		updateBuffer(page.VBO, (GLintptr)vertexOffset * vertexSize, (GLsizeiptr)vertexCount * vertexSize, vertices);
+	if (indexCount > 0)
+		updateBuffer(page.EBO, (GLintptr)indexOffset * sizeof(unsigned int), (GLsizeiptr)indexCount * sizeof(unsigned int), indices);
+
+	meshCount++;
+	return mesh;
+}
+
+MeshAllocation BufferArena::allocateIndices(const MeshAllocation& base, const unsigned int* indices, unsigned int indexCount)
+{
+	MeshAllocation mesh;
+	if (!base.isValid())
+		return mesh;
+
+	unsigned int indexOffset = pages[base.page].indices.allocate(indexCount);
+	if (indexOffset == OffsetAllocator::INVALID)
+		return mesh;
+
+	mesh.page = base.page;
+	mesh.baseVertex = base.baseVertex;
+	mesh.firstIndex = indexOffset;
+	mesh.vertexCount = 0;
+	mesh.indexCount = (GLsizei)indexCount;
+
+	if (indexCount > 0)
+		updateBuffer(pages[mesh.page].EBO, (GLintptr)indexOffset * sizeof(unsigned int), (GLsizeiptr)indexCount * sizeof(unsigned int), indices);
+
+	meshCount++;
+	return mesh;
+}
+
+void BufferArena::free(MeshAllocation& mesh)
+{
+	if (!mesh.isValid())
+		return;
+
+	pages[mesh.page].vertices.free((unsigned int)mesh.baseVertex, (unsigned int)mesh.vertexCount);
+	pages[mesh.page].indices.free(mesh.firstIndex, (unsigned int)mesh.indexCount);
+	meshCount--;
+	mesh = MeshAllocation();
+}
+
+void BufferArena::bind(const MeshAllocation& mesh)
+{
+	const Page& page = pages[mesh.page];
+	if (vertexArrays)
+		vertexArrays->bind(layout, page.VBO, page.EBO);
+	else
+		bindVertexArray(page.VAO);
+}
+
+void BufferArena::draw(const MeshAllocation& mesh, GLenum mode)
+{
+	bind(mesh);
+	if (mesh.indexCount == 0)
+	{
+		glDrawArrays(mode, mesh.baseVertex, mesh.vertexCount);
+		return;
+	}
+	glDrawElementsBaseVertex(mode, mesh.indexCount, GL_UNSIGNED_INT,
+		(void*)((GLintptr)mesh.firstIndex * sizeof(unsigned int)), mesh.baseVertex);
+}
+
+static void accumulate(AllocatorStats& total, const AllocatorStats& page)
+{
+	total.capacity += page.capacity;
+	total.used += page.used;
+	total.freeBlocks += page.freeBlocks;
+	if (page.largestFreeBlock > total.largestFreeBlock)
+		total.largestFreeBlock = page.largestFreeBlock;
+}
+
+ArenaStats BufferArena::getStats() const
+{
+	ArenaStats stats;
+	stats.pages = (unsigned int)pages.size();
+	stats.meshes = meshCount;
+
+	// fragmentation is averaged over pages, weighted by their free space
+	float vertexFragmentation = 0.0f, indexFragmentation = 0.0f;
+	for (const Page& page : pages)
+	{
+		AllocatorStats vertices = page.vertices.getStats();
+		AllocatorStats indices = page.indices.getStats();
+		accumulate(stats.vertices, vertices);
+		accumulate(stats.indices, indices);
+		vertexFragmentation += vertices.fragmentation * (vertices.capacity - vertices.used);
+		indexFragmentation += indices.fragmentation * (indices.capacity - indices.used);
+	}
+
+	unsigned int freeVertices = stats.vertices.capacity - stats.vertices.used;
+	unsigned int freeIndices = stats.indices.capacity - stats.indices.used;
+	stats.vertices.fragmentation = freeVertices > 0 ? vertexFragmentation / freeVertices : 0.0f;
+	stats.indices.fragmentation = freeIndices > 0 ? indexFragmentation / freeIndices : 0.0f;
+	return stats;
+}
+
+void BufferArena::printStats() const
+{
+	ArenaStats stats = getStats();
+	std::cout << "ARENA:: pages=" << stats.pages << " meshes=" << stats.meshes
+		<< " | vertices " << stats.vertices.used << "/" << stats.vertices.capacity
+		<< " free_blocks=" << stats.vertices.freeBlocks
+		<< " fragmentation=" << stats.vertices.fragmentation
+		<< " | indices " << stats.indices.used << "/" << stats.indices.capacity
+		<< " free_blocks=" << stats.indices.freeBlocks
+		<< " fragmentation=" << stats.indices.fragmentation << std::endl;
+}
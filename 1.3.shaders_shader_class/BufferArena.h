@@ -0,0 +1,114 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <glad/glad.h>
+
+#include "VertexFormat.h"
+
+// Offset allocator
+// ----------------
+/// \note: first fit free list over an abstract range (vertices or indices here), free
+///		   blocks are kept sorted by offset so neighbours merge back together on free.
+struct AllocatorStats
+{
+	unsigned int capacity{ 0 };
+	unsigned int used{ 0 };
+	unsigned int freeBlocks{ 0 };
+	unsigned int largestFreeBlock{ 0 };
+	// 0 when all free space is one block, approaching 1 as it splinters
+	float fragmentation{ 0.0f };
+};
+
+class OffsetAllocator
+{
+	unsigned int capacity;
+	unsigned int used;
+	std::map<unsigned int, unsigned int> freeBlocks;	// offset -> size
+
+public:
+	static const unsigned int INVALID = 0xFFFFFFFF;
+
+	OffsetAllocator(unsigned int capacity);
+
+	// returns INVALID when no single free block is big enough. size 0 always fits, at 0
+	unsigned int allocate(unsigned int size);
+	void free(unsigned int offset, unsigned int size);
+
+	AllocatorStats getStats() const;
+};
+
+// Buffer arena
+// ------------
+/// \note: packs many small meshes into a few large VBO/EBO pairs instead of one VAO + VBO
+///		   per mesh. Every page has one VAO, meshes are drawn with glDrawElementsBaseVertex
+///		   so their indices stay relative to their own first vertex, and draws from the same
+///		   page don't rebind anything. Given a VertexArrayCache the pages get no VAO of their
+///		   own: on 4.3+ they all share the cache's format VAO and switching pages only swaps
+///		   the attached buffers. A mesh without indices is drawn as listed, with
+///		   glDrawArrays from its first vertex.
+struct MeshAllocation
+{
+	int page{ -1 };
+	GLint baseVertex{ 0 };
+	GLuint firstIndex{ 0 };
+	GLsizei vertexCount{ 0 };
+	GLsizei indexCount{ 0 };
+
+	bool isValid() const { return page >= 0; }
+};
+
+struct ArenaStats
+{
+	unsigned int pages{ 0 };
+	unsigned int meshes{ 0 };
+	AllocatorStats vertices;
+	AllocatorStats indices;
+};
+
+class BufferArena
+{
+	struct Page
+	{
+		unsigned int VAO, VBO, EBO;
+		OffsetAllocator vertices;
+		OffsetAllocator indices;
+	};
+
+	std::vector<Page> pages;
+	VertexLayout layout;
+	GLsizei vertexSize;
+	unsigned int pageVertexCount;
+	unsigned int pageIndexCount;
+	unsigned int meshCount;
+	VertexArrayCache* vertexArrays;
+
+public:
+	// vertexArrays (may be NULL) must outlive the arena
+	BufferArena(const VertexLayout& layout,
+		unsigned int pageVertexCount = 1 << 16, unsigned int pageIndexCount = 3 << 16,
+		VertexArrayCache* vertexArrays = NULL);
+	~BufferArena();
+
+	BufferArena(const BufferArena&) = delete;
+	BufferArena& operator=(const BufferArena&) = delete;
+
+	MeshAllocation allocate(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+	// another index buffer over base's vertices (e.g. a LOD), in the same page. it owns only its
+	// indices (vertexCount 0) so free() on it leaves the vertices alone. invalid if the page is full
+	MeshAllocation allocateIndices(const MeshAllocation& base, const unsigned int* indices, unsigned int indexCount);
+	void free(MeshAllocation& mesh);
+
+	// binds the page VAO (or the cache's) through the bind cache, so draws from the same page
+	// don't rebind
+	void bind(const MeshAllocation& mesh);
+	void draw(const MeshAllocation& mesh, GLenum mode = GL_TRIANGLES);
+
+	// 0 when the pages go through a VertexArrayCache
+	unsigned int getVAO(int page) const { return pages[page].VAO; }
+	unsigned int getEBO(int page) const { return pages[page].EBO; }
+	ArenaStats getStats() const;
+	void printStats() const;
+
+private:
+	int createPage(unsigned int vertexCount, unsigned int indexCount);
+};
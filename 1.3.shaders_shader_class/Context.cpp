@@ -0,0 +1,151 @@
+#include "Context.h"
+#include "GLExtensions.h"
+#include "HeadlessContext.h"
+#include "NullContext.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+ContextOptions parseContextOptions(int argc, char* argv[], ContextOptions options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--no-error") == 0)
+			options.noError = true;
+		else if (std::strcmp(argv[i], "--validate") == 0)
+			options.noError = false;
+		else if (std::strcmp(argv[i], "--headless") == 0)
+			options.headless = true;
+		else if (std::strcmp(argv[i], "--null-gl") == 0)
+			options.nullGL = true;
+		else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			options.frames = std::atoi(argv[++i]);
+	}
+	return options;
+}
+
+GLFWwindow* createContextWindow(const ContextOptions& options)
+{
+	// init and configure glfw
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_CONTEXT_NO_ERROR, options.noError ? GLFW_TRUE : GLFW_FALSE);
+
+	// create window
+	GLFWwindow* window = glfwCreateWindow(options.width, options.height, options.title, NULL, NULL);
+	if (window == NULL && options.noError)
+	{
+		// KHR_no_error is optional, fall back to a regular context
+		std::cout << "WARNING::CONTEXT::NO_ERROR_UNSUPPORTED: falling back to a validating context" << std::endl;
+		glfwWindowHint(GLFW_CONTEXT_NO_ERROR, GLFW_FALSE);
+		window = glfwCreateWindow(options.width, options.height, options.title, NULL, NULL);
+	}
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+
+	glfwMakeContextCurrent(window);
+
+	// load glad
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cout << "Failed to load GLAD!" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+
+	std::cout << "Context: OpenGL " << glGetString(GL_VERSION)
+		<< (isNoErrorContext() ? " (no error)" : "") << std::endl;
+	return window;
+}
+
+// Context provider
+// ----------------
+void ContextProvider::readPixels(std::vector<unsigned char>& pixels) const
+{
+	pixels.resize((std::size_t)getWidth() * getHeight() * 4);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, getFramebuffer());
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, getWidth(), getHeight(), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	glCheckError();
+}
+
+WindowContext::WindowContext(GLFWwindow* window)
+	: window(window)
+{
+}
+
+WindowContext::~WindowContext()
+{
+	glfwTerminate();
+}
+
+bool WindowContext::shouldClose() const
+{
+	return glfwWindowShouldClose(window) != 0;
+}
+
+void WindowContext::pollEvents()
+{
+	glfwPollEvents();
+}
+
+void WindowContext::waitEvents(double timeout)
+{
+	glfwWaitEventsTimeout(timeout);
+}
+
+void WindowContext::swapBuffers()
+{
+	glfwSwapBuffers(window);
+}
+
+bool WindowContext::setSwapInterval(int interval)
+{
+	glfwSwapInterval(interval);
+	return true;
+}
+
+bool WindowContext::supportsAdaptiveSync() const
+{
+	return glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+}
+
+double WindowContext::getRefreshRate() const
+{
+	GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+	const GLFWvidmode* mode = monitor != NULL ? glfwGetVideoMode(monitor) : NULL;
+	return mode != NULL && mode->refreshRate > 0 ? mode->refreshRate : 60.0;
+}
+
+int WindowContext::getWidth() const
+{
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	return width;
+}
+
+int WindowContext::getHeight() const
+{
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	return height;
+}
+
+ContextProvider* createContextProvider(const ContextOptions& options)
+{
+	if (options.nullGL)
+		return createNullContext(options);
+	if (options.headless)
+		return createHeadlessContext(options);
+
+	GLFWwindow* window = createContextWindow(options);
+	return window != NULL ? new WindowContext(window) : NULL;
+}
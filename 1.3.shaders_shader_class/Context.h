@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "GLDebug.h"
+
+// Context options
+// ---------------
+/// \note: noError requests GLFW_CONTEXT_NO_ERROR (KHR_no_error). It defaults to on for
+///		   Release builds, where the GL error checks are compiled out as well.
+///		   headless renders width x height into an FBO without a window, for frames frames.
+///		   nullGL is headless without GL at all, see NullContext.h.
+struct ContextOptions
+{
+	int width{ 800 };
+	int height{ 600 };
+	const char* title{ "learn_opengl" };
+	bool noError{ !GL_DEBUG_CHECKS };
+	bool headless{ false };
+	bool nullGL{ false };
+	int frames{ 100 };
+};
+
+// reads --no-error / --validate on top of the build default, and --headless / --null-gl /
+// --frames <n>
+ContextOptions parseContextOptions(int argc, char* argv[], ContextOptions options);
+
+// creates a 3.3 core window + context, makes it current and loads glad.
+// returns NULL (with glfw terminated) on failure
+GLFWwindow* createContextWindow(const ContextOptions& options);
+
+// Context provider
+// ----------------
+/// \note: what the render loop needs from whoever owns the context, so the same scene runs
+///		   in a GLFW window or headless (see HeadlessContext.h). getFramebuffer() is what the
+///		   scene should render into: 0 for the window, an FBO of fixed size when headless.
+///		   Deleting the provider destroys the context, GL objects have to go first.
+class ContextProvider
+{
+public:
+	virtual ~ContextProvider() {}
+
+	virtual bool shouldClose() const = 0;
+	virtual void pollEvents() = 0;
+	// blocks until an event arrives or timeout seconds have passed
+	virtual void waitEvents(double timeout) = 0;
+	virtual void swapBuffers() = 0;
+
+	// returns false when the interval can't be applied (always for headless)
+	virtual bool setSwapInterval(int interval) = 0;
+	virtual bool supportsAdaptiveSync() const = 0;
+	virtual double getRefreshRate() const = 0;
+	// seconds since the context was created
+	virtual double getTime() const = 0;
+
+	virtual int getWidth() const = 0;
+	virtual int getHeight() const = 0;
+	virtual unsigned int getFramebuffer() const { return 0; }
+	// NULL when headless
+	virtual GLFWwindow* getWindow() const { return NULL; }
+
+	// tightly packed RGBA8 rows of the current framebuffer, bottom row first
+	void readPixels(std::vector<unsigned char>& pixels) const;
+};
+
+class WindowContext : public ContextProvider
+{
+	GLFWwindow* window;
+
+public:
+	// takes over a window made by createContextWindow, glfw is terminated on delete
+	WindowContext(GLFWwindow* window);
+	~WindowContext();
+
+	bool shouldClose() const override;
+	void pollEvents() override;
+	void waitEvents(double timeout) override;
+	void swapBuffers() override;
+
+	bool setSwapInterval(int interval) override;
+	bool supportsAdaptiveSync() const override;
+	double getRefreshRate() const override;
+	double getTime() const override { return glfwGetTime(); }
+
+	int getWidth() const override;
+	int getHeight() const override;
+	GLFWwindow* getWindow() const override { return window; }
+};
+
+// a WindowContext, a HeadlessContext with options.headless or a NullContext with
+// options.nullGL. NULL on failure
+ContextProvider* createContextProvider(const ContextOptions& options);
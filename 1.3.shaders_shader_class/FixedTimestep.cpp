@@ -0,0 +1,82 @@
+#include "FixedTimestep.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+TimestepOptions parseTimestepOptions(int argc, char* argv[], TimestepOptions options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--sim-rate") == 0 && i + 1 < argc)
+			options.rate = std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--sim-max-steps") == 0 && i + 1 < argc)
+			options.maxStepsPerFrame = std::atoi(argv[++i]);
+	}
+	if (options.rate <= 0.0)
+	{
+		std::cout << "ERROR::TIMESTEP::INVALID_RATE " << options.rate << ", using 120" << std::endl;
+		options.rate = 120.0;
+	}
+	options.maxStepsPerFrame = std::max(options.maxStepsPerFrame, 1);
+	return options;
+}
+
+FixedTimestep::FixedTimestep(const TimestepOptions& options, double now)
+	: options(options), step(1.0 / options.rate), accumulator(0.0), lastRealTime(now), simulationTime(0.0)
+{
+}
+
+void FixedTimestep::resync(double now)
+{
+	lastRealTime = now;
+	accumulator = 0.0;
+}
+
+int FixedTimestep::advance(double now, const std::function<void(const SimulationStep&)>& update)
+{
+	double elapsed = now - lastRealTime;
+	lastRealTime = now;
+	stats.frames++;
+
+	if (elapsed > options.maxFrameSeconds)
+	{
+		stats.droppedSeconds += elapsed - options.maxFrameSeconds;
+		elapsed = options.maxFrameSeconds;
+	}
+	accumulator += std::max(elapsed, 0.0);
+
+	// a frame of exactly two steps mustn't come out as one, then three, from rounding
+	int steps = (int)(accumulator / step + 1e-6);
+	if (steps > options.maxStepsPerFrame)
+	{
+		// keep less than one step, the rest is lost rather than owed to the next frame
+		stats.droppedSeconds += (steps - options.maxStepsPerFrame) * step;
+		accumulator -= (steps - options.maxStepsPerFrame) * step;
+		steps = options.maxStepsPerFrame;
+	}
+
+	for (int i = 0; i < steps; i++)
+	{
+		accumulator = std::max(accumulator - step, 0.0);
+		simulationTime += step;
+		// what is left in the accumulator after this step hasn't happened yet on the clock
+		SimulationStep current{ stats.steps, step, simulationTime, now - accumulator };
+		stats.steps++;
+		update(current);
+	}
+
+	stats.maxStepsInFrame = std::max(stats.maxStepsInFrame, steps);
+	return steps;
+}
+
+void FixedTimestep::printStats() const
+{
+	std::cout << "SIMULATION::STATS rate=" << options.rate
+		<< " steps=" << stats.steps
+		<< " frames=" << stats.frames
+		<< " steps_per_frame=" << (stats.frames > 0 ? (double)stats.steps / stats.frames : 0.0)
+		<< " max_steps_in_frame=" << stats.maxStepsInFrame
+		<< " dropped_ms=" << stats.droppedSeconds * 1000.0 << std::endl;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <functional>
+
+// Timestep options
+// ----------------
+/// \note: the simulation always advances in steps of 1 / rate seconds, whatever the frame
+///		   rate. maxFrameSeconds and maxStepsPerFrame are the spiral of death guard: after a
+///		   hitch (or while the window is dragged or asleep) the simulation drops the excess
+///		   time and runs slower than real time for a frame, instead of running so many
+///		   catch-up steps that the next frame is even later.
+struct TimestepOptions
+{
+	double rate{ 120.0 };			// steps per second
+	double maxFrameSeconds{ 0.25 };	// real time accepted per frame
+	int maxStepsPerFrame{ 8 };
+};
+
+// reads --sim-rate <hz> and --sim-max-steps <n>
+TimestepOptions parseTimestepOptions(int argc, char* argv[], TimestepOptions options);
+
+// one simulation step: dt is always 1 / rate, time the simulation time at its end and
+// realTime the clock time it corresponds to, for consuming input stamped up to then
+struct SimulationStep
+{
+	unsigned long long index;
+	double dt;
+	double time;
+	double realTime;
+};
+
+struct TimestepStats
+{
+	unsigned long long steps{ 0 };
+	unsigned long long frames{ 0 };
+	int maxStepsInFrame{ 0 };
+	double droppedSeconds{ 0.0 };
+};
+
+// Fixed timestep
+// --------------
+/// \note: the accumulator loop from "Fix Your Timestep!" (Glenn Fiedler). Real time goes into
+///		   the accumulator, whole steps come out, and the remainder is getAlpha(): how far
+///		   the frame is between the last two simulated states. Rendering interpolates
+///		   between them with it, so motion is smooth at any frame rate while the
+///		   simulation stays deterministic (same steps, same dt, same results).
+///
+///		   FixedTimestep simulation(options, context->getTime());
+///		   Interpolated<float> angle(0.0f);
+///		   while (...)
+///		   {
+///			simulation.advance(context->getTime(), [&](const SimulationStep& step)
+///			{
+///				angle.push(angle.current + speed * (float)step.dt);
+///			});
+///			render(angle.get(simulation.getAlpha()));
+///		   }
+class FixedTimestep
+{
+	TimestepOptions options;
+	double step;
+	double accumulator;
+	double lastRealTime;
+	double simulationTime;
+	TimestepStats stats;
+
+public:
+	FixedTimestep(const TimestepOptions& options, double now);
+
+	// runs every step that is due at real time now, returns how many ran
+	int advance(double now, const std::function<void(const SimulationStep&)>& update);
+	// drops whatever accumulated, e.g. after a long idle wait
+	void resync(double now);
+
+	// 0..1, the fraction of a step that is simulated on the clock but not yet stepped
+	double getAlpha() const { return accumulator / step; }
+	double getStep() const { return step; }
+	double getTime() const { return simulationTime; }
+
+	TimestepStats getStats() const { return stats; }
+	void printStats() const;
+};
+
+// Interpolated state
+// ------------------
+// the state after the last two steps, T needs + - and * with a float
+template<typename T>
+struct Interpolated
+{
+	T previous;
+	T current;
+
+	explicit Interpolated(const T& value) : previous(value), current(value) {}
+
+	// the state after a new step
+	void push(const T& value)
+	{
+		previous = current;
+		current = value;
+	}
+
+	T get(double alpha) const
+	{
+		return previous + (current - previous) * (float)alpha;
+	}
+};
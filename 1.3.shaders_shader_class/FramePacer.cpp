@@ -0,0 +1,218 @@
+#include "FramePacer.h"
+#include "GLDebug.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+PacingOptions parsePacingOptions(int argc, char* argv[], PacingOptions options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--vsync") == 0 && i + 1 < argc)
+		{
+			const char* mode = argv[++i];
+			if (std::strcmp(mode, "off") == 0)
+				options.swapMode = SwapMode::Immediate;
+			else if (std::strcmp(mode, "adaptive") == 0)
+				options.swapMode = SwapMode::Adaptive;
+			else
+				options.swapMode = SwapMode::VSync;
+		}
+		else if (std::strcmp(argv[i], "--fps-limit") == 0 && i + 1 < argc)
+			options.fpsLimit = std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--frames-in-flight") == 0 && i + 1 < argc)
+			options.maxFramesInFlight = std::atoi(argv[++i]);
+	}
+	return options;
+}
+
+// how early the limiter stops sleeping, it never goes below / above these
+static const std::chrono::microseconds MIN_SPIN_MARGIN(200);
+static const std::chrono::microseconds MAX_SPIN_MARGIN(4000);
+
+static double toMs(std::chrono::steady_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+FramePacer::FramePacer(ContextProvider& context, const PacingOptions& options)
+	: context(context), options(options), period(0), spinMargin(std::chrono::milliseconds(1)), refreshMs(0.0),
+	  sleepMs(0.0), spinMs(0.0), fenceWaitMs(0.0), latencySumMs(0.0), maxLatencyMs(0.0), latencySamples(0), frames(0)
+{
+	refreshMs = 1000.0 / context.getRefreshRate();
+
+	setSwapMode(options.swapMode);
+	setFpsLimit(options.fpsLimit);
+	setMaxFramesInFlight(options.maxFramesInFlight);
+	deadline = std::chrono::steady_clock::now();
+	input = deadline;
+}
+
+FramePacer::~FramePacer()
+{
+	for (const FrameFence& fence : fences)
+	{
+		glDeleteSync(fence.sync);
+	}
+}
+
+void FramePacer::setSwapMode(SwapMode mode)
+{
+	if (mode == SwapMode::Adaptive && !context.supportsAdaptiveSync())
+	{
+		std::cout << "WARNING::PACING::ADAPTIVE_UNSUPPORTED: using vsync" << std::endl;
+		mode = SwapMode::VSync;
+	}
+	options.swapMode = mode;
+	context.setSwapInterval(mode == SwapMode::VSync ? 1 : mode == SwapMode::Adaptive ? -1 : 0);
+}
+
+void FramePacer::setFpsLimit(double fps)
+{
+	options.fpsLimit = fps;
+	period = fps > 0.0
+		? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps))
+		: std::chrono::steady_clock::duration(0);
+	deadline = std::chrono::steady_clock::now();
+}
+
+void FramePacer::setMaxFramesInFlight(int count)
+{
+	options.maxFramesInFlight = count < 1 ? 1 : count > 3 ? 3 : count;
+}
+
+// Frame
+// -----
+void FramePacer::beginFrame()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// frames that already finished, without waiting
+	while (!fences.empty())
+	{
+		GLenum result = glClientWaitSync(fences.front().sync, 0, 0);
+		if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+			break;
+		retire(fences.front(), start);
+		fences.pop_front();
+	}
+
+	// too many queued, block on the oldest
+	while ((int)fences.size() >= options.maxFramesInFlight)
+	{
+		GLenum result = glClientWaitSync(fences.front().sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		if (result == GL_TIMEOUT_EXPIRED)
+			continue;	// still busy after a second, the bound only holds if we keep waiting
+		if (result == GL_WAIT_FAILED)
+		{
+			// keep the fence, the frame isn't done. the next beginFrame() tries again
+			std::cout << "ERROR::PACING::FENCE_WAIT_FAILED" << std::endl;
+			break;
+		}
+		std::chrono::steady_clock::time_point done = std::chrono::steady_clock::now();
+		retire(fences.front(), done);
+		fences.pop_front();
+	}
+	std::chrono::steady_clock::time_point waited = std::chrono::steady_clock::now();
+	fenceWaitMs += toMs(waited - start);
+
+	if (period.count() > 0)
+	{
+		deadline += period;
+		// fell more than a frame behind, don't try to catch up with a burst of frames
+		if (deadline + period < waited)
+			deadline = waited;
+		waitUntil(deadline);
+	}
+
+	input = std::chrono::steady_clock::now();
+}
+
+void FramePacer::endFrame()
+{
+	context.swapBuffers();
+
+	FrameFence fence{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), input };
+	fences.push_back(fence);
+	frames++;
+	glCheckError();
+}
+
+void FramePacer::retire(const FrameFence& fence, std::chrono::steady_clock::time_point done)
+{
+	// vsync: waits for the next vblank and scans out, about a refresh. immediate: half a scanout
+	double displayMs = options.swapMode == SwapMode::Immediate ? refreshMs * 0.5 : refreshMs;
+	double latencyMs = toMs(done - fence.input) + displayMs;
+	latencySumMs += latencyMs;
+	if (latencyMs > maxLatencyMs)
+		maxLatencyMs = latencyMs;
+	latencySamples++;
+	glDeleteSync(fence.sync);
+}
+
+void FramePacer::waitUntil(std::chrono::steady_clock::time_point target)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (target - now > spinMargin)
+	{
+		std::chrono::steady_clock::duration requested = target - now - spinMargin;
+		std::this_thread::sleep_for(requested);
+		std::chrono::steady_clock::time_point woke = std::chrono::steady_clock::now();
+		sleepMs += toMs(woke - now);
+
+		// grow straight to a bad oversleep, shrink slowly back when the OS behaves
+		std::chrono::steady_clock::duration oversleep = (woke - now) - requested;
+		if (oversleep > spinMargin)
+			spinMargin = oversleep;
+		else
+			spinMargin = spinMargin * 15 / 16 + oversleep / 16;
+		if (spinMargin < MIN_SPIN_MARGIN)
+			spinMargin = MIN_SPIN_MARGIN;
+		if (spinMargin > MAX_SPIN_MARGIN)
+			spinMargin = MAX_SPIN_MARGIN;
+		now = woke;
+	}
+
+	std::chrono::steady_clock::time_point spinStart = now;
+	while (now < target)
+	{
+		std::this_thread::yield();
+		now = std::chrono::steady_clock::now();
+	}
+	spinMs += toMs(now - spinStart);
+}
+
+// Stats
+// -----
+PacingStats FramePacer::getStats() const
+{
+	PacingStats stats;
+	stats.frames = frames;
+	if (frames > 0)
+	{
+		stats.avgSleepMs = sleepMs / frames;
+		stats.avgSpinMs = spinMs / frames;
+		stats.avgFenceWaitMs = fenceWaitMs / frames;
+	}
+	if (latencySamples > 0)
+		stats.avgLatencyMs = latencySumMs / latencySamples;
+	stats.maxLatencyMs = maxLatencyMs;
+	return stats;
+}
+
+void FramePacer::printStats() const
+{
+	PacingStats stats = getStats();
+	const char* modes[] = { "vsync", "off", "adaptive" };
+	std::cout << "PACING::STATS swap=" << modes[(int)options.swapMode]
+		<< " fps_limit=" << options.fpsLimit
+		<< " frames_in_flight=" << options.maxFramesInFlight
+		<< " frames=" << stats.frames
+		<< " sleep_ms=" << stats.avgSleepMs
+		<< " spin_ms=" << stats.avgSpinMs
+		<< " fence_wait_ms=" << stats.avgFenceWaitMs
+		<< " latency_ms=" << stats.avgLatencyMs
+		<< " max_latency_ms=" << stats.maxLatencyMs << std::endl;
+}
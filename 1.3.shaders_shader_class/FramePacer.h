@@ -0,0 +1,94 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <glad/glad.h>
+
+#include "Context.h"
+
+// Pacing options
+// --------------
+/// \note: Adaptive is late swap tearing (swap interval -1): vsync while the frame rate keeps
+///		   up, tearing instead of waiting a whole refresh when a frame is late. It needs
+///		   WGL/GLX_EXT_swap_control_tear and falls back to VSync without it.
+enum class SwapMode
+{
+	VSync,
+	Immediate,
+	Adaptive
+};
+
+struct PacingOptions
+{
+	SwapMode swapMode{ SwapMode::VSync };
+	double fpsLimit{ 0.0 };		// 0 = no limiter
+	int maxFramesInFlight{ 2 };	// frames the CPU may queue ahead of the GPU, 1..3
+};
+
+// reads --vsync on|off|adaptive, --fps-limit <fps> and --frames-in-flight <n>
+PacingOptions parsePacingOptions(int argc, char* argv[], PacingOptions options);
+
+// Frame pacer
+// -----------
+/// \note: beginFrame() goes at the top of the render loop, before input is polled, and
+///		   endFrame() replaces the swap:
+///		   1. frames in flight - a fence after every swap, beginFrame() waits on the fence
+///		      maxFramesInFlight frames back so the driver can't queue up more than that.
+///		   2. limiter          - sleeps until shortly before the frame's deadline, then
+///		      spins (yielding) for the rest. The spin margin follows how much the OS has
+///		      been oversleeping, so only the last fraction of a millisecond is busy.
+///		   Both waits happen before input is sampled, which keeps the input fresh.
+///		   The latency estimate is input sample -> GPU done (fence seen signaled) plus
+///		   the display: a refresh interval with vsync, half a scanout without.
+struct PacingStats
+{
+	unsigned long long frames{ 0 };
+	double avgSleepMs{ 0.0 };
+	double avgSpinMs{ 0.0 };
+	double avgFenceWaitMs{ 0.0 };
+	double avgLatencyMs{ 0.0 };
+	double maxLatencyMs{ 0.0 };
+};
+
+class FramePacer
+{
+	struct FrameFence
+	{
+		GLsync sync;
+		std::chrono::steady_clock::time_point input;
+	};
+
+	ContextProvider& context;
+	PacingOptions options;
+	std::deque<FrameFence> fences;
+	std::chrono::steady_clock::time_point deadline;
+	std::chrono::steady_clock::time_point input;
+	std::chrono::steady_clock::duration period;
+	std::chrono::steady_clock::duration spinMargin;
+	double refreshMs;
+
+	double sleepMs, spinMs, fenceWaitMs;
+	double latencySumMs, maxLatencyMs;
+	unsigned long long latencySamples;
+	unsigned long long frames;
+
+public:
+	FramePacer(ContextProvider& context, const PacingOptions& options);
+	~FramePacer();
+
+	FramePacer(const FramePacer&) = delete;
+	FramePacer& operator=(const FramePacer&) = delete;
+
+	void setSwapMode(SwapMode mode);
+	void setFpsLimit(double fps);
+	void setMaxFramesInFlight(int count);
+
+	void beginFrame();
+	void endFrame();
+
+	PacingStats getStats() const;
+	void printStats() const;
+
+private:
+	void retire(const FrameFence& fence, std::chrono::steady_clock::time_point done);
+	void waitUntil(std::chrono::steady_clock::time_point target);
+};
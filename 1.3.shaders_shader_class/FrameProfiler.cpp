@@ -0,0 +1,279 @@
+#include "FrameProfiler.h"
+#include "GLDebug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// the first frame pays for shader compiles and driver warm up, and llvmpipe returns a raw
+// timestamp for the very first GL_TIME_ELAPSED query, so its samples are dropped
+static const unsigned long long WARMUP_FRAMES = 1;
+
+FrameProfiler::FrameProfiler(bool gpuEnabled, int latency)
+	: frame(0), latency(latency < 1 ? 1 : latency), gpuEnabled(gpuEnabled), inFrame(false), frameCpu(-1), frameGpu(-1)
+{
+	current.frame = 0;
+	current.elapsed = 0;
+}
+
+FrameProfiler::~FrameProfiler()
+{
+	// needs the context to still be current
+	for (const PendingFrame& pendingFrame : pending)
+	{
+		release(pendingFrame);
+	}
+	if (!timestampPool.empty())
+		glDeleteQueries((GLsizei)timestampPool.size(), timestampPool.data());
+	if (!elapsedPool.empty())
+		glDeleteQueries((GLsizei)elapsedPool.size(), elapsedPool.data());
+}
+
+int FrameProfiler::findSection(const char* name, bool gpu)
+{
+	for (std::size_t i = 0; i < sections.size(); i++)
+	{
+		if (sections[i].gpu == gpu && sections[i].name == name)
+			return (int)i;
+	}
+	sections.push_back(Section{ name, gpu, std::vector<float>() });
+	return (int)sections.size() - 1;
+}
+
+GLuint FrameProfiler::acquireQuery(std::vector<GLuint>& pool)
+{
+	GLuint query;
+	if (pool.empty())
+	{
+		glGenQueries(1, &query);
+	}
+	else
+	{
+		query = pool.back();
+		pool.pop_back();
+	}
+	return query;
+}
+
+void FrameProfiler::release(const PendingFrame& pendingFrame)
+{
+	elapsedPool.push_back(pendingFrame.elapsed);
+	for (const GpuScope& scope : pendingFrame.scopes)
+	{
+		timestampPool.push_back(scope.begin);
+		timestampPool.push_back(scope.end);
+	}
+}
+
+// Frames
+// ------
+void FrameProfiler::beginFrame()
+{
+	// read back whatever is old enough and already written, oldest first
+	while (!pending.empty() && frame - pending.front().frame >= (unsigned long long)latency
+		&& collect(pending.front(), false))
+	{
+		release(pending.front());
+		pending.pop_front();
+	}
+
+	inFrame = true;
+	current.frame = frame;
+	current.scopes.clear();
+	gpuStack.clear();
+	if (frameCpu < 0)
+	{
+		frameCpu = findSection("frame", false);
+		if (gpuEnabled)
+			frameGpu = findSection("frame", true);
+	}
+	cpuStack.push_back(CpuScope{ frameCpu, std::chrono::steady_clock::now() });
+
+	if (gpuEnabled)
+	{
+		current.elapsed = acquireQuery(elapsedPool);
+		glBeginQuery(GL_TIME_ELAPSED, current.elapsed);
+	}
+}
+
+void FrameProfiler::endFrame()
+{
+	if (!inFrame)
+		return;
+
+	while (!gpuStack.empty())
+	{
+		if (gpuStack.back() >= 0)
+			std::cout << "ERROR::PROFILER::UNCLOSED_GPU_SCOPE " << sections[current.scopes[gpuStack.back()].section].name << std::endl;
+		endGpu();
+	}
+	if (gpuEnabled)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		pending.push_back(current);
+	}
+
+	// the frame scope is the bottom of the CPU stack
+	while (cpuStack.size() > 1)
+	{
+		std::cout << "ERROR::PROFILER::UNCLOSED_CPU_SCOPE " << sections[cpuStack.back().section].name << std::endl;
+		endCpu();
+	}
+	endCpu();
+
+	inFrame = false;
+	frame++;
+	glCheckError();
+}
+
+bool FrameProfiler::collect(const PendingFrame& pendingFrame, bool wait)
+{
+	if (!wait)
+	{
+		// all of the frame's queries, results may become available out of order
+		GLint available = 0;
+		glGetQueryObjectiv(pendingFrame.elapsed, GL_QUERY_RESULT_AVAILABLE, &available);
+		for (std::size_t i = 0; i < pendingFrame.scopes.size() && available; i++)
+		{
+			glGetQueryObjectiv(pendingFrame.scopes[i].end, GL_QUERY_RESULT_AVAILABLE, &available);
+		}
+		if (!available)
+			return false;
+	}
+	if (pendingFrame.frame < WARMUP_FRAMES)
+		return true;
+
+	GLuint64 elapsed = 0;
+	glGetQueryObjectui64v(pendingFrame.elapsed, GL_QUERY_RESULT, &elapsed);
+	sections[frameGpu].samples.push_back((float)(elapsed * 1e-6));
+
+	for (const GpuScope& scope : pendingFrame.scopes)
+	{
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(scope.begin, GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(scope.end, GL_QUERY_RESULT, &end);
+		sections[scope.section].samples.push_back(end > begin ? (float)((end - begin) * 1e-6) : 0.0f);
+	}
+	return true;
+}
+
+void FrameProfiler::flush()
+{
+	while (!pending.empty())
+	{
+		collect(pending.front(), true);
+		release(pending.front());
+		pending.pop_front();
+	}
+}
+
+// Scopes
+// ------
+void FrameProfiler::beginCpu(const char* name)
+{
+	cpuStack.push_back(CpuScope{ findSection(name, false), std::chrono::steady_clock::now() });
+}
+
+void FrameProfiler::endCpu()
+{
+	if (cpuStack.empty())
+		return;
+	const CpuScope& scope = cpuStack.back();
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scope.start).count();
+	if (frame >= WARMUP_FRAMES)
+		sections[scope.section].samples.push_back((float)ms);
+	cpuStack.pop_back();
+}
+
+void FrameProfiler::beginGpu(const char* name)
+{
+	// outside a frame there is no pending frame to attach the queries to
+	if (!gpuEnabled || !inFrame)
+	{
+		gpuStack.push_back(-1);
+		return;
+	}
+	GpuScope scope{ findSection(name, true), acquireQuery(timestampPool), 0 };
+	glQueryCounter(scope.begin, GL_TIMESTAMP);
+	gpuStack.push_back((int)current.scopes.size());
+	current.scopes.push_back(scope);
+}
+
+void FrameProfiler::endGpu()
+{
+	if (gpuStack.empty())
+		return;
+	int index = gpuStack.back();
+	gpuStack.pop_back();
+	if (index < 0)
+		return;
+	current.scopes[index].end = acquireQuery(timestampPool);
+	glQueryCounter(current.scopes[index].end, GL_TIMESTAMP);
+}
+
+// Reports
+// -------
+std::vector<ProfileStats> FrameProfiler::getStats() const
+{
+	std::vector<ProfileStats> stats;
+	std::vector<float> sorted;
+	for (const Section& section : sections)
+	{
+		ProfileStats entry;
+		entry.name = section.name;
+		entry.gpu = section.gpu;
+		entry.samples = section.samples.size();
+		if (!section.samples.empty())
+		{
+			sorted = section.samples;
+			std::sort(sorted.begin(), sorted.end());
+			double sum = 0.0;
+			for (float sample : sorted)
+			{
+				sum += sample;
+			}
+			std::size_t p99 = (std::size_t)std::ceil(0.99 * sorted.size()) - 1;
+			entry.minMs = sorted.front();
+			entry.avgMs = sum / sorted.size();
+			entry.p99Ms = sorted[p99];
+		}
+		stats.push_back(entry);
+	}
+	return stats;
+}
+
+void FrameProfiler::printSummary() const
+{
+	std::vector<ProfileStats> stats = getStats();
+	std::ios::fmtflags flags = std::cout.flags();
+	std::streamsize precision = std::cout.precision();
+	std::cout << "PROFILER::SUMMARY frames=" << frame << std::endl;
+	for (const ProfileStats& entry : stats)
+	{
+		std::cout << "  " << std::left << std::setw(16) << entry.name << (entry.gpu ? " gpu" : " cpu")
+			<< std::fixed << std::setprecision(3)
+			<< " min=" << entry.minMs << "ms avg=" << entry.avgMs << "ms p99=" << entry.p99Ms << "ms"
+			<< " samples=" << entry.samples << std::endl;
+	}
+	std::cout.flags(flags);
+	std::cout.precision(precision);
+}
+
+bool FrameProfiler::writeCsv(const char* path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR::PROFILER::CSV_NOT_WRITABLE " << path << std::endl;
+		return false;
+	}
+	file << "name,type,samples,min_ms,avg_ms,p99_ms\n";
+	for (const ProfileStats& entry : getStats())
+	{
+		file << entry.name << "," << (entry.gpu ? "gpu" : "cpu") << "," << entry.samples << ","
+			<< entry.minMs << "," << entry.avgMs << "," << entry.p99Ms << "\n";
+	}
+	return true;
+}
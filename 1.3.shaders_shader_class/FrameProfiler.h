@@ -0,0 +1,133 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+// Frame profiler
+// --------------
+/// \note: named CPU scopes (steady_clock) and GPU scopes (a GL_TIMESTAMP query at each end,
+///		   so GPU scopes can nest, unlike GL_TIME_ELAPSED). The whole frame is measured with
+///		   a GL_TIME_ELAPSED query. Queries come from a pool and a frame's results are only
+///		   read back once it is at least `latency` frames old and the GPU has written them,
+///		   so the profiler never waits on the GPU; a late frame just stays queued.
+///
+///		   profiler.beginFrame();
+///		   {
+///			ProfileScope scope(profiler, "geometry");   // CPU + GPU
+///			...
+///		   }
+///		   profiler.endFrame();
+///		   ...
+///		   profiler.printSummary();
+///		   profiler.writeCsv("frames.csv");
+struct ProfileStats
+{
+	std::string name;
+	bool gpu{ false };
+	std::size_t samples{ 0 };
+	double minMs{ 0.0 };
+	double avgMs{ 0.0 };
+	double p99Ms{ 0.0 };
+};
+
+class FrameProfiler
+{
+	struct Section
+	{
+		std::string name;
+		bool gpu;
+		std::vector<float> samples;	// ms, one per frame the scope was open in
+	};
+
+	struct CpuScope
+	{
+		int section;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	struct GpuScope
+	{
+		int section;
+		GLuint begin;
+		GLuint end;
+	};
+
+	struct PendingFrame
+	{
+		unsigned long long frame;
+		GLuint elapsed;
+		std::vector<GpuScope> scopes;
+	};
+
+	std::vector<Section> sections;
+	// a query keeps the type it was first used with, so the two kinds are pooled apart
+	std::vector<GLuint> timestampPool;
+	std::vector<GLuint> elapsedPool;
+	std::deque<PendingFrame> pending;
+	PendingFrame current;
+	std::vector<CpuScope> cpuStack;
+	std::vector<int> gpuStack;	// indices into current.scopes
+
+	unsigned long long frame;
+	int latency;
+	bool gpuEnabled;
+	bool inFrame;
+	int frameCpu, frameGpu;
+
+public:
+	// latency: minimum number of frames between issuing a query and reading it back
+	FrameProfiler(bool gpuEnabled = true, int latency = 3);
+	~FrameProfiler();
+
+	FrameProfiler(const FrameProfiler&) = delete;
+	FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+	void beginFrame();
+	void endFrame();
+
+	// scopes have to be closed in the reverse order they were opened
+	void beginCpu(const char* name);
+	void endCpu();
+	void beginGpu(const char* name);
+	void endGpu();
+
+	// reads back every pending frame, waiting for the GPU. for the end of a run only
+	void flush();
+
+	std::vector<ProfileStats> getStats() const;
+	void printSummary() const;
+	// one row per scope: name,type,samples,min_ms,avg_ms,p99_ms
+	bool writeCsv(const char* path) const;
+
+	unsigned long long getFrame() const { return frame; }
+
+private:
+	int findSection(const char* name, bool gpu);
+	GLuint acquireQuery(std::vector<GLuint>& pool);
+	bool collect(const PendingFrame& frame, bool wait);
+	void release(const PendingFrame& frame);
+};
+
+// CPU and GPU scope for the lifetime of the object
+class ProfileScope
+{
+	FrameProfiler& profiler;
+
+public:
+	ProfileScope(FrameProfiler& profiler, const char* name)
+		: profiler(profiler)
+	{
+		profiler.beginCpu(name);
+		profiler.beginGpu(name);
+	}
+	~ProfileScope()
+	{
+		profiler.endGpu();
+		profiler.endCpu();
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
@@ -0,0 +1,28 @@
+#include "GLDebug.h"
+
+GLenum glCheckError_(const char* file, int line)
+{
+	GLenum errorCode;
+	while ((errorCode = glGetError()) != GL_NO_ERROR)
+	{
+		const char* error;
+		switch (errorCode)
+		{
+			case GL_INVALID_ENUM:                  error = "INVALID_ENUM"; break;
+			case GL_INVALID_VALUE:                 error = "INVALID_VALUE"; break;
+			case GL_INVALID_OPERATION:             error = "INVALID_OPERATION"; break;
+			case GL_OUT_OF_MEMORY:                 error = "OUT_OF_MEMORY"; break;
+			case GL_INVALID_FRAMEBUFFER_OPERATION: error = "INVALID_FRAMEBUFFER_OPERATION"; break;
+			default:                               error = "UNKNOWN"; break;
+		}
+		std::cout << "ERROR::GL::" << error << " | " << file << " (" << line << ")" << std::endl;
+	}
+	return errorCode;
+}
+
+bool isNoErrorContext()
+{
+	int flags = 0;
+	glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+	return (flags & GL_CONTEXT_FLAG_NO_ERROR_BIT) != 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <iostream>
+#include <glad/glad.h>
+
+// Debug-only GL error checks
+// --------------------------
+/// \note: GL_DEBUG_CHECKS is on for Debug builds and compiled out for Release (NDEBUG).
+///		   Release builds also ask for a KHR_no_error context, so the driver skips its
+///		   own validation and glGetError would only ever return GL_NO_ERROR anyway.
+///		   Either default can be overridden with /D GL_DEBUG_CHECKS=0|1.
+#ifndef GL_DEBUG_CHECKS
+	#ifdef NDEBUG
+		#define GL_DEBUG_CHECKS 0
+	#else
+		#define GL_DEBUG_CHECKS 1
+	#endif
+#endif
+
+// not part of the 3.3 core glad header
+#ifndef GL_CONTEXT_FLAG_NO_ERROR_BIT
+	#define GL_CONTEXT_FLAG_NO_ERROR_BIT 0x00000008
+#endif
+
+GLenum glCheckError_(const char* file, int line);
+
+#if GL_DEBUG_CHECKS
+	#define glCheckError() glCheckError_(__FILE__, __LINE__)
+#else
+	#define glCheckError() ((void)0)
+#endif
+
+// true if the current context was created with GLFW_CONTEXT_NO_ERROR
+bool isNoErrorContext();
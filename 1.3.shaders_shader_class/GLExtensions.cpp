@@ -0,0 +1,96 @@
+#include "GLExtensions.h"
+
+#include <cstring>
+
+PFNGLBUFFERSTORAGEPROC glad_glBufferStorage = NULL;
+PFNGLBINDVERTEXBUFFERPROC glad_glBindVertexBuffer = NULL;
+PFNGLVERTEXATTRIBFORMATPROC glad_glVertexAttribFormat = NULL;
+PFNGLVERTEXATTRIBIFORMATPROC glad_glVertexAttribIFormat = NULL;
+PFNGLVERTEXATTRIBBINDINGPROC glad_glVertexAttribBinding = NULL;
+PFNGLPROGRAMUNIFORM1IPROC glad_glProgramUniform1i = NULL;
+PFNGLPROGRAMUNIFORM1FPROC glad_glProgramUniform1f = NULL;
+PFNGLPROGRAMUNIFORM3FPROC glad_glProgramUniform3f = NULL;
+PFNGLPROGRAMUNIFORM3FVPROC glad_glProgramUniform3fv = NULL;
+PFNGLCREATEBUFFERSPROC glad_glCreateBuffers = NULL;
+PFNGLNAMEDBUFFERSTORAGEPROC glad_glNamedBufferStorage = NULL;
+PFNGLNAMEDBUFFERSUBDATAPROC glad_glNamedBufferSubData = NULL;
+PFNGLCREATEVERTEXARRAYSPROC glad_glCreateVertexArrays = NULL;
+PFNGLVERTEXARRAYVERTEXBUFFERPROC glad_glVertexArrayVertexBuffer = NULL;
+PFNGLVERTEXARRAYELEMENTBUFFERPROC glad_glVertexArrayElementBuffer = NULL;
+PFNGLVERTEXARRAYATTRIBFORMATPROC glad_glVertexArrayAttribFormat = NULL;
+PFNGLVERTEXARRAYATTRIBIFORMATPROC glad_glVertexArrayAttribIFormat = NULL;
+PFNGLVERTEXARRAYATTRIBBINDINGPROC glad_glVertexArrayAttribBinding = NULL;
+PFNGLENABLEVERTEXARRAYATTRIBPROC glad_glEnableVertexArrayAttrib = NULL;
+
+GLExtensions GLExt;
+
+static bool hasGLVersion(int major, int minor)
+{
+	return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+bool hasGLExtension(const char* name)
+{
+	int count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (int i = 0; i < count; i++)
+	{
+		const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if (extension != NULL && std::strcmp(extension, name) == 0)
+			return true;
+	}
+	return false;
+}
+
+void loadGLExtensions(GLADloadproc load)
+{
+	GLExt = GLExtensions();
+
+	if (hasGLVersion(4, 4) || hasGLExtension("GL_ARB_buffer_storage"))
+	{
+		glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+		GLExt.bufferStorage = glad_glBufferStorage != NULL;
+	}
+
+	GLExt.primitiveRestartFixedIndex = hasGLVersion(4, 3) || hasGLExtension("GL_ARB_ES3_compatibility");
+
+	if (hasGLVersion(4, 3) || hasGLExtension("GL_ARB_vertex_attrib_binding"))
+	{
+		glad_glBindVertexBuffer = (PFNGLBINDVERTEXBUFFERPROC)load("glBindVertexBuffer");
+		glad_glVertexAttribFormat = (PFNGLVERTEXATTRIBFORMATPROC)load("glVertexAttribFormat");
+		glad_glVertexAttribIFormat = (PFNGLVERTEXATTRIBIFORMATPROC)load("glVertexAttribIFormat");
+		glad_glVertexAttribBinding = (PFNGLVERTEXATTRIBBINDINGPROC)load("glVertexAttribBinding");
+		GLExt.vertexAttribBinding = glad_glBindVertexBuffer != NULL && glad_glVertexAttribFormat != NULL
+			&& glad_glVertexAttribIFormat != NULL && glad_glVertexAttribBinding != NULL;
+	}
+
+	if (hasGLVersion(4, 1) || hasGLExtension("GL_ARB_separate_shader_objects"))
+	{
+		glad_glProgramUniform1i = (PFNGLPROGRAMUNIFORM1IPROC)load("glProgramUniform1i");
+		glad_glProgramUniform1f = (PFNGLPROGRAMUNIFORM1FPROC)load("glProgramUniform1f");
+		glad_glProgramUniform3f = (PFNGLPROGRAMUNIFORM3FPROC)load("glProgramUniform3f");
+		glad_glProgramUniform3fv = (PFNGLPROGRAMUNIFORM3FVPROC)load("glProgramUniform3fv");
+		GLExt.programUniform = glad_glProgramUniform1i != NULL && glad_glProgramUniform1f != NULL
+			&& glad_glProgramUniform3f != NULL && glad_glProgramUniform3fv != NULL;
+	}
+
+	// DSA buffers are created with immutable storage, so it needs buffer_storage as well
+	if ((hasGLVersion(4, 5) || hasGLExtension("GL_ARB_direct_state_access")) && GLExt.bufferStorage)
+	{
+		glad_glCreateBuffers = (PFNGLCREATEBUFFERSPROC)load("glCreateBuffers");
+		glad_glNamedBufferStorage = (PFNGLNAMEDBUFFERSTORAGEPROC)load("glNamedBufferStorage");
+		glad_glNamedBufferSubData = (PFNGLNAMEDBUFFERSUBDATAPROC)load("glNamedBufferSubData");
+		glad_glCreateVertexArrays = (PFNGLCREATEVERTEXARRAYSPROC)load("glCreateVertexArrays");
+		glad_glVertexArrayVertexBuffer = (PFNGLVERTEXARRAYVERTEXBUFFERPROC)load("glVertexArrayVertexBuffer");
+		glad_glVertexArrayElementBuffer = (PFNGLVERTEXARRAYELEMENTBUFFERPROC)load("glVertexArrayElementBuffer");
+		glad_glVertexArrayAttribFormat = (PFNGLVERTEXARRAYATTRIBFORMATPROC)load("glVertexArrayAttribFormat");
+		glad_glVertexArrayAttribIFormat = (PFNGLVERTEXARRAYATTRIBIFORMATPROC)load("glVertexArrayAttribIFormat");
+		glad_glVertexArrayAttribBinding = (PFNGLVERTEXARRAYATTRIBBINDINGPROC)load("glVertexArrayAttribBinding");
+		glad_glEnableVertexArrayAttrib = (PFNGLENABLEVERTEXARRAYATTRIBPROC)load("glEnableVertexArrayAttrib");
+		GLExt.directStateAccess = glad_glCreateBuffers != NULL && glad_glNamedBufferStorage != NULL
+			&& glad_glNamedBufferSubData != NULL && glad_glCreateVertexArrays != NULL
+			&& glad_glVertexArrayVertexBuffer != NULL && glad_glVertexArrayElementBuffer != NULL
+			&& glad_glVertexArrayAttribFormat != NULL && glad_glVertexArrayAttribIFormat != NULL
+			&& glad_glVertexArrayAttribBinding != NULL && glad_glEnableVertexArrayAttrib != NULL;
+	}
+}
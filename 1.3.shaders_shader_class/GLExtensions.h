@@ -0,0 +1,99 @@
+#pragma once
+#include <glad/glad.h>
+
+// Post 3.3 entry points
+// ---------------------
+/// \note: glad was generated for core 3.3 only, so anything newer is loaded here by hand
+///		   with the same loader glad used. Always check the GLExt flags before calling.
+
+#ifndef GL_MAP_PERSISTENT_BIT
+	#define GL_MAP_PERSISTENT_BIT 0x0040
+	#define GL_MAP_COHERENT_BIT 0x0080
+	#define GL_DYNAMIC_STORAGE_BIT 0x0100
+	#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+// GL 4.3 / ARB_ES3_compatibility
+#ifndef GL_PRIMITIVE_RESTART_FIXED_INDEX
+	#define GL_PRIMITIVE_RESTART_FIXED_INDEX 0x8D69
+#endif
+
+// GL 4.4 / ARB_buffer_storage
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+extern PFNGLBUFFERSTORAGEPROC glad_glBufferStorage;
+#define glBufferStorage glad_glBufferStorage
+
+// GL 4.3 / ARB_vertex_attrib_binding
+typedef void (APIENTRYP PFNGLBINDVERTEXBUFFERPROC)(GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride);
+typedef void (APIENTRYP PFNGLVERTEXATTRIBFORMATPROC)(GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset);
+typedef void (APIENTRYP PFNGLVERTEXATTRIBIFORMATPROC)(GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset);
+typedef void (APIENTRYP PFNGLVERTEXATTRIBBINDINGPROC)(GLuint attribindex, GLuint bindingindex);
+extern PFNGLBINDVERTEXBUFFERPROC glad_glBindVertexBuffer;
+extern PFNGLVERTEXATTRIBFORMATPROC glad_glVertexAttribFormat;
+extern PFNGLVERTEXATTRIBIFORMATPROC glad_glVertexAttribIFormat;
+extern PFNGLVERTEXATTRIBBINDINGPROC glad_glVertexAttribBinding;
+#define glBindVertexBuffer glad_glBindVertexBuffer
+#define glVertexAttribFormat glad_glVertexAttribFormat
+#define glVertexAttribIFormat glad_glVertexAttribIFormat
+#define glVertexAttribBinding glad_glVertexAttribBinding
+
+// GL 4.1 / ARB_separate_shader_objects (only the uniform setters)
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM1IPROC)(GLuint program, GLint location, GLint v0);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM1FPROC)(GLuint program, GLint location, GLfloat v0);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM3FPROC)(GLuint program, GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM3FVPROC)(GLuint program, GLint location, GLsizei count, const GLfloat* value);
+extern PFNGLPROGRAMUNIFORM1IPROC glad_glProgramUniform1i;
+extern PFNGLPROGRAMUNIFORM1FPROC glad_glProgramUniform1f;
+extern PFNGLPROGRAMUNIFORM3FPROC glad_glProgramUniform3f;
+extern PFNGLPROGRAMUNIFORM3FVPROC glad_glProgramUniform3fv;
+#define glProgramUniform1i glad_glProgramUniform1i
+#define glProgramUniform1f glad_glProgramUniform1f
+#define glProgramUniform3f glad_glProgramUniform3f
+#define glProgramUniform3fv glad_glProgramUniform3fv
+
+// GL 4.5 / ARB_direct_state_access (buffers and vertex arrays)
+typedef void (APIENTRYP PFNGLCREATEBUFFERSPROC)(GLsizei n, GLuint* buffers);
+typedef void (APIENTRYP PFNGLNAMEDBUFFERSTORAGEPROC)(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags);
+typedef void (APIENTRYP PFNGLNAMEDBUFFERSUBDATAPROC)(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data);
+typedef void (APIENTRYP PFNGLCREATEVERTEXARRAYSPROC)(GLsizei n, GLuint* arrays);
+typedef void (APIENTRYP PFNGLVERTEXARRAYVERTEXBUFFERPROC)(GLuint vaobj, GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride);
+typedef void (APIENTRYP PFNGLVERTEXARRAYELEMENTBUFFERPROC)(GLuint vaobj, GLuint buffer);
+typedef void (APIENTRYP PFNGLVERTEXARRAYATTRIBFORMATPROC)(GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset);
+typedef void (APIENTRYP PFNGLVERTEXARRAYATTRIBIFORMATPROC)(GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset);
+typedef void (APIENTRYP PFNGLVERTEXARRAYATTRIBBINDINGPROC)(GLuint vaobj, GLuint attribindex, GLuint bindingindex);
+typedef void (APIENTRYP PFNGLENABLEVERTEXARRAYATTRIBPROC)(GLuint vaobj, GLuint index);
+extern PFNGLCREATEBUFFERSPROC glad_glCreateBuffers;
+extern PFNGLNAMEDBUFFERSTORAGEPROC glad_glNamedBufferStorage;
+extern PFNGLNAMEDBUFFERSUBDATAPROC glad_glNamedBufferSubData;
+extern PFNGLCREATEVERTEXARRAYSPROC glad_glCreateVertexArrays;
+extern PFNGLVERTEXARRAYVERTEXBUFFERPROC glad_glVertexArrayVertexBuffer;
+extern PFNGLVERTEXARRAYELEMENTBUFFERPROC glad_glVertexArrayElementBuffer;
+extern PFNGLVERTEXARRAYATTRIBFORMATPROC glad_glVertexArrayAttribFormat;
+extern PFNGLVERTEXARRAYATTRIBIFORMATPROC glad_glVertexArrayAttribIFormat;
+extern PFNGLVERTEXARRAYATTRIBBINDINGPROC glad_glVertexArrayAttribBinding;
+extern PFNGLENABLEVERTEXARRAYATTRIBPROC glad_glEnableVertexArrayAttrib;
+#define glCreateBuffers glad_glCreateBuffers
+#define glNamedBufferStorage glad_glNamedBufferStorage
+#define glNamedBufferSubData glad_glNamedBufferSubData
+#define glCreateVertexArrays glad_glCreateVertexArrays
+#define glVertexArrayVertexBuffer glad_glVertexArrayVertexBuffer
+#define glVertexArrayElementBuffer glad_glVertexArrayElementBuffer
+#define glVertexArrayAttribFormat glad_glVertexArrayAttribFormat
+#define glVertexArrayAttribIFormat glad_glVertexArrayAttribIFormat
+#define glVertexArrayAttribBinding glad_glVertexArrayAttribBinding
+#define glEnableVertexArrayAttrib glad_glEnableVertexArrayAttrib
+
+struct GLExtensions
+{
+	bool bufferStorage{ false };
+	bool vertexAttribBinding{ false };
+	bool primitiveRestartFixedIndex{ false };
+	bool programUniform{ false };
+	bool directStateAccess{ false };
+};
+extern GLExtensions GLExt;
+
+bool hasGLExtension(const char* name);
+
+// call once after gladLoadGLLoader, with the same loader
+void loadGLExtensions(GLADloadproc load);
@@ -0,0 +1,227 @@
+#include "GLResources.h"
+#include "GLExtensions.h"
+#include "GLDebug.h"
+
+// 0xFFFFFFFF is never a valid name, so the first bind after invalidateBindings() always goes through
+static const unsigned int UNKNOWN_BINDING = 0xFFFFFFFF;
+static unsigned int boundProgram = UNKNOWN_BINDING;
+static unsigned int boundVertexArray = UNKNOWN_BINDING;
+static BindStats bindStats;
+
+// Bind cache
+// ----------
+void useProgram(unsigned int program)
+{
+	if (program == boundProgram)
+	{
+		bindStats.skippedBinds++;
+		return;
+	}
+	glUseProgram(program);
+	boundProgram = program;
+	bindStats.programBinds++;
+}
+
+void bindVertexArray(unsigned int VAO)
+{
+	if (VAO == boundVertexArray)
+	{
+		bindStats.skippedBinds++;
+		return;
+	}
+	glBindVertexArray(VAO);
+	boundVertexArray = VAO;
+	bindStats.vertexArrayBinds++;
+}
+
+void invalidateBindings()
+{
+	boundProgram = UNKNOWN_BINDING;
+	boundVertexArray = UNKNOWN_BINDING;
+}
+
+BindStats getBindStats()
+{
+	return bindStats;
+}
+
+// restores the cached binding after an edit, or leaves 0 if nothing is known
+static void restoreVertexArray()
+{
+	glBindVertexArray(boundVertexArray == UNKNOWN_BINDING ? 0 : boundVertexArray);
+}
+
+static void restoreProgram()
+{
+	glUseProgram(boundProgram == UNKNOWN_BINDING ? 0 : boundProgram);
+}
+
+// Buffers
+// -------
+unsigned int createBuffer(GLsizeiptr size, const void* data, bool dynamic)
+{
+	unsigned int buffer;
+	if (GLExt.directStateAccess)
+	{
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, size, data, dynamic ? GL_DYNAMIC_STORAGE_BIT : 0);
+	}
+	else
+	{
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, size, data, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+	glCheckError();
+	return buffer;
+}
+
+void updateBuffer(unsigned int buffer, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	if (GLExt.directStateAccess)
+	{
+		glNamedBufferSubData(buffer, offset, size, data);
+	}
+	else
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+	glCheckError();
+}
+
+void deleteBuffer(unsigned int buffer)
+{
+	glDeleteBuffers(1, &buffer);
+}
+
+// Vertex arrays
+// -------------
+unsigned int createVertexArray(const VertexLayout& layout, unsigned int VBO, unsigned int EBO)
+{
+	unsigned int VAO;
+	if (GLExt.directStateAccess)
+	{
+		glCreateVertexArrays(1, &VAO);
+		for (int i = 0; i < layout.count; i++)
+		{
+			const AttributeDesc& attribute = layout.attributes[i];
+			if (attribute.integer)
+				glVertexArrayAttribIFormat(VAO, i, attribute.components, attribute.type, attribute.offset);
+			else
+				glVertexArrayAttribFormat(VAO, i, attribute.components, attribute.type, attribute.normalized, attribute.offset);
+			glVertexArrayAttribBinding(VAO, i, 0);
+			glEnableVertexArrayAttrib(VAO, i);
+		}
+		glVertexArrayVertexBuffer(VAO, 0, VBO, 0, layout.stride);
+		glVertexArrayElementBuffer(VAO, EBO);
+	}
+	else
+	{
+		// the element buffer binding is VAO state, so this one has to be bound while editing
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		setupVertexAttributes(layout);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		restoreVertexArray();
+	}
+	glCheckError();
+	return VAO;
+}
+
+void deleteVertexArray(unsigned int VAO)
+{
+	// deleting the bound VAO reverts the binding to 0
+	if (VAO == boundVertexArray)
+		boundVertexArray = 0;
+	glDeleteVertexArrays(1, &VAO);
+}
+
+// Programs
+// --------
+void deleteProgram(unsigned int program)
+{
+	if (program == boundProgram)
+		useProgram(0);
+	glDeleteProgram(program);
+}
+
+// Uniforms
+// --------
+/// \note: without glProgramUniform the program has to be current, so it is swapped in and
+///		   the cached one put back. Setting uniforms on the bound program costs no binds at all.
+void programUniform1i(unsigned int program, GLint location, GLint value)
+{
+	if (GLExt.programUniform)
+	{
+		glProgramUniform1i(program, location, value);
+	}
+	else if (program == boundProgram)
+	{
+		glUniform1i(location, value);
+	}
+	else
+	{
+		glUseProgram(program);
+		glUniform1i(location, value);
+		restoreProgram();
+	}
+}
+
+void programUniform1f(unsigned int program, GLint location, GLfloat value)
+{
+	if (GLExt.programUniform)
+	{
+		glProgramUniform1f(program, location, value);
+	}
+	else if (program == boundProgram)
+	{
+		glUniform1f(location, value);
+	}
+	else
+	{
+		glUseProgram(program);
+		glUniform1f(location, value);
+		restoreProgram();
+	}
+}
+
+void programUniform3f(unsigned int program, GLint location, GLfloat x, GLfloat y, GLfloat z)
+{
+	if (GLExt.programUniform)
+	{
+		glProgramUniform3f(program, location, x, y, z);
+	}
+	else if (program == boundProgram)
+	{
+		glUniform3f(location, x, y, z);
+	}
+	else
+	{
+		glUseProgram(program);
+		glUniform3f(location, x, y, z);
+		restoreProgram();
+	}
+}
+
+void programUniform3fv(unsigned int program, GLint location, const GLfloat* value)
+{
+	if (GLExt.programUniform)
+	{
+		glProgramUniform3fv(program, location, 1, value);
+	}
+	else if (program == boundProgram)
+	{
+		glUniform3fv(location, 1, value);
+	}
+	else
+	{
+		glUseProgram(program);
+		glUniform3fv(location, 1, value);
+		restoreProgram();
+	}
+}
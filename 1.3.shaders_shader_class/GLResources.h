@@ -0,0 +1,52 @@
+#pragma once
+#include <glad/glad.h>
+
+#include "VertexFormat.h"
+
+// Resource layer
+// --------------
+/// \note: creates and edits buffers, vertex arrays and uniforms without touching what is
+///		   bound for drawing. With GL 4.5 / ARB_direct_state_access everything goes through
+///		   the named (glCreate*, glNamed*, glVertexArray*) entry points and uniforms through
+///		   glProgramUniform* (4.1). On 3.3 the same calls are emulated with bind-to-edit:
+///		   buffers are edited on GL_COPY_WRITE_BUFFER, which nothing draws from, and the VAO
+///		   or program that had to be bound is put back from the bind cache below.
+///
+///		   unsigned int VBO = createBuffer(sizeof(vertices), vertices);
+///		   unsigned int VAO = createVertexArray(ColorVertex::Format::layout(), VBO);
+///		   programUniform1f(program, location, time);   // no glUseProgram needed
+///
+///		   DSA buffers have immutable storage, updateBuffer() needs dynamic = true.
+unsigned int createBuffer(GLsizeiptr size, const void* data, bool dynamic = false);
+void updateBuffer(unsigned int buffer, GLintptr offset, GLsizeiptr size, const void* data);
+void deleteBuffer(unsigned int buffer);
+
+// a VAO reading layout from VBO at binding 0 (and indices from EBO, may be 0)
+unsigned int createVertexArray(const VertexLayout& layout, unsigned int VBO, unsigned int EBO = 0);
+void deleteVertexArray(unsigned int VAO);
+
+// unbinds it first if it is the cached program, so the cache never holds a dead name
+void deleteProgram(unsigned int program);
+
+void programUniform1i(unsigned int program, GLint location, GLint value);
+void programUniform1f(unsigned int program, GLint location, GLfloat value);
+void programUniform3f(unsigned int program, GLint location, GLfloat x, GLfloat y, GLfloat z);
+void programUniform3fv(unsigned int program, GLint location, const GLfloat* value);
+
+// Bind cache
+// ----------
+/// \note: remembers the current program and VAO so binding the same one twice costs nothing.
+///		   Only correct while every program and VAO bind goes through here, call
+///		   invalidateBindings() after code that binds them directly.
+struct BindStats
+{
+	unsigned long long programBinds{ 0 };
+	unsigned long long vertexArrayBinds{ 0 };
+	unsigned long long skippedBinds{ 0 };
+};
+
+void useProgram(unsigned int program);
+void bindVertexArray(unsigned int VAO);
+void invalidateBindings();
+
+BindStats getBindStats();
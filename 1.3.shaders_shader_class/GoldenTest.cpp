@@ -0,0 +1,327 @@
+#include "GoldenTest.h"
+#include "GLDebug.h"
+#include "GLResources.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+GoldenOptions parseGoldenOptions(int argc, char* argv[], GoldenOptions options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--golden-dir") == 0 && i + 1 < argc)
+			options.dir = argv[++i];
+		else if (std::strcmp(argv[i], "--golden-update") == 0)
+			options.update = true;
+		else if (std::strcmp(argv[i], "--golden-threshold") == 0 && i + 1 < argc)
+			options.threshold = (float)std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--golden-max-diff") == 0 && i + 1 < argc)
+			options.maxDiffFraction = (float)std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--golden-budget-scale") == 0 && i + 1 < argc)
+			options.budgetScale = std::atof(argv[++i]);
+	}
+	return options;
+}
+
+// PPM
+// ---
+// skips whitespace and # comments between header fields
+static bool readPpmField(std::istream& in, int& value)
+{
+	while (in)
+	{
+		int c = in.peek();
+		if (c == '#')
+		{
+			std::string comment;
+			std::getline(in, comment);
+		}
+		else if (std::isspace(c))
+		{
+			in.get();
+		}
+		else
+		{
+			break;
+		}
+	}
+	return (bool)(in >> value);
+}
+
+bool readPpm(const std::string& path, GoldenImage& image)
+{
+	std::ifstream in(path, std::ios::binary);
+	char magic[2];
+	if (!in.read(magic, 2) || magic[0] != 'P' || magic[1] != '6')
+		return false;
+
+	int maxValue;
+	if (!readPpmField(in, image.width) || !readPpmField(in, image.height) || !readPpmField(in, maxValue)
+		|| maxValue != 255 || image.width <= 0 || image.height <= 0)
+	{
+		std::cout << "ERROR::GOLDEN::UNSUPPORTED_PPM " << path << std::endl;
+		return false;
+	}
+	// exactly one whitespace byte between the header and the pixels
+	in.get();
+
+	image.rgb.resize((std::size_t)image.width * image.height * 3);
+	return (bool)in.read((char*)image.rgb.data(), image.rgb.size());
+}
+
+bool writePpm(const std::string& path, const GoldenImage& image)
+{
+	std::ofstream out(path, std::ios::binary);
+	out << "P6\n" << image.width << " " << image.height << "\n255\n";
+	out.write((const char*)image.rgb.data(), image.rgb.size());
+	if (!out)
+	{
+		std::cout << "ERROR::GOLDEN::WRITE_FAILED " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Comparison
+// ----------
+/// \note: squared YIQ distance with the weights from Kotsarenko & Ramos, "Measuring perceived
+///		   color difference using YIQ NTSC transmission color space" (also used by pixelmatch).
+///		   Luma counts about twice as much as either chroma axis.
+static const float MAX_YIQ_DELTA = 35215.0f;
+
+static float yiqDelta(const unsigned char* a, const unsigned char* b)
+{
+	float r = (float)a[0] - b[0];
+	float g = (float)a[1] - b[1];
+	float bl = (float)a[2] - b[2];
+	float y = r * 0.29889531f + g * 0.58662247f + bl * 0.11448223f;
+	float i = r * 0.59597799f - g * 0.27417610f - bl * 0.32180189f;
+	float q = r * 0.21147017f - g * 0.52261711f + bl * 0.31114694f;
+	return 0.5053f * y * y + 0.299f * i * i + 0.1957f * q * q;
+}
+
+ImageDiff compareImages(const GoldenImage& expected, const GoldenImage& actual, float threshold)
+{
+	ImageDiff result;
+	result.diff.width = expected.width;
+	result.diff.height = expected.height;
+	result.diff.rgb.resize(expected.rgb.size());
+
+	float limit = MAX_YIQ_DELTA * threshold * threshold;
+	float maxDelta = 0.0f;
+	for (std::size_t p = 0; p < expected.rgb.size(); p += 3)
+	{
+		float delta = yiqDelta(&expected.rgb[p], &actual.rgb[p]);
+		maxDelta = std::max(maxDelta, delta);
+
+		unsigned char* out = &result.diff.rgb[p];
+		if (delta > limit)
+		{
+			result.differing++;
+			out[0] = 255;
+			out[1] = 0;
+			out[2] = 0;
+		}
+		else
+		{
+			// faded grey copy so the red stands out
+			unsigned char grey = (unsigned char)(
+				(expected.rgb[p] * 77 + expected.rgb[p + 1] * 150 + expected.rgb[p + 2] * 29) >> 8);
+			out[0] = out[1] = out[2] = (unsigned char)(255 - (255 - grey) / 4);
+		}
+	}
+	result.maxDelta = std::sqrt(maxDelta / MAX_YIQ_DELTA);
+	return result;
+}
+
+// Runner
+// ------
+struct GoldenTarget
+{
+	unsigned int FBO{ 0 };
+	unsigned int colorBuffer{ 0 };
+
+	GoldenTarget(int width, int height)
+	{
+		glGenRenderbuffers(1, &colorBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		glGenFramebuffers(1, &FBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "ERROR::GOLDEN::FRAMEBUFFER_INCOMPLETE" << std::endl;
+		glCheckError();
+	}
+	~GoldenTarget()
+	{
+		glDeleteFramebuffers(1, &FBO);
+		glDeleteRenderbuffers(1, &colorBuffer);
+	}
+
+	GoldenTarget(const GoldenTarget&) = delete;
+	GoldenTarget& operator=(const GoldenTarget&) = delete;
+};
+
+void imageFromRgba(const unsigned char* rgba, int width, int height, GoldenImage& image)
+{
+	image.width = width;
+	image.height = height;
+	image.rgb.resize((std::size_t)width * height * 3);
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned char* src = &rgba[(std::size_t)(height - 1 - y) * width * 4];
+		unsigned char* dst = &image.rgb[(std::size_t)y * width * 3];
+		for (int x = 0; x < width; x++)
+		{
+			dst[x * 3 + 0] = src[x * 4 + 0];
+			dst[x * 3 + 1] = src[x * 4 + 1];
+			dst[x * 3 + 2] = src[x * 4 + 2];
+		}
+	}
+}
+
+static void readTarget(int width, int height, GoldenImage& image)
+{
+	std::vector<unsigned char> rgba((std::size_t)width * height * 4);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+	glCheckError();
+	imageFromRgba(rgba.data(), width, height, image);
+}
+
+static bool runScene(const GoldenScene& scene, const GoldenOptions& options)
+{
+	using clock = std::chrono::steady_clock;
+
+	// frame 0 pays for shader and pipeline compilation in the driver, it isn't timed
+	std::vector<double> frameMs;
+	GoldenImage actual;
+	for (int frame = 0; frame < scene.frames; frame++)
+	{
+		clock::time_point start = clock::now();
+		if (scene.renderImage)
+		{
+			scene.renderImage(frame / 60.0, actual);
+		}
+		else
+		{
+			scene.render(frame / 60.0);
+			glFinish();
+		}
+		clock::time_point end = clock::now();
+		if (frame > 0)
+			frameMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+
+	if (!scene.renderImage)
+	{
+		glCheckError();
+		readTarget(options.width, options.height, actual);
+	}
+
+	double medianMs = 0.0, p99Ms = 0.0;
+	if (!frameMs.empty())
+	{
+		std::sort(frameMs.begin(), frameMs.end());
+		medianMs = frameMs[frameMs.size() / 2];
+		p99Ms = frameMs[std::min(frameMs.size() - 1, (std::size_t)(frameMs.size() * 0.99))];
+	}
+	double budgetMs = scene.budgetMs * options.budgetScale;
+
+	std::string goldenPath = std::string(options.dir) + "/" + scene.name + ".ppm";
+	if (options.update)
+	{
+		bool written = writePpm(goldenPath, actual);
+		std::cout << "GOLDEN::" << scene.name << " result=" << (written ? "updated" : "error")
+			<< " median_ms=" << medianMs << " p99_ms=" << p99Ms << " budget_ms=" << budgetMs << std::endl;
+		return written;
+	}
+
+	GoldenImage expected;
+	if (!readPpm(goldenPath, expected))
+	{
+		std::cout << "ERROR::GOLDEN::MISSING " << goldenPath << " (run with --golden-update)" << std::endl;
+		writePpm(std::string(options.dir) + "/" + scene.name + ".actual.ppm", actual);
+		return false;
+	}
+
+	bool imagePassed = false;
+	ImageDiff diff;
+	if (expected.width != actual.width || expected.height != actual.height)
+	{
+		std::cout << "ERROR::GOLDEN::SIZE_MISMATCH " << scene.name << " golden " << expected.width << "x"
+			<< expected.height << ", rendered " << actual.width << "x" << actual.height << std::endl;
+		diff.differing = (std::size_t)actual.width * actual.height;
+	}
+	else
+	{
+		diff = compareImages(expected, actual, options.threshold);
+		imagePassed = diff.differing <= options.maxDiffFraction * actual.width * actual.height;
+	}
+	bool budgetPassed = medianMs <= budgetMs;
+
+	const char* result = imagePassed ? (budgetPassed ? "pass" : "over_budget") : "image_mismatch";
+	std::cout << "GOLDEN::" << scene.name << " result=" << result
+		<< " differing_px=" << diff.differing << " max_delta=" << diff.maxDelta
+		<< " median_ms=" << medianMs << " p99_ms=" << p99Ms << " budget_ms=" << budgetMs << std::endl;
+
+	if (!imagePassed)
+	{
+		writePpm(std::string(options.dir) + "/" + scene.name + ".actual.ppm", actual);
+		if (!diff.diff.rgb.empty())
+			writePpm(std::string(options.dir) + "/" + scene.name + ".diff.ppm", diff.diff);
+	}
+	return imagePassed && budgetPassed;
+}
+
+bool runGoldenTests(ContextProvider& context, const std::vector<GoldenScene>& scenes, const GoldenOptions& options)
+{
+	int failed = 0;
+	{
+		GoldenTarget target(options.width, options.height);
+		for (const GoldenScene& scene : scenes)
+		{
+			// scenes may leave anything bound, every one starts from the same state
+			glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+			glViewport(0, 0, options.width, options.height);
+			if (!runScene(scene, options))
+				failed++;
+			context.pollEvents();
+		}
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, context.getFramebuffer());
+	glViewport(0, 0, context.getWidth(), context.getHeight());
+	invalidateBindings();
+
+	std::cout << "GOLDEN::summary scenes=" << scenes.size() << " failed=" << failed << std::endl;
+	return failed == 0;
+}
+
+bool runGoldenTests(const std::vector<GoldenScene>& scenes, const GoldenOptions& options)
+{
+	int failed = 0;
+	for (const GoldenScene& scene : scenes)
+	{
+		if (!scene.renderImage)
+		{
+			std::cout << "ERROR::GOLDEN::NEEDS_CONTEXT " << scene.name << std::endl;
+			failed++;
+		}
+		else if (!runScene(scene, options))
+		{
+			failed++;
+		}
+	}
+
+	std::cout << "GOLDEN::summary scenes=" << scenes.size() << " failed=" << failed << std::endl;
+	return failed == 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Context.h"
+
+// Golden image tests
+// ------------------
+/// \note: every scene is rendered offscreen into a width x height FBO for a fixed number of
+///		   frames, with time = frame / 60 instead of the wall clock, so a scene always ends on
+///		   the same image however fast the machine is. The last frame is compared against
+///		   <dir>/<scene>.ppm and the median frame time (render + glFinish) against the
+///		   scene's budget.
+///		   The comparison is perceptual rather than exact: a pixel only counts as different
+///		   when its YIQ distance (luma weighted, as in pixelmatch) is above threshold, and the
+///		   image only fails when more than maxDiffFraction of the pixels differ. That absorbs
+///		   rounding and rasterization differences between drivers but not a wrong color or a
+///		   moved edge. On failure <scene>.actual.ppm and <scene>.diff.ppm are written next to
+///		   the golden.
+///		   Scenes that set renderImage instead of render draw without GL (the software
+///		   rasterizer) and are compared against the same goldens; those run without a
+///		   context, through the overload below.
+///
+///		   --golden --headless [--golden-dir goldens] [--golden-update] [--golden-threshold 0.1]
+///		   [--golden-max-diff 0.001] [--golden-budget-scale 2]
+struct GoldenOptions
+{
+	const char* dir{ "goldens" };
+	bool update{ false };			// (re)writes the goldens instead of comparing
+	int width{ 160 };
+	int height{ 120 };
+	float threshold{ 0.1f };		// 0..1, fraction of the largest possible YIQ distance
+	float maxDiffFraction{ 0.001f };
+	double budgetScale{ 1.0 };		// slower CI machines scale every budget instead of editing them
+};
+
+// reads --golden-dir, --golden-update, --golden-threshold, --golden-max-diff and --golden-budget-scale
+GoldenOptions parseGoldenOptions(int argc, char* argv[], GoldenOptions options);
+
+struct GoldenImage;
+
+struct GoldenScene
+{
+	std::string name;
+	int frames{ 60 };
+	double budgetMs{ 1.0 };
+	// draws one frame into the bound framebuffer (viewport already set), time in seconds
+	std::function<void(double time)> render;
+	// or fills a width x height image itself, the frame time is the call
+	std::function<void(double time, GoldenImage& image)> renderImage;
+};
+
+// runs every scene, prints a GOLDEN:: line for each, returns false if any failed
+bool runGoldenTests(ContextProvider& context, const std::vector<GoldenScene>& scenes, const GoldenOptions& options);
+// only renderImage scenes, no context needed
+bool runGoldenTests(const std::vector<GoldenScene>& scenes, const GoldenOptions& options);
+
+// Images
+// ------
+// 8 bit RGB, top row first, the layout of a binary PPM
+struct GoldenImage
+{
+	int width{ 0 };
+	int height{ 0 };
+	std::vector<unsigned char> rgb;
+};
+
+// from RGBA, bottom row first (glReadPixels)
+void imageFromRgba(const unsigned char* rgba, int width, int height, GoldenImage& image);
+
+bool readPpm(const std::string& path, GoldenImage& image);
+bool writePpm(const std::string& path, const GoldenImage& image);
+
+struct ImageDiff
+{
+	std::size_t differing{ 0 };
+	float maxDelta{ 0.0f };		// 0..1
+	GoldenImage diff;			// differing pixels in red over a faded copy of the expected image
+};
+
+// images have to be the same size
+ImageDiff compareImages(const GoldenImage& expected, const GoldenImage& actual, float threshold);
@@ -0,0 +1,294 @@
+#include "HeadlessContext.h"
+#include "GLExtensions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if HEADLESS_EGL
+	#include <EGL/egl.h>
+	#include <EGL/eglext.h>
+#elif HEADLESS_OSMESA
+	#include <GL/osmesa.h>
+#endif
+
+// EGL extension names are one space separated string
+static bool hasToken(const char* list, const char* name)
+{
+	if (list == NULL)
+		return false;
+	std::istringstream tokens(list);
+	std::string token;
+	while (tokens >> token)
+	{
+		if (token == name)
+			return true;
+	}
+	return false;
+}
+
+// Platforms
+// ---------
+#if HEADLESS_EGL
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+	#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#ifndef EGL_CONTEXT_OPENGL_NO_ERROR_KHR
+	#define EGL_CONTEXT_OPENGL_NO_ERROR_KHR 0x31B3
+#endif
+
+struct HeadlessContext::Platform
+{
+	EGLDisplay display{ EGL_NO_DISPLAY };
+	EGLContext context{ EGL_NO_CONTEXT };
+	EGLSurface surface{ EGL_NO_SURFACE };
+};
+
+static EGLDisplay getHeadlessDisplay()
+{
+	if (hasToken(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), "EGL_MESA_platform_surfaceless"))
+	{
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+			(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (getPlatformDisplay != NULL)
+		{
+			EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+			if (display != EGL_NO_DISPLAY)
+				return display;
+		}
+	}
+	return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+bool HeadlessContext::createPlatform(const ContextOptions& options)
+{
+	platform->display = getHeadlessDisplay();
+	EGLint major, minor;
+	if (platform->display == EGL_NO_DISPLAY || !eglInitialize(platform->display, &major, &minor))
+	{
+		std::cout << "ERROR::CONTEXT::EGL_NO_DISPLAY" << std::endl;
+		return false;
+	}
+	const char* extensions = eglQueryString(platform->display, EGL_EXTENSIONS);
+	bool surfaceless = hasToken(extensions, "EGL_KHR_surfaceless_context");
+
+	// the scene draws into our own FBO, the config's buffers are never used
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglChooseConfig(platform->display, configAttributes, &config, 1, &configCount) || configCount == 0)
+	{
+		std::cout << "ERROR::CONTEXT::EGL_NO_CONFIG" << std::endl;
+		return false;
+	}
+
+	eglBindAPI(EGL_OPENGL_API);
+	bool noError = options.noError && hasToken(extensions, "EGL_KHR_create_context_no_error");
+	EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		noError ? EGL_CONTEXT_OPENGL_NO_ERROR_KHR : EGL_NONE, EGL_TRUE,
+		EGL_NONE
+	};
+	platform->context = eglCreateContext(platform->display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (platform->context == EGL_NO_CONTEXT && noError)
+	{
+		std::cout << "WARNING::CONTEXT::NO_ERROR_UNSUPPORTED: falling back to a validating context" << std::endl;
+		contextAttributes[6] = EGL_NONE;	// drop the no error pair
+		platform->context = eglCreateContext(platform->display, config, EGL_NO_CONTEXT, contextAttributes);
+	}
+	if (platform->context == EGL_NO_CONTEXT)
+	{
+		std::cout << "ERROR::CONTEXT::EGL_CREATE_CONTEXT 0x" << std::hex << eglGetError() << std::dec << std::endl;
+		return false;
+	}
+
+	if (!surfaceless)
+	{
+		const EGLint pbufferAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+		platform->surface = eglCreatePbufferSurface(platform->display, config, pbufferAttributes);
+		if (platform->surface == EGL_NO_SURFACE)
+		{
+			std::cout << "ERROR::CONTEXT::EGL_NO_PBUFFER" << std::endl;
+			return false;
+		}
+	}
+	if (!eglMakeCurrent(platform->display, platform->surface, platform->surface, platform->context))
+	{
+		std::cout << "ERROR::CONTEXT::EGL_MAKE_CURRENT" << std::endl;
+		return false;
+	}
+
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+	{
+		std::cout << "Failed to load GLAD!" << std::endl;
+		return false;
+	}
+	loadGLExtensions((GLADloadproc)eglGetProcAddress);
+	return true;
+}
+
+void HeadlessContext::destroyPlatform()
+{
+	if (platform->display == EGL_NO_DISPLAY)
+		return;
+	eglMakeCurrent(platform->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (platform->surface != EGL_NO_SURFACE)
+		eglDestroySurface(platform->display, platform->surface);
+	if (platform->context != EGL_NO_CONTEXT)
+		eglDestroyContext(platform->display, platform->context);
+	eglTerminate(platform->display);
+}
+
+#elif HEADLESS_OSMESA
+
+struct HeadlessContext::Platform
+{
+	OSMesaContext context{ NULL };
+	std::vector<unsigned char> buffer;	// OSMesa wants a color buffer even though the FBO is used
+};
+
+bool HeadlessContext::createPlatform(const ContextOptions& options)
+{
+	const int attributes[] = {
+		OSMESA_FORMAT, OSMESA_RGBA,
+		OSMESA_DEPTH_BITS, 0,
+		OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+		OSMESA_CONTEXT_MAJOR_VERSION, 3,
+		OSMESA_CONTEXT_MINOR_VERSION, 3,
+		0
+	};
+	platform->context = OSMesaCreateContextAttribs(attributes, NULL);
+	if (platform->context == NULL)
+	{
+		std::cout << "ERROR::CONTEXT::OSMESA_CREATE_CONTEXT" << std::endl;
+		return false;
+	}
+	platform->buffer.resize((std::size_t)options.width * options.height * 4);
+	if (!OSMesaMakeCurrent(platform->context, platform->buffer.data(), GL_UNSIGNED_BYTE, options.width, options.height))
+	{
+		std::cout << "ERROR::CONTEXT::OSMESA_MAKE_CURRENT" << std::endl;
+		return false;
+	}
+
+	if (!gladLoadGLLoader((GLADloadproc)OSMesaGetProcAddress))
+	{
+		std::cout << "Failed to load GLAD!" << std::endl;
+		return false;
+	}
+	loadGLExtensions((GLADloadproc)OSMesaGetProcAddress);
+	return true;
+}
+
+void HeadlessContext::destroyPlatform()
+{
+	if (platform->context != NULL)
+		OSMesaDestroyContext(platform->context);
+}
+
+#else
+
+struct HeadlessContext::Platform
+{
+};
+
+bool HeadlessContext::createPlatform(const ContextOptions&)
+{
+	std::cout << "ERROR::CONTEXT::HEADLESS_UNAVAILABLE: build with HEADLESS_EGL=1 or HEADLESS_OSMESA=1" << std::endl;
+	return false;
+}
+
+void HeadlessContext::destroyPlatform()
+{
+}
+
+#endif
+
+// Headless context
+// ----------------
+HeadlessContext::HeadlessContext()
+	: platform(new Platform()), FBO(0), colorBuffer(0), depthBuffer(0), width(0), height(0), frameLimit(0), frame(0)
+{
+}
+
+HeadlessContext::~HeadlessContext()
+{
+	if (FBO != 0)
+	{
+		glDeleteFramebuffers(1, &FBO);
+		glDeleteRenderbuffers(1, &colorBuffer);
+		glDeleteRenderbuffers(1, &depthBuffer);
+	}
+	destroyPlatform();
+	delete platform;
+}
+
+bool HeadlessContext::create(const ContextOptions& options)
+{
+	width = options.width;
+	height = options.height;
+	frameLimit = options.frames;
+	if (!createPlatform(options))
+		return false;
+
+	glGenRenderbuffers(1, &colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glGenRenderbuffers(1, &depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	// stays bound, the scene renders into it like it would into the window
+	glGenFramebuffers(1, &FBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "ERROR::CONTEXT::HEADLESS_FRAMEBUFFER_INCOMPLETE" << std::endl;
+		return false;
+	}
+	glViewport(0, 0, width, height);
+	glCheckError();
+
+	std::cout << "Context: OpenGL " << glGetString(GL_VERSION) << " on " << glGetString(GL_RENDERER)
+		<< " (headless " << width << "x" << height << (isNoErrorContext() ? ", no error" : "") << ")" << std::endl;
+	return true;
+}
+
+void HeadlessContext::swapBuffers()
+{
+	// nothing is presented, but the frame's commands should be on their way like after a swap
+	glFlush();
+	frame++;
+}
+
+void HeadlessContext::waitEvents(double timeout)
+{
+	double seconds = std::min(timeout, 1.0 / getRefreshRate());
+	if (seconds > 0.0)
+		std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+	frame++;
+}
+
+ContextProvider* createHeadlessContext(const ContextOptions& options)
+{
+	HeadlessContext* context = new HeadlessContext();
+	if (!context->create(options))
+	{
+		delete context;
+		return NULL;
+	}
+	return context;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "Context.h"
+
+// Headless context
+// ----------------
+/// \note: a context without a window or display server, for CI and build machines without
+///		   a GPU. Pick the platform at build time:
+///			HEADLESS_EGL=1     EGL (link libEGL). Asks for MESA_platform_surfaceless first,
+///			                   then the default display, and a surfaceless context or a
+///			                   1x1 pbuffer. On Mesa without a GPU this is llvmpipe.
+///			HEADLESS_OSMESA=1  OSMesa (link libOSMesa), software only.
+///		   Without either createHeadlessContext() reports it and returns NULL.
+///		   The scene renders into a width x height FBO, swapBuffers() just flushes and counts
+///		   frames, and shouldClose() turns true after options.frames frames. An idle
+///		   waitEvents() counts as a frame too, up to one refresh is slept per call.
+#ifndef HEADLESS_EGL
+	#define HEADLESS_EGL 0
+#endif
+#ifndef HEADLESS_OSMESA
+	#define HEADLESS_OSMESA 0
+#endif
+
+class HeadlessContext : public ContextProvider
+{
+	// EGL / OSMesa handles, kept out of the header
+	struct Platform;
+	Platform* platform;
+
+	unsigned int FBO, colorBuffer, depthBuffer;
+	int width, height;
+	int frameLimit;
+	int frame;
+
+	HeadlessContext();
+	bool create(const ContextOptions& options);
+	bool createPlatform(const ContextOptions& options);
+	void destroyPlatform();
+
+public:
+	~HeadlessContext();
+
+	HeadlessContext(const HeadlessContext&) = delete;
+	HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+	bool shouldClose() const override { return frame >= frameLimit; }
+	void pollEvents() override {}
+	// nothing can arrive, so this sleeps and counts an idle frame, time moves on either way
+	void waitEvents(double timeout) override;
+	void swapBuffers() override;
+
+	bool setSwapInterval(int) override { return false; }
+	bool supportsAdaptiveSync() const override { return false; }
+	double getRefreshRate() const override { return 60.0; }
+	// frame / 60, the same frames give the same images however fast they render
+	double getTime() const override { return frame / getRefreshRate(); }
+
+	int getWidth() const override { return width; }
+	int getHeight() const override { return height; }
+	unsigned int getFramebuffer() const override { return FBO; }
+
+	int getFrame() const { return frame; }
+
+	friend ContextProvider* createHeadlessContext(const ContextOptions& options);
+};
+
+// NULL if no headless platform was built in or the context can't be created
+ContextProvider* createHeadlessContext(const ContextOptions& options);
@@ -0,0 +1,234 @@
+#include "InputQueue.h"
+
+// Callbacks
+// ---------
+static InputQueue* activeQueue = NULL;
+static GLFWkeyfun previousKey = NULL;
+static GLFWmousebuttonfun previousMouseButton = NULL;
+static GLFWcursorposfun previousCursor = NULL;
+static GLFWscrollfun previousScroll = NULL;
+
+static void pushEvent(InputEventType type, int code, int action, int mods, double x, double y)
+{
+	if (activeQueue == NULL)
+		return;
+	InputEvent event{ type, code, action, mods, x, y, glfwGetTime() };
+	activeQueue->push(event);
+}
+
+static void inputKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	if (previousKey != NULL)
+		previousKey(window, key, scancode, action, mods);
+	pushEvent(InputEventType::Key, key, action, mods, 0.0, 0.0);
+}
+
+static void inputMouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+{
+	if (previousMouseButton != NULL)
+		previousMouseButton(window, button, action, mods);
+	pushEvent(InputEventType::MouseButton, button, action, mods, 0.0, 0.0);
+}
+
+static void inputCursorCallback(GLFWwindow* window, double x, double y)
+{
+	if (previousCursor != NULL)
+		previousCursor(window, x, y);
+	pushEvent(InputEventType::Cursor, 0, 0, 0, x, y);
+}
+
+static void inputScrollCallback(GLFWwindow* window, double x, double y)
+{
+	if (previousScroll != NULL)
+		previousScroll(window, x, y);
+	pushEvent(InputEventType::Scroll, 0, 0, 0, x, y);
+}
+
+// Input queue
+// -----------
+InputQueue::InputQueue(GLFWwindow* window)
+	: window(window)
+{
+	if (window == NULL)
+		return;
+	activeQueue = this;
+	previousKey = glfwSetKeyCallback(window, inputKeyCallback);
+	previousMouseButton = glfwSetMouseButtonCallback(window, inputMouseButtonCallback);
+	previousCursor = glfwSetCursorPosCallback(window, inputCursorCallback);
+	previousScroll = glfwSetScrollCallback(window, inputScrollCallback);
+}
+
+InputQueue::~InputQueue()
+{
+	if (window == NULL || activeQueue != this)
+		return;
+	glfwSetKeyCallback(window, previousKey);
+	glfwSetMouseButtonCallback(window, previousMouseButton);
+	glfwSetCursorPosCallback(window, previousCursor);
+	glfwSetScrollCallback(window, previousScroll);
+	activeQueue = NULL;
+}
+
+bool InputQueue::push(const InputEvent& event)
+{
+	if (events.push(event))
+		return true;
+	dropped.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+// Input mapper
+// ------------
+InputMapper::InputMapper()
+	: hasCursor(false), cursorX(0.0), cursorY(0.0)
+{
+}
+
+int InputMapper::findAction(const char* name) const
+{
+	for (std::size_t i = 0; i < actions.size(); i++)
+	{
+		if (actions[i].name == name)
+			return (int)i;
+	}
+	return -1;
+}
+
+int InputMapper::findAxis(const char* name) const
+{
+	for (std::size_t i = 0; i < axes.size(); i++)
+	{
+		if (axes[i].name == name)
+			return (int)i;
+	}
+	return -1;
+}
+
+int InputMapper::bindAction(const char* name, InputEventType type, int code)
+{
+	int action = findAction(name);
+	if (action < 0)
+	{
+		actions.push_back(Action{ name, {}, 0, false, false });
+		action = (int)actions.size() - 1;
+	}
+	// bound twice, one press would count twice in held and the action would stay down
+	for (const Binding& binding : actions[action].bindings)
+	{
+		if (binding.type == type && binding.code == code)
+			return action;
+	}
+	actions[action].bindings.push_back(Binding{ type, code });
+	return action;
+}
+
+int InputMapper::bindAxis(const char* name, int positiveKey, int negativeKey, float scale)
+{
+	axes.push_back(Axis{ name, InputEventType::Key, positiveKey, negativeKey, scale, false, false, 0.0f });
+	return (int)axes.size() - 1;
+}
+
+int InputMapper::bindAxis(const char* name, InputEventType type, int component, float scale)
+{
+	axes.push_back(Axis{ name, type, component, -1, scale, false, false, 0.0f });
+	return (int)axes.size() - 1;
+}
+
+float InputMapper::getAxis(int axis) const
+{
+	const Axis& a = axes[axis];
+	if (a.type != InputEventType::Key)
+		return a.delta * a.scale;
+	return ((a.positiveHeld ? 1.0f : 0.0f) - (a.negativeHeld ? 1.0f : 0.0f)) * a.scale;
+}
+
+void InputMapper::update(InputQueue& queue, double until)
+{
+	for (Action& action : actions)
+	{
+		action.pressed = false;
+		action.released = false;
+	}
+	for (Axis& axis : axes)
+	{
+		axis.delta = 0.0f;
+	}
+	actionEvents.clear();
+
+	for (const InputEvent* event = queue.peek(); event != NULL && event->time <= until; event = queue.peek())
+	{
+		InputEvent current;
+		queue.pop(current);
+		apply(current);
+	}
+}
+
+void InputMapper::apply(const InputEvent& event)
+{
+	// repeats are the OS auto repeat of a held key, not new presses
+	bool digital = event.type == InputEventType::Key || event.type == InputEventType::MouseButton;
+	if (digital && event.action == GLFW_REPEAT)
+		return;
+	bool down = event.action == GLFW_PRESS;
+
+	if (digital)
+	{
+		for (std::size_t i = 0; i < actions.size(); i++)
+		{
+			Action& action = actions[i];
+			for (const Binding& binding : action.bindings)
+			{
+				if (binding.type != event.type || binding.code != event.code)
+					continue;
+
+				int wasHeld = action.held;
+				action.held += down ? 1 : (action.held > 0 ? -1 : 0);
+				// a second bound key going down doesn't press the action again
+				if (wasHeld == 0 && action.held > 0)
+				{
+					action.pressed = true;
+					actionEvents.push_back(ActionEvent{ (int)i, true, event.time });
+				}
+				else if (wasHeld > 0 && action.held == 0)
+				{
+					action.released = true;
+					actionEvents.push_back(ActionEvent{ (int)i, false, event.time });
+				}
+			}
+		}
+	}
+
+	double cursorDeltaX = 0.0, cursorDeltaY = 0.0;
+	if (event.type == InputEventType::Cursor)
+	{
+		// the first position has nothing to be relative to
+		if (hasCursor)
+		{
+			cursorDeltaX = event.x - cursorX;
+			cursorDeltaY = event.y - cursorY;
+		}
+		hasCursor = true;
+		cursorX = event.x;
+		cursorY = event.y;
+	}
+
+	for (Axis& axis : axes)
+	{
+		if (axis.type == InputEventType::Key)
+		{
+			if (event.type != InputEventType::Key)
+				continue;
+			if (event.code == axis.positive)
+				axis.positiveHeld = down;
+			if (event.code == axis.negative)
+				axis.negativeHeld = down;
+		}
+		else if (axis.type == event.type)
+		{
+			if (event.type == InputEventType::Scroll)
+				axis.delta += (float)(axis.positive == 0 ? event.x : event.y);
+			else
+				axis.delta += (float)(axis.positive == 0 ? cursorDeltaX : cursorDeltaY);
+		}
+	}
+}
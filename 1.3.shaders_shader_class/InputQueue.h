@@ -0,0 +1,198 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+// Input events
+// ------------
+/// \note: key / mouseButton carry the GLFW key or button in code and GLFW_PRESS /
+///		   GLFW_RELEASE / GLFW_REPEAT in action. cursor is the position in screen
+///		   coordinates, scroll the offset, both in x, y. time is glfwGetTime() when the
+///		   callback ran, i.e. when the event was taken from the OS queue.
+enum class InputEventType
+{
+	Key,
+	MouseButton,
+	Cursor,
+	Scroll
+};
+
+struct InputEvent
+{
+	InputEventType type;
+	int code;
+	int action;
+	int mods;
+	double x, y;
+	double time;
+};
+
+// Single producer single consumer queue
+// -------------------------------------
+/// \note: a fixed ring of Capacity - 1 usable slots (Capacity a power of two), no locks and
+///		   no allocation after construction. One thread may push and one other thread may
+///		   pop; head and tail live on their own cache lines so the two don't false share.
+///		   push() fails instead of blocking when the consumer has fallen behind.
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+	alignas(64) std::atomic<std::size_t> head{ 0 };	// next slot to pop, written by the consumer
+	alignas(64) std::atomic<std::size_t> tail{ 0 };	// next slot to push, written by the producer
+	alignas(64) T slots[Capacity];
+
+public:
+	bool push(const T& value)
+	{
+		std::size_t current = tail.load(std::memory_order_relaxed);
+		std::size_t next = (current + 1) & (Capacity - 1);
+		if (next == head.load(std::memory_order_acquire))
+			return false;
+		slots[current] = value;
+		tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	// the oldest element without removing it, NULL when empty. consumer only
+	const T* peek() const
+	{
+		std::size_t current = head.load(std::memory_order_relaxed);
+		if (current == tail.load(std::memory_order_acquire))
+			return NULL;
+		return &slots[current];
+	}
+
+	bool pop(T& value)
+	{
+		const T* front = peek();
+		if (front == NULL)
+			return false;
+		value = *front;
+		head.store((head.load(std::memory_order_relaxed) + 1) & (Capacity - 1), std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+};
+
+// Input queue
+// -----------
+/// \note: GLFW key, mouse button, cursor and scroll callbacks push timestamped events here,
+///		   so nothing between two polls is lost to a per-frame glfwGetKey snapshot and the
+///		   consumer (the simulation, possibly on its own thread) sees every press with the
+///		   time it happened. The producer is whichever thread calls pollEvents / waitEvents.
+///		   Callbacks installed before are kept and called first. One queue per process;
+///		   with a NULL window (headless) nothing is installed and push() can feed it instead.
+class InputQueue
+{
+public:
+	static const std::size_t CAPACITY = 1024;
+
+private:
+	SpscQueue<InputEvent, CAPACITY> events;
+	std::atomic<unsigned long long> dropped{ 0 };
+	GLFWwindow* window;
+
+public:
+	InputQueue(GLFWwindow* window);
+	~InputQueue();
+
+	InputQueue(const InputQueue&) = delete;
+	InputQueue& operator=(const InputQueue&) = delete;
+
+	// producer side. false (and counted as dropped) when the queue is full
+	bool push(const InputEvent& event);
+
+	// consumer side
+	const InputEvent* peek() const { return events.peek(); }
+	bool pop(InputEvent& event) { return events.pop(event); }
+
+	unsigned long long getDropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+// Input mapper
+// ------------
+/// \note: turns raw events into named actions (digital, from keys or mouse buttons) and
+///		   axes (analog, from a key pair, scroll or cursor movement), so the simulation
+///		   reacts to "quit" rather than GLFW_KEY_ESCAPE and bindings can change in one place.
+///		   update() consumes the events up to a time, e.g. the end of a simulation step,
+///		   and leaves later ones queued for the next step.
+///
+///		   InputMapper mapper;
+///		   int quit = mapper.bindAction("quit", InputEventType::Key, GLFW_KEY_ESCAPE);
+///		   int zoom = mapper.bindAxis("zoom", InputEventType::Scroll, 1, 1.0f);
+///		   ...
+///		   mapper.update(queue, context->getTime());
+///		   if (mapper.wasPressed(quit)) ...
+///
+///		   Bind everything before the first update(), handles are indices.
+struct ActionEvent
+{
+	int action;
+	bool pressed;
+	double time;
+};
+
+class InputMapper
+{
+	struct Binding
+	{
+		InputEventType type;
+		int code;
+	};
+
+	struct Action
+	{
+		std::string name;
+		std::vector<Binding> bindings;
+		int held;			// bound keys / buttons currently down
+		bool pressed;		// went down during the last update()
+		bool released;
+	};
+
+	struct Axis
+	{
+		std::string name;
+		InputEventType type;
+		int positive, negative;	// keys for Key axes, 0 = x / 1 = y for Scroll and Cursor
+		float scale;
+		bool positiveHeld, negativeHeld;
+		float delta;			// Scroll / Cursor, accumulated over the last update()
+	};
+
+	std::vector<Action> actions;
+	std::vector<Axis> axes;
+	std::vector<ActionEvent> actionEvents;
+	bool hasCursor;
+	double cursorX, cursorY;
+
+public:
+	InputMapper();
+
+	// adds a binding to the action, creating it on first use (a binding it already has is
+	// ignored). returns its handle
+	int bindAction(const char* name, InputEventType type, int code);
+	// +scale while positive is held, -scale while negative is, 0 for both or neither
+	int bindAxis(const char* name, int positiveKey, int negativeKey, float scale = 1.0f);
+	// scroll offset or cursor movement along component (0 = x, 1 = y) per update, times scale
+	int bindAxis(const char* name, InputEventType type, int component, float scale = 1.0f);
+
+	int findAction(const char* name) const;
+	int findAxis(const char* name) const;
+
+	// pops and applies every event with time <= until
+	void update(InputQueue& queue, double until);
+
+	bool isDown(int action) const { return actions[action].held > 0; }
+	bool wasPressed(int action) const { return actions[action].pressed; }
+	bool wasReleased(int action) const { return actions[action].released; }
+	float getAxis(int axis) const;
+	// every press / release of the last update(), in order, with the event time
+	const std::vector<ActionEvent>& getActionEvents() const { return actionEvents; }
+
+private:
+	void apply(const InputEvent& event);
+};
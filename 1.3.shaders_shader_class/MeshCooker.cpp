@@ -0,0 +1,179 @@
+#include "MeshCooker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+unsigned short quantizeUNorm16(float value)
+{
+	value = std::min(std::max(value, 0.0f), 1.0f);
+	return (unsigned short)(value * 65535.0f + 0.5f);
+}
+
+unsigned char quantizeUNorm8(float value)
+{
+	value = std::min(std::max(value, 0.0f), 1.0f);
+	return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+static unsigned int quantizeSNorm(float value, float maxValue, unsigned int mask)
+{
+	value = std::min(std::max(value, -1.0f), 1.0f);
+	return (unsigned int)(int)std::lround(value * maxValue) & mask;
+}
+
+int packSNorm10_10_10_2(float x, float y, float z, float w)
+{
+	// GL_INT_2_10_10_10_REV: x in the low bits, w in the top two
+	unsigned int packed = quantizeSNorm(x, 511.0f, 0x3FF)
+		| quantizeSNorm(y, 511.0f, 0x3FF) << 10
+		| quantizeSNorm(z, 511.0f, 0x3FF) << 20
+		| quantizeSNorm(w, 1.0f, 0x3) << 30;
+	return (int)packed;
+}
+
+unsigned short floatToHalf(float value)
+{
+	unsigned int bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	unsigned int sign = (bits >> 16) & 0x8000;
+	unsigned int mantissa = bits & 0x7FFFFF;
+	int exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+
+	if (((bits >> 23) & 0xFF) == 0xFF)
+		return (unsigned short)(sign | 0x7C00 | (mantissa ? 0x200 : 0));	// inf / nan
+	if (exponent >= 31)
+		return (unsigned short)(sign | 0x7C00);	// too big, inf
+
+	unsigned int half, remainder, halfway;
+	if (exponent <= 0)
+	{
+		// subnormal half, or flushes to zero
+		if (exponent < -10)
+			return (unsigned short)sign;
+		mantissa |= 0x800000;
+		unsigned int shift = (unsigned int)(14 - exponent);
+		half = mantissa >> shift;
+		remainder = mantissa & ((1u << shift) - 1);
+		halfway = 1u << (shift - 1);
+	}
+	else
+	{
+		half = ((unsigned int)exponent << 10) | (mantissa >> 13);
+		remainder = mantissa & 0x1FFF;
+		halfway = 0x1000;
+	}
+
+	// round to nearest even, a carry out of the mantissa bumps the exponent as it should
+	if (remainder > halfway || (remainder == halfway && (half & 1)))
+		half++;
+	return (unsigned short)(sign | half);
+}
+
+// Position quantization
+// ---------------------
+struct PositionQuantizer
+{
+	float scale[3];
+	float bias[3];
+
+	PositionQuantizer(const float* positions, std::size_t vertexCount, std::size_t floatStride)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float minValue = vertexCount > 0 ? positions[axis] : 0.0f;
+			float maxValue = minValue;
+			for (std::size_t i = 1; i < vertexCount; i++)
+			{
+				float value = positions[i * floatStride + axis];
+				minValue = std::min(minValue, value);
+				maxValue = std::max(maxValue, value);
+			}
+			bias[axis] = minValue;
+			scale[axis] = maxValue - minValue;
+		}
+	}
+
+	void quantize(const float* position, unsigned short* out, float& maxError) const
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float normalized = scale[axis] > 0.0f ? (position[axis] - bias[axis]) / scale[axis] : 0.0f;
+			out[axis] = quantizeUNorm16(normalized);
+
+			float decoded = out[axis] / 65535.0f * scale[axis] + bias[axis];
+			maxError = std::max(maxError, std::fabs(decoded - position[axis]));
+		}
+		out[3] = 0;
+	}
+};
+
+template <typename Vertex>
+static void finishReport(CookedMesh<Vertex>& mesh, const PositionQuantizer& quantizer, std::size_t vertexCount, std::size_t sourceVertexSize)
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		mesh.positionScale[axis] = quantizer.scale[axis];
+		mesh.positionBias[axis] = quantizer.bias[axis];
+	}
+	mesh.report.vertexCount = vertexCount;
+	mesh.report.sourceBytes = vertexCount * sourceVertexSize;
+	mesh.report.cookedBytes = vertexCount * sizeof(Vertex);
+}
+
+CookedMesh<CookedVertex> cookMesh(const SourceVertex* vertices, std::size_t vertexCount)
+{
+	CookedMesh<CookedVertex> mesh;
+	PositionQuantizer quantizer(vertices[0].position, vertexCount, sizeof(SourceVertex) / sizeof(float));
+
+	mesh.vertices.resize(vertexCount);
+	for (std::size_t i = 0; i < vertexCount; i++)
+	{
+		const SourceVertex& in = vertices[i];
+		CookedVertex& out = mesh.vertices[i];
+
+		quantizer.quantize(in.position, out.position, mesh.report.maxPositionError);
+		out.normal = packSNorm10_10_10_2(in.normal[0], in.normal[1], in.normal[2], 0.0f);
+		out.tangent = packSNorm10_10_10_2(in.tangent[0], in.tangent[1], in.tangent[2], in.tangent[3] < 0.0f ? -1.0f : 1.0f);
+		out.uv[0] = floatToHalf(in.uv[0]);
+		out.uv[1] = floatToHalf(in.uv[1]);
+		for (int c = 0; c < 4; c++)
+			out.color[c] = quantizeUNorm8(in.color[c]);
+	}
+
+	finishReport(mesh, quantizer, vertexCount, sizeof(SourceVertex));
+	return mesh;
+}
+
+CookedMesh<CookedColorVertex> cookColorMesh(const float* positionColors, std::size_t vertexCount)
+{
+	CookedMesh<CookedColorVertex> mesh;
+	PositionQuantizer quantizer(positionColors, vertexCount, 6);
+
+	mesh.vertices.resize(vertexCount);
+	for (std::size_t i = 0; i < vertexCount; i++)
+	{
+		const float* in = positionColors + i * 6;
+		CookedColorVertex& out = mesh.vertices[i];
+
+		quantizer.quantize(in, out.position, mesh.report.maxPositionError);
+		for (int c = 0; c < 3; c++)
+			out.color[c] = quantizeUNorm8(in[3 + c]);
+		out.color[3] = 255;
+	}
+
+	finishReport(mesh, quantizer, vertexCount, 6 * sizeof(float));
+	return mesh;
+}
+
+void CookingReport::print(const char* name) const
+{
+	double saved = sourceBytes > 0 ? 100.0 * (1.0 - (double)cookedBytes / sourceBytes) : 0.0;
+	std::cout << "MESH_COOKER::" << name << ": " << vertexCount << " vertices, "
+		<< sourceBytes << " -> " << cookedBytes << " bytes ("
+		<< (vertexCount > 0 ? sourceBytes / vertexCount : 0) << " -> "
+		<< (vertexCount > 0 ? cookedBytes / vertexCount : 0) << " per vertex, "
+		<< saved << "% less memory and vertex fetch), max position error " << maxPositionError << std::endl;
+}
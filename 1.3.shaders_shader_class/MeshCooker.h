@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "VertexFormat.h"
+
+// Mesh cooking
+// ------------
+/// \note: offline step that shrinks float vertices before they go to the GPU, vertex fetch
+///		   bandwidth scales with bytes per vertex so this pays off on every draw.
+///		    - positions: 16 bit unorm in the mesh bounding box, the shader undoes it with
+///		      uPositionScale / uPositionBias (max error is extent / 65535 per axis)
+///		    - normals, tangents: INT_2_10_10_10_REV, normalized so no shader change needed
+///		    - uvs: half floats
+///		    - colors: RGBA8
+
+// full float input vertex, unused attributes can stay zero
+struct SourceVertex
+{
+	float position[3];
+	float normal[3];
+	float tangent[4];	// w is the bitangent sign
+	float uv[2];
+	float color[4];
+};
+
+// 24 bytes instead of 64
+struct CookedVertex
+{
+	unsigned short position[4];	// w unused, keeps 4 byte alignment
+	int normal;
+	int tangent;
+	unsigned short uv[2];
+	unsigned char color[4];
+	typedef VertexFormat<attrib::UNorm16<4>, attrib::SNorm10_10_10_2, attrib::SNorm10_10_10_2,
+		attrib::Half<2>, attrib::UNorm8<4>> Format;
+};
+VERTEX_FORMAT_CHECK(CookedVertex);
+
+// position + color only, like the 1.3 samples. 12 bytes instead of 24
+struct CookedColorVertex
+{
+	unsigned short position[4];
+	unsigned char color[4];
+	typedef VertexFormat<attrib::UNorm16<4>, attrib::UNorm8<4>> Format;
+};
+VERTEX_FORMAT_CHECK(CookedColorVertex);
+
+struct CookingReport
+{
+	std::size_t vertexCount{ 0 };
+	std::size_t sourceBytes{ 0 };
+	std::size_t cookedBytes{ 0 };
+	float maxPositionError{ 0.0f };
+
+	void print(const char* name) const;
+};
+
+template <typename Vertex>
+struct CookedMesh
+{
+	std::vector<Vertex> vertices;
+	// dequantize with position = aPos.xyz * scale + bias
+	float positionScale[3];
+	float positionBias[3];
+	CookingReport report;
+};
+
+CookedMesh<CookedVertex> cookMesh(const SourceVertex* vertices, std::size_t vertexCount);
+
+// interleaved xyz rgb floats, the layout the 1.3 samples use
+CookedMesh<CookedColorVertex> cookColorMesh(const float* positionColors, std::size_t vertexCount);
+
+// packing helpers
+unsigned short quantizeUNorm16(float value);
+unsigned char quantizeUNorm8(float value);
+int packSNorm10_10_10_2(float x, float y, float z, float w);
+unsigned short floatToHalf(float value);
@@ -0,0 +1,409 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Vertex cache analysis
+// ---------------------
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount, unsigned int cacheSize)
+{
+	VertexCacheStats stats;
+
+	// a vertex is still in the FIFO if fewer than cacheSize misses happened since it went in
+	std::vector<unsigned int> cachedAt(vertexCount, 0);
+	std::vector<bool> used(vertexCount, false);
+	unsigned int time = cacheSize + 1;
+	std::size_t usedVertices = 0;
+
+	for (std::size_t i = 0; i < indexCount; i++)
+	{
+		unsigned int v = indices[i];
+		if (time - cachedAt[v] > cacheSize)
+		{
+			cachedAt[v] = time++;
+			stats.transformed++;
+		}
+		if (!used[v])
+		{
+			used[v] = true;
+			usedVertices++;
+		}
+	}
+
+	std::size_t triangles = indexCount / 3;
+	stats.acmr = triangles > 0 ? (float)stats.transformed / triangles : 0.0f;
+	stats.atvr = usedVertices > 0 ? (float)stats.transformed / usedVertices : 0.0f;
+	return stats;
+}
+
+// Tipsify
+// -------
+struct TriangleAdjacency
+{
+	std::vector<unsigned int> offsets;	// per vertex, into triangles
+	std::vector<unsigned int> triangles;
+	std::vector<unsigned int> liveCount;
+
+	TriangleAdjacency(const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount)
+		: offsets(vertexCount + 1, 0), triangles(indexCount), liveCount(vertexCount, 0)
+	{
+		for (std::size_t i = 0; i < indexCount; i++)
+			liveCount[indices[i]]++;
+
+		for (std::size_t v = 0; v < vertexCount; v++)
+			offsets[v + 1] = offsets[v] + liveCount[v];
+
+		std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+		for (std::size_t i = 0; i < indexCount; i++)
+			triangles[fill[indices[i]]++] = (unsigned int)(i / 3);
+	}
+};
+
+static const unsigned int NO_VERTEX = 0xFFFFFFFF;
+
+static unsigned int skipDeadEnd(const std::vector<unsigned int>& liveCount, std::vector<unsigned int>& deadEnds,
+	unsigned int& cursor, std::size_t vertexCount)
+{
+	// recently used vertices first, they are likely still in the cache
+	while (!deadEnds.empty())
+	{
+		unsigned int v = deadEnds.back();
+		deadEnds.pop_back();
+		if (liveCount[v] > 0)
+			return v;
+	}
+	// then the next vertex in input order that still has triangles
+	while (cursor < vertexCount)
+	{
+		if (liveCount[cursor] > 0)
+			return cursor;
+		cursor++;
+	}
+	return NO_VERTEX;
+}
+
+void optimizeVertexCache(unsigned int* destination, const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount,
+	unsigned int cacheSize, std::vector<unsigned int>* clusterStarts)
+{
+	std::size_t triangleCount = indexCount / 3;
+	if (clusterStarts != NULL)
+		clusterStarts->clear();
+	if (triangleCount == 0)
+		return;
+
+	// destination may alias indices
+	std::vector<unsigned int> source(indices, indices + indexCount);
+	TriangleAdjacency adjacency(source.data(), indexCount, vertexCount);
+
+	std::vector<unsigned int> cachedAt(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<unsigned int> deadEnds;
+	std::vector<unsigned int> candidates;
+	unsigned int time = cacheSize + 1;
+	unsigned int cursor = 0;
+	std::size_t written = 0;
+
+	unsigned int fan = 0;
+	while (adjacency.liveCount[fan] == 0)
+		fan++;
+	if (clusterStarts != NULL)
+		clusterStarts->push_back(0);
+
+	while (fan != NO_VERTEX)
+	{
+		candidates.clear();
+
+		// emit every remaining triangle around the fanning vertex
+		for (unsigned int a = adjacency.offsets[fan]; a < adjacency.offsets[fan + 1]; a++)
+		{
+			unsigned int triangle = adjacency.triangles[a];
+			if (emitted[triangle])
+				continue;
+			emitted[triangle] = true;
+
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = source[triangle * 3 + k];
+				destination[written++] = v;
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				adjacency.liveCount[v]--;
+				if (time - cachedAt[v] > cacheSize)
+					cachedAt[v] = time++;
+			}
+		}
+
+		// next fan: the candidate that stays in the cache longest without being evicted
+		unsigned int next = NO_VERTEX;
+		int bestPriority = -1;
+		for (unsigned int v : candidates)
+		{
+			if (adjacency.liveCount[v] == 0)
+				continue;
+
+			int priority = 0;
+			if (time - cachedAt[v] + 2 * adjacency.liveCount[v] <= cacheSize)
+				priority = (int)(time - cachedAt[v]);
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = v;
+			}
+		}
+
+		if (next == NO_VERTEX)
+		{
+			next = skipDeadEnd(adjacency.liveCount, deadEnds, cursor, vertexCount);
+			if (next != NO_VERTEX && clusterStarts != NULL && written < indexCount)
+				clusterStarts->push_back((unsigned int)(written / 3));
+		}
+		fan = next;
+	}
+}
+
+// Overdraw
+// --------
+static const float* vertexPosition(const char* base, std::size_t stride, unsigned int v)
+{
+	return (const float*)(base + v * stride);
+}
+
+OverdrawStats analyzeOverdraw(const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride, unsigned int resolution)
+{
+	OverdrawStats stats;
+	const char* positionBytes = (const char*)positions;
+	if (vertexCount == 0 || resolution == 0)
+		return stats;
+
+	// fit the bounding box into [0, 1]^3 keeping proportions
+	float minimum[3], maximum[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		minimum[axis] = vertexPosition(positionBytes, positionStride, 0)[axis];
+		maximum[axis] = minimum[axis];
+	}
+	for (std::size_t v = 1; v < vertexCount; v++)
+	{
+		const float* p = vertexPosition(positionBytes, positionStride, (unsigned int)v);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			minimum[axis] = std::min(minimum[axis], p[axis]);
+			maximum[axis] = std::max(maximum[axis], p[axis]);
+		}
+	}
+	float extent = std::max(maximum[0] - minimum[0], std::max(maximum[1] - minimum[1], maximum[2] - minimum[2]));
+	float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+	std::vector<float> depth((std::size_t)resolution * resolution);
+	for (int view = 0; view < 6; view++)
+	{
+		// (u, v, depth) is a rotation of (x, y, z), the camera sits at +depth looking down -depth.
+		// the far end swaps u and v and negates depth, which is a rotation too, so the winding holds
+		int axis = view % 3;
+		bool farEnd = view >= 3;
+		int uAxis = (axis + 1) % 3, vAxis = (axis + 2) % 3;
+		if (farEnd)
+			std::swap(uAxis, vAxis);
+
+		std::fill(depth.begin(), depth.end(), -1.0f);
+		for (std::size_t t = 0; t + 2 < indexCount; t += 3)
+		{
+			float screen[3][3];
+			for (int k = 0; k < 3; k++)
+			{
+				const float* p = vertexPosition(positionBytes, positionStride, indices[t + k]);
+				screen[k][0] = (p[uAxis] - minimum[uAxis]) * scale * resolution;
+				screen[k][1] = (p[vAxis] - minimum[vAxis]) * scale * resolution;
+				screen[k][2] = (p[axis] - minimum[axis]) * scale;
+				if (farEnd)
+					screen[k][2] = 1.0f - screen[k][2];
+			}
+
+			// counter clockwise is front facing
+			float area = (screen[1][0] - screen[0][0]) * (screen[2][1] - screen[0][1])
+				- (screen[1][1] - screen[0][1]) * (screen[2][0] - screen[0][0]);
+			if (area <= 0.0f)
+				continue;
+
+			int x0 = std::max(0, (int)std::floor(std::min(screen[0][0], std::min(screen[1][0], screen[2][0]))));
+			int x1 = std::min((int)resolution - 1, (int)std::ceil(std::max(screen[0][0], std::max(screen[1][0], screen[2][0]))));
+			int y0 = std::max(0, (int)std::floor(std::min(screen[0][1], std::min(screen[1][1], screen[2][1]))));
+			int y1 = std::min((int)resolution - 1, (int)std::ceil(std::max(screen[0][1], std::max(screen[1][1], screen[2][1]))));
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					// pixel centers, an edge exactly through a center belongs to its left / top triangle
+					float px = x + 0.5f, py = y + 0.5f;
+					float weights[3];
+					bool inside = true;
+					for (int k = 0; k < 3 && inside; k++)
+					{
+						const float* a = screen[(k + 1) % 3];
+						const float* b = screen[(k + 2) % 3];
+						float dx = b[0] - a[0], dy = b[1] - a[1];
+						weights[k] = dx * (py - a[1]) - dy * (px - a[0]);
+						bool owned = dy < 0.0f || (dy == 0.0f && dx > 0.0f);
+						inside = weights[k] > 0.0f || (weights[k] == 0.0f && owned);
+					}
+					if (!inside)
+						continue;
+
+					float z = (weights[0] * screen[0][2] + weights[1] * screen[1][2] + weights[2] * screen[2][2]) / area;
+					float& stored = depth[(std::size_t)y * resolution + x];
+					if (z > stored)
+					{
+						if (stored < 0.0f)
+							stats.covered++;
+						stored = z;
+						stats.shaded++;
+					}
+				}
+			}
+		}
+	}
+
+	stats.overdraw = stats.covered > 0 ? (float)stats.shaded / stats.covered : 0.0f;
+	return stats;
+}
+
+struct Cluster
+{
+	unsigned int begin, end;	// triangles
+	float sortKey;
+};
+
+void optimizeOverdraw(unsigned int* destination, const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride, unsigned int cacheSize, float threshold)
+{
+	std::size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	std::vector<unsigned int> source(indices, indices + indexCount);
+	const char* positionBytes = (const char*)positions;
+
+	// hard boundaries: restart points of the Tipsify order
+	std::vector<unsigned int> hard;
+	std::vector<unsigned int> ordered(indexCount);
+	optimizeVertexCache(ordered.data(), source.data(), indexCount, vertexCount, cacheSize, &hard);
+	hard.push_back((unsigned int)triangleCount);
+
+	// soft boundaries: split a hard cluster wherever the running ACMR is still within
+	// threshold of the whole cluster's, smaller clusters sort better for little cache cost
+	std::vector<Cluster> clusters;
+	std::vector<unsigned int> cachedAt(vertexCount, 0);
+	unsigned int time = cacheSize + 1;
+	for (std::size_t h = 0; h + 1 < hard.size(); h++)
+	{
+		unsigned int begin = hard[h], end = hard[h + 1];
+		VertexCacheStats whole = analyzeVertexCache(&ordered[begin * 3], (end - begin) * 3, vertexCount, cacheSize);
+
+		unsigned int clusterBegin = begin;
+		unsigned int misses = 0;
+		time += cacheSize + 1;	// flush
+		for (unsigned int t = begin; t < end; t++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = ordered[t * 3 + k];
+				if (time - cachedAt[v] > cacheSize)
+				{
+					cachedAt[v] = time++;
+					misses++;
+				}
+			}
+
+			float acmr = (float)misses / (t - clusterBegin + 1);
+			if (t + 1 < end && acmr <= whole.acmr * threshold && t - clusterBegin + 1 >= 8)
+			{
+				clusters.push_back(Cluster{ clusterBegin, t + 1, 0.0f });
+				clusterBegin = t + 1;
+				misses = 0;
+				time += cacheSize + 1;
+			}
+		}
+		clusters.push_back(Cluster{ clusterBegin, end, 0.0f });
+	}
+
+	// sort key: how far the cluster sits out along its own normal, seen from the mesh center
+	float meshCenter[3] = { 0.0f, 0.0f, 0.0f };
+	for (std::size_t v = 0; v < vertexCount; v++)
+	{
+		const float* p = vertexPosition(positionBytes, positionStride, (unsigned int)v);
+		for (int axis = 0; axis < 3; axis++)
+			meshCenter[axis] += p[axis];
+	}
+	for (int axis = 0; axis < 3; axis++)
+		meshCenter[axis] /= vertexCount > 0 ? (float)vertexCount : 1.0f;
+
+	for (Cluster& cluster : clusters)
+	{
+		float center[3] = { 0.0f, 0.0f, 0.0f };
+		float normal[3] = { 0.0f, 0.0f, 0.0f };
+		float area = 0.0f;
+		for (unsigned int t = cluster.begin; t < cluster.end; t++)
+		{
+			const float* p0 = vertexPosition(positionBytes, positionStride, ordered[t * 3 + 0]);
+			const float* p1 = vertexPosition(positionBytes, positionStride, ordered[t * 3 + 1]);
+			const float* p2 = vertexPosition(positionBytes, positionStride, ordered[t * 3 + 2]);
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			float triangleArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			// area weighted, the cross product length already is twice the area
+			for (int axis = 0; axis < 3; axis++)
+			{
+				center[axis] += (p0[axis] + p1[axis] + p2[axis]) / 3.0f * triangleArea;
+				normal[axis] += n[axis];
+			}
+			area += triangleArea;
+		}
+
+		float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		cluster.sortKey = 0.0f;
+		if (area > 0.0f && normalLength > 0.0f)
+		{
+			for (int axis = 0; axis < 3; axis++)
+				cluster.sortKey += (center[axis] / area - meshCenter[axis]) * normal[axis] / normalLength;
+		}
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b)
+	{
+		return a.sortKey > b.sortKey;
+	});
+
+	std::size_t written = 0;
+	for (const Cluster& cluster : clusters)
+	{
+		std::size_t count = (cluster.end - cluster.begin) * 3;
+		std::memcpy(destination + written, &ordered[cluster.begin * 3], count * sizeof(unsigned int));
+		written += count;
+	}
+}
+
+// Vertex fetch
+// ------------
+std::size_t optimizeVertexFetch(void* destination, unsigned int* indices, std::size_t indexCount,
+	const void* vertices, std::size_t vertexCount, std::size_t vertexSize)
+{
+	std::vector<unsigned int> remap(vertexCount, NO_VERTEX);
+	std::size_t next = 0;
+
+	for (std::size_t i = 0; i < indexCount; i++)
+	{
+		unsigned int& v = indices[i];
+		if (remap[v] == NO_VERTEX)
+		{
+			remap[v] = (unsigned int)next;
+			std::memcpy((char*)destination + next * vertexSize, (const char*)vertices + (std::size_t)v * vertexSize, vertexSize);
+			next++;
+		}
+		v = remap[v];
+	}
+	return next;
+}
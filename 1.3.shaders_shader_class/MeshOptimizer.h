@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Mesh optimization
+// -----------------
+/// \note: reorders indexed triangle lists (like the indices[] + EBO samples) for the GPU:
+///		    1. optimizeVertexCache  - Tipsify (Sander et al. 2007), maximizes post transform
+///		                              cache hits so shared vertices are shaded once
+///		    2. optimizeOverdraw     - reorders the Tipsify clusters so outward facing ones
+///		                              come first and early z can reject more fragments
+///		    3. optimizeVertexFetch  - renumbers vertices in first use order, so vertex fetch
+///		                              walks memory linearly
+///		   Run them in this order, each one keeps the gains of the one before.
+
+struct VertexCacheStats
+{
+	unsigned int transformed{ 0 };	// simulated vertex shader invocations
+	float acmr{ 0.0f };	// average cache miss ratio, transformed / triangles (0.5 is ideal on big grids)
+	float atvr{ 0.0f };	// average transform to vertex ratio, transformed / used vertices (1.0 is ideal)
+};
+
+// FIFO post transform cache simulation
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount, unsigned int cacheSize = 16);
+
+struct OverdrawStats
+{
+	unsigned long long covered{ 0 };	// pixels with at least one fragment
+	unsigned long long shaded{ 0 };	// fragments that passed the depth test, in submission order
+	float overdraw{ 0.0f };	// shaded / covered (1.0 is ideal)
+};
+
+// depth tested, back face culled software raster of the mesh in submission order, orthographic
+// from both ends of every axis at resolution^2 pixels. positions are xyz floats every
+// positionStride bytes
+OverdrawStats analyzeOverdraw(const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride, unsigned int resolution = 256);
+
+// Tipsify. clusterStarts, if given, receives the first triangle of every cluster (dead end restart)
+void optimizeVertexCache(unsigned int* destination, const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount,
+	unsigned int cacheSize = 16, std::vector<unsigned int>* clusterStarts = NULL);
+
+// runs Tipsify itself to find the clusters. positions are xyz floats every positionStride bytes.
+// threshold is how much ACMR may grow (1.05 = 5%) to get smaller, better sortable clusters
+void optimizeOverdraw(unsigned int* destination, const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride, unsigned int cacheSize = 16, float threshold = 1.05f);
+
+// remaps indices in place and writes the vertices in first use order (destination must not
+// overlap vertices). returns the number of vertices written, unreferenced vertices are dropped
+std::size_t optimizeVertexFetch(void* destination, unsigned int* indices, std::size_t indexCount,
+	const void* vertices, std::size_t vertexCount, std::size_t vertexSize);
@@ -0,0 +1,358 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+
+// Quadrics
+// --------
+struct Quadric
+{
+	// upper triangle of the symmetric 4x4 plane matrix
+	double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+	// sum of the plane weights, to turn the weighted sum back into a squared distance
+	double w;
+};
+
+static void addPlane(Quadric& q, double a, double b, double c, double d, double weight)
+{
+	q.a2 += weight * a * a; q.ab += weight * a * b; q.ac += weight * a * c; q.ad += weight * a * d;
+	q.b2 += weight * b * b; q.bc += weight * b * c; q.bd += weight * b * d;
+	q.c2 += weight * c * c; q.cd += weight * c * d;
+	q.d2 += weight * d * d;
+	q.w += weight;
+}
+
+static void addQuadric(Quadric& q, const Quadric& other)
+{
+	q.a2 += other.a2; q.ab += other.ab; q.ac += other.ac; q.ad += other.ad;
+	q.b2 += other.b2; q.bc += other.bc; q.bd += other.bd;
+	q.c2 += other.c2; q.cd += other.cd;
+	q.d2 += other.d2;
+	q.w += other.w;
+}
+
+// weighted mean squared distance to the planes
+static double evaluate(const Quadric& q, const float* p)
+{
+	if (q.w <= 0.0)
+		return 0.0;
+
+	double x = p[0], y = p[1], z = p[2];
+	return (q.a2 * x * x + 2.0 * q.ab * x * y + 2.0 * q.ac * x * z + 2.0 * q.ad * x
+		+ q.b2 * y * y + 2.0 * q.bc * y * z + 2.0 * q.bd * y
+		+ q.c2 * z * z + 2.0 * q.cd * z
+		+ q.d2) / q.w;
+}
+
+static void cross(const float* a, const float* b, float* out)
+{
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static void triangleNormal(const float* p0, const float* p1, const float* p2, float* normal)
+{
+	float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+	float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+	cross(e1, e2, normal);
+}
+
+// Simplifier
+// ----------
+struct Collapse
+{
+	float cost;
+	unsigned int from, to;
+	unsigned int fromVersion, toVersion;
+
+	bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+class Simplifier
+{
+	const char* positionBytes;
+	std::size_t positionStride;
+
+	std::vector<unsigned int> triangles;
+	std::vector<bool> removed;
+	std::vector<std::vector<unsigned int>> vertexTriangles;
+	std::vector<Quadric> quadrics;
+	std::vector<unsigned int> version;
+	std::vector<bool> collapsed;
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+	std::size_t liveTriangles;
+
+public:
+	float maxError;
+
+	Simplifier(const unsigned int* indices, std::size_t indexCount, const float* positions, std::size_t vertexCount, std::size_t positionStride)
+		: positionBytes((const char*)positions), positionStride(positionStride),
+		  triangles(indices, indices + indexCount), removed(indexCount / 3, false),
+		  vertexTriangles(vertexCount), quadrics(vertexCount, Quadric()), version(vertexCount, 0),
+		  collapsed(vertexCount, false), liveTriangles(indexCount / 3), maxError(0.0f)
+	{
+		std::unordered_map<unsigned long long, int> edgeUse;
+		for (std::size_t t = 0; t < liveTriangles; t++)
+		{
+			const unsigned int* tri = &triangles[t * 3];
+			float normal[3];
+			triangleNormal(position(tri[0]), position(tri[1]), position(tri[2]), normal);
+			float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+			for (int k = 0; k < 3; k++)
+			{
+				vertexTriangles[tri[k]].push_back((unsigned int)t);
+				edgeUse[edgeKey(tri[k], tri[(k + 1) % 3])]++;
+			}
+			if (area == 0.0f)
+				continue;
+
+			// area weighted plane, area is the cross product length / 2 but only ratios matter
+			const float* p0 = position(tri[0]);
+			double a = normal[0] / area, b = normal[1] / area, c = normal[2] / area;
+			double d = -(a * p0[0] + b * p0[1] + c * p0[2]);
+			for (int k = 0; k < 3; k++)
+				addPlane(quadrics[tri[k]], a, b, c, d, area);
+		}
+
+		// borders and seams: a plane through the edge, perpendicular to the triangle
+		for (std::size_t t = 0; t < liveTriangles; t++)
+		{
+			const unsigned int* tri = &triangles[t * 3];
+			float normal[3];
+			triangleNormal(position(tri[0]), position(tri[1]), position(tri[2]), normal);
+
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v0 = tri[k], v1 = tri[(k + 1) % 3];
+				if (edgeUse[edgeKey(v0, v1)] != 1)
+					continue;
+
+				const float* p0 = position(v0);
+				const float* p1 = position(v1);
+				float edge[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				float plane[3];
+				cross(edge, normal, plane);
+				float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+				if (length == 0.0f)
+					continue;
+
+				double a = plane[0] / length, b = plane[1] / length, c = plane[2] / length;
+				double d = -(a * p0[0] + b * p0[1] + c * p0[2]);
+				double weight = 10.0 * (edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2]);
+				addPlane(quadrics[v0], a, b, c, d, weight);
+				addPlane(quadrics[v1], a, b, c, d, weight);
+			}
+		}
+
+		for (std::size_t t = 0; t < liveTriangles; t++)
+		{
+			for (int k = 0; k < 3; k++)
+				pushCollapse(triangles[t * 3 + k], triangles[t * 3 + (k + 1) % 3]);
+		}
+	}
+
+	void run(std::size_t targetTriangles, float targetError)
+	{
+		const double maxCost = (double)targetError * targetError;
+		while (liveTriangles > targetTriangles && !queue.empty())
+		{
+			Collapse collapse = queue.top();
+			queue.pop();
+
+			if (collapsed[collapse.from] || collapsed[collapse.to]
+				|| version[collapse.from] != collapse.fromVersion || version[collapse.to] != collapse.toVersion)
+				continue;	// stale
+			if (collapse.cost > maxCost)
+				break;
+			if (flips(collapse.from, collapse.to))
+				continue;
+
+			apply(collapse);
+		}
+	}
+
+	std::size_t write(unsigned int* destination) const
+	{
+		std::size_t written = 0;
+		for (std::size_t t = 0; t < removed.size(); t++)
+		{
+			if (removed[t])
+				continue;
+			for (int k = 0; k < 3; k++)
+				destination[written++] = triangles[t * 3 + k];
+		}
+		return written;
+	}
+
+private:
+	const float* position(unsigned int v) const
+	{
+		return (const float*)(positionBytes + v * positionStride);
+	}
+
+	static unsigned long long edgeKey(unsigned int a, unsigned int b)
+	{
+		return a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+	}
+
+	void pushCollapse(unsigned int from, unsigned int to)
+	{
+		if (from == to)
+			return;
+		Quadric q = quadrics[from];
+		addQuadric(q, quadrics[to]);
+		double cost = std::max(evaluate(q, position(to)), 0.0);
+		queue.push(Collapse{ (float)cost, from, to, version[from], version[to] });
+	}
+
+	bool flips(unsigned int from, unsigned int to) const
+	{
+		for (unsigned int t : vertexTriangles[from])
+		{
+			if (removed[t])
+				continue;
+			const unsigned int* tri = &triangles[t * 3];
+			if (tri[0] == to || tri[1] == to || tri[2] == to)
+				continue;	// becomes degenerate and goes away
+
+			const float* p[3];
+			const float* moved[3];
+			for (int k = 0; k < 3; k++)
+			{
+				p[k] = position(tri[k]);
+				moved[k] = tri[k] == from ? position(to) : p[k];
+			}
+			float before[3], after[3];
+			triangleNormal(p[0], p[1], p[2], before);
+			triangleNormal(moved[0], moved[1], moved[2], after);
+			if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0f)
+				return true;
+		}
+		return false;
+	}
+
+	void apply(const Collapse& collapse)
+	{
+		unsigned int from = collapse.from, to = collapse.to;
+		for (unsigned int t : vertexTriangles[from])
+		{
+			if (removed[t])
+				continue;
+			unsigned int* tri = &triangles[t * 3];
+			if (tri[0] == to || tri[1] == to || tri[2] == to)
+			{
+				removed[t] = true;
+				liveTriangles--;
+				continue;
+			}
+			for (int k = 0; k < 3; k++)
+			{
+				if (tri[k] == from)
+					tri[k] = to;
+			}
+			vertexTriangles[to].push_back(t);
+		}
+		vertexTriangles[from].clear();
+
+		addQuadric(quadrics[to], quadrics[from]);
+		collapsed[from] = true;
+		version[to]++;
+		maxError = std::max(maxError, collapse.cost);
+
+		// every edge around the merged vertex has a new cost
+		std::vector<unsigned int> neighbours;
+		for (unsigned int t : vertexTriangles[to])
+		{
+			if (removed[t])
+				continue;
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = triangles[t * 3 + k];
+				if (v != to && std::find(neighbours.begin(), neighbours.end(), v) == neighbours.end())
+					neighbours.push_back(v);
+			}
+		}
+		for (unsigned int v : neighbours)
+		{
+			pushCollapse(v, to);
+			pushCollapse(to, v);
+		}
+	}
+};
+
+std::size_t simplifyMesh(unsigned int* destination, const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride,
+	std::size_t targetIndexCount, float targetError, float* resultError)
+{
+	Simplifier simplifier(indices, indexCount, positions, vertexCount, positionStride);
+	simplifier.run(targetIndexCount / 3, targetError);
+	if (resultError != NULL)
+		*resultError = std::sqrt(simplifier.maxError);
+	return simplifier.write(destination);
+}
+
+// Level of detail
+// ---------------
+LodChain buildLodChain(BufferArena& arena, const MeshAllocation& base, const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride, int maxLevels)
+{
+	LodChain chain;
+	chain.levels.push_back(LodLevel{ base, 0.0f });
+
+	// every level starts from the base mesh so its error is measured against the original surface
+	std::vector<unsigned int> lod(indexCount);
+	std::size_t previousCount = indexCount;
+	for (int level = 1; level < maxLevels; level++)
+	{
+		std::size_t target = previousCount / 2 / 3 * 3;
+		float error = 0.0f;
+		std::size_t count = simplifyMesh(lod.data(), indices, indexCount, positions, vertexCount, positionStride, target, 1e30f, &error);
+		if (count == 0 || count > previousCount * 3 / 4)
+			break;	// stalled, borders or flips block further collapses
+
+		MeshAllocation mesh = arena.allocateIndices(base, lod.data(), (unsigned int)count);
+		if (!mesh.isValid())
+			break;
+
+		chain.levels.push_back(LodLevel{ mesh, std::max(error, chain.levels.back().error) });
+		previousCount = count;
+	}
+	return chain;
+}
+
+void freeLodChain(BufferArena& arena, LodChain& chain)
+{
+	// level 0 is the base mesh, its owner frees it
+	for (std::size_t i = 1; i < chain.levels.size(); i++)
+		arena.free(chain.levels[i].mesh);
+	chain.levels.clear();
+}
+
+float projectedError(float error, float distance, const LodSettings& settings)
+{
+	distance = std::max(distance, 1e-4f);
+	return error * settings.screenHeight / (2.0f * distance * std::tan(settings.fovY * 0.5f));
+}
+
+int selectLod(const LodChain& chain, float distance, int currentLevel, const LodSettings& settings)
+{
+	int selected = 0;
+	for (int level = (int)chain.levels.size() - 1; level > 0; level--)
+	{
+		float pixels = projectedError(chain.levels[level].error, distance, settings);
+		float budget = settings.pixelError;
+		if (level > currentLevel)
+			budget *= 1.0f - settings.hysteresis;	// coarser than now, must clearly fit
+
+		if (pixels <= budget)
+		{
+			selected = level;
+			break;
+		}
+	}
+	return selected;
+}
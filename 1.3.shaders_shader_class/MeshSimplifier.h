@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "BufferArena.h"
+
+// Mesh simplification
+// -------------------
+/// \note: quadric error metric (Garland & Heckbert 1997) with half edge collapses: a vertex
+///		   always collapses onto one of its neighbours, never onto a new position. Every LOD
+///		   is therefore just another index buffer over the base mesh's vertices and lives in
+///		   the same BufferArena page. Open borders and attribute seams get extra boundary
+///		   planes so they don't shrink, collapses that would flip a triangle are skipped.
+
+// writes at most indexCount indices and returns how many. stops at targetIndexCount or when the
+// next collapse would move the surface more than targetError (mesh units). resultError, if given,
+// receives the largest error actually introduced
+std::size_t simplifyMesh(unsigned int* destination, const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride,
+	std::size_t targetIndexCount, float targetError, float* resultError = NULL);
+
+// Level of detail
+// ---------------
+struct LodLevel
+{
+	MeshAllocation mesh;	// level 0 is the base mesh, the others only own their indices
+	float error;	// object space, in mesh units
+};
+
+struct LodChain
+{
+	std::vector<LodLevel> levels;
+};
+
+// halves the triangle count per level until maxLevels or until simplification stalls.
+// the levels are uploaded into the base mesh's arena page
+LodChain buildLodChain(BufferArena& arena, const MeshAllocation& base, const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride, int maxLevels = 6);
+
+void freeLodChain(BufferArena& arena, LodChain& chain);
+
+// Per frame selection
+// -------------------
+/// \note: an object's error in pixels is error * screenHeight / (2 * distance * tan(fovY / 2)).
+///		   The coarsest level under pixelError wins. To stop objects at the threshold distance
+///		   flickering between two levels, going coarser needs the error to be hysteresis
+///		   (fraction) below the budget, going finer happens as soon as it's over.
+struct LodSettings
+{
+	float pixelError{ 1.0f };	// the budget, raise it to trade quality for triangles
+	float hysteresis{ 0.25f };
+	float screenHeight{ 600.0f };
+	float fovY{ 0.785398f };	// radians
+};
+
+float projectedError(float error, float distance, const LodSettings& settings);
+
+// currentLevel is the level the object used last frame (-1 if none)
+int selectLod(const LodChain& chain, float distance, int currentLevel, const LodSettings& settings);
@@ -0,0 +1,239 @@
+#include "MeshWelder.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static const unsigned int EMPTY_SLOT = 0xFFFFFFFF;
+
+static std::uint64_t hashBytes(const unsigned char* bytes, std::size_t size)
+{
+	std::uint64_t hash = 14695981039346656037ull;
+	std::size_t i = 0;
+	for (; i + 4 <= size; i += 4)
+	{
+		std::uint32_t word;
+		std::memcpy(&word, bytes + i, 4);
+		hash = (hash ^ word) * 1099511628211ull;
+	}
+	for (; i < size; i++)
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	// final mix so the low bits used for the shard and the table index are well spread
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+// runs work(thread, begin, end) over [0, count) split into contiguous slices
+template <typename Work>
+static void parallelFor(unsigned int threadCount, std::size_t count, Work work)
+{
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < threadCount; t++)
+	{
+		std::size_t begin = count * t / threadCount;
+		std::size_t end = count * (t + 1) / threadCount;
+		threads.emplace_back(work, t, begin, end);
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+WeldedMesh weldVertices(const void* vertices, std::size_t vertexCount, std::size_t vertexSize, float gridSize, unsigned int threadCount)
+{
+	WeldedMesh mesh;
+	mesh.vertexSize = vertexSize;
+	if (vertexCount == 0 || vertexSize == 0)
+		return mesh;
+	if (gridSize > 0.0f && vertexSize % 4 != 0)
+	{
+		// the bytes past the last float wouldn't be compared at all
+		std::cout << "ERROR::WELD::VERTEX_SIZE_NOT_FLOATS: " << vertexSize << " bytes, snapping needs a multiple of 4" << std::endl;
+		return mesh;
+	}
+
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	const unsigned int shardCount = threadCount;
+	const unsigned char* source = (const unsigned char*)vertices;
+
+	// keys are what gets compared: the raw bytes, or the floats snapped to the grid
+	const bool snap = gridSize > 0.0f;
+	std::vector<std::int64_t> snapped;
+	if (snap)
+		snapped.resize(vertexCount * (vertexSize / 4));
+	const std::size_t keySize = snap ? vertexSize / 4 * sizeof(std::int64_t) : vertexSize;
+	const unsigned char* keys = snap ? (const unsigned char*)snapped.data() : source;
+	// grid cells past 2^53 (or inf / nan) aren't exact in a double, they would share keys
+	std::vector<char> outOfRange(threadCount, 0);
+
+	// 1. hash every vertex and sort it into its shard, per thread to keep the input order
+	std::vector<std::uint64_t> hashes(vertexCount);
+	std::vector<std::vector<std::vector<unsigned int>>> shardLists(threadCount, std::vector<std::vector<unsigned int>>(shardCount));
+	parallelFor(threadCount, vertexCount, [&](unsigned int thread, std::size_t begin, std::size_t end)
+	{
+		for (std::size_t v = begin; v < end; v++)
+		{
+			if (snap)
+			{
+				for (std::size_t c = 0; c < vertexSize / 4; c++)
+				{
+					float value;
+					std::memcpy(&value, source + v * vertexSize + c * 4, 4);
+					double cell = std::floor((double)value / gridSize + 0.5);
+					if (!(std::fabs(cell) <= 9007199254740992.0))
+					{
+						outOfRange[thread] = 1;
+						cell = 0.0;
+					}
+					snapped[v * (vertexSize / 4) + c] = (std::int64_t)cell;
+				}
+			}
+			hashes[v] = hashBytes(keys + v * keySize, keySize);
+			shardLists[thread][hashes[v] % shardCount].push_back((unsigned int)v);
+		}
+	});
+	for (char failed : outOfRange)
+	{
+		if (failed)
+		{
+			std::cout << "ERROR::WELD::GRID_TOO_FINE: " << gridSize
+				<< " puts a value more than 2^53 cells from 0, nothing welded" << std::endl;
+			return mesh;
+		}
+	}
+
+	// 2. every thread dedups one shard with an open addressing table, remap points to the first occurrence
+	std::vector<unsigned int> remap(vertexCount);
+	parallelFor(shardCount, shardCount, [&](unsigned int, std::size_t shard, std::size_t shardEnd)
+	{
+		for (; shard < shardEnd; shard++)
+		{
+			std::size_t count = 0;
+			for (unsigned int t = 0; t < threadCount; t++)
+				count += shardLists[t][shard].size();
+
+			std::size_t capacity = 16;
+			while (capacity < count * 2)
+				capacity *= 2;
+			std::vector<unsigned int> table(capacity, EMPTY_SLOT);
+
+			for (unsigned int t = 0; t < threadCount; t++)
+			{
+				for (unsigned int v : shardLists[t][shard])
+				{
+					std::size_t slot = (std::size_t)(hashes[v] / shardCount) & (capacity - 1);
+					for (;;)
+					{
+						unsigned int other = table[slot];
+						if (other == EMPTY_SLOT)
+						{
+							table[slot] = v;
+							remap[v] = v;
+							break;
+						}
+						if (hashes[other] == hashes[v] && std::memcmp(keys + other * keySize, keys + (std::size_t)v * keySize, keySize) == 0)
+						{
+							remap[v] = other;
+							break;
+						}
+						slot = (slot + 1) & (capacity - 1);
+					}
+				}
+			}
+		}
+	});
+
+	// 3. number the unique vertices in order of first occurrence
+	std::vector<unsigned int> newIndex(vertexCount);
+	for (std::size_t v = 0; v < vertexCount; v++)
+	{
+		if (remap[v] == v)
+			newIndex[v] = (unsigned int)mesh.vertexCount++;
+	}
+
+	// 4. write indices and unique vertices
+	mesh.indices.resize(vertexCount);
+	mesh.vertices.resize(mesh.vertexCount * vertexSize);
+	parallelFor(threadCount, vertexCount, [&](unsigned int, std::size_t begin, std::size_t end)
+	{
+		for (std::size_t v = begin; v < end; v++)
+		{
+			mesh.indices[v] = newIndex[remap[v]];
+			if (remap[v] == v)
+				std::memcpy(&mesh.vertices[(std::size_t)newIndex[v] * vertexSize], source + v * vertexSize, vertexSize);
+		}
+	});
+
+	return mesh;
+}
+
+std::vector<unsigned short> WeldedMesh::indices16() const
+{
+	std::vector<unsigned short> result;
+	if (!fitsIndex16())
+		return result;
+
+	result.resize(indices.size());
+	for (std::size_t i = 0; i < indices.size(); i++)
+		result[i] = (unsigned short)indices[i];
+	return result;
+}
+
+bool weldFile(const char* inputPath, std::size_t vertexSize, const char* outputPrefix, float gridSize)
+{
+	std::ifstream input(inputPath, std::ios::binary | std::ios::ate);
+	if (!input || vertexSize == 0)
+	{
+		std::cout << "ERROR::WELD::FAILED_TO_READ: " << inputPath << std::endl;
+		return false;
+	}
+	std::size_t bytes = (std::size_t)input.tellg();
+	std::vector<unsigned char> soup(bytes);
+	input.seekg(0);
+	input.read((char*)soup.data(), bytes);
+
+	std::size_t vertexCount = bytes / vertexSize;
+	if (bytes % vertexSize != 0)
+	{
+		std::cout << "WARNING::WELD::PARTIAL_VERTEX: " << inputPath << " is " << bytes << " bytes, not a multiple of "
+			<< vertexSize << ", the last " << bytes % vertexSize << " are ignored" << std::endl;
+	}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	WeldedMesh mesh = weldVertices(soup.data(), vertexCount, vertexSize, gridSize);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (vertexCount > 0 && mesh.vertexCount == 0)
+		return false;
+
+	std::ofstream vertexFile(std::string(outputPrefix) + ".vertices", std::ios::binary);
+	std::ofstream indexFile(std::string(outputPrefix) + ".indices", std::ios::binary);
+	if (!vertexFile || !indexFile)
+	{
+		std::cout << "ERROR::WELD::FAILED_TO_WRITE: " << outputPrefix << std::endl;
+		return false;
+	}
+	vertexFile.write((const char*)mesh.vertices.data(), mesh.vertices.size());
+
+	std::size_t indexSize = mesh.fitsIndex16() ? 2 : 4;
+	if (mesh.fitsIndex16())
+	{
+		std::vector<unsigned short> indices = mesh.indices16();
+		indexFile.write((const char*)indices.data(), indices.size() * sizeof(unsigned short));
+	}
+	else
+	{
+		indexFile.write((const char*)mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+	}
+
+	std::cout << "WELD:: " << vertexCount << " -> " << mesh.vertexCount << " vertices, "
+		<< indexSize * 8 << " bit indices, " << bytes << " -> "
+		<< mesh.vertices.size() + mesh.indices.size() * indexSize << " bytes in "
+		<< seconds * 1e3 << " ms" << std::endl;
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Vertex welding
+// --------------
+/// \note: turns a non-indexed triangle soup (every triangle with its own 3 vertices, like the
+///		   commented out 6 vertex rectangle in 1.2.hello_triangle_ebo) into unique vertices
+///		   plus an index buffer. Works on any vertex layout, vertices are compared as raw
+///		   bytes, or with gridSize > 0 quantized first: every float is rounded to the nearest
+///		   multiple of gridSize, then vertices must match exactly (vertexSize must then be a
+///		   multiple of 4 and every attribute a float). That is not a weld within a distance:
+///		   two values closer than gridSize but on either side of a cell boundary stay apart.
+///		   Hashing and deduplication run on threadCount threads (0 = all cores): each thread
+///		   hashes a slice, then every thread owns one hash shard, so no locks are needed.
+///		   The result is deterministic, the first occurrence of a vertex wins and output
+///		   vertices keep the order of their first occurrence.
+struct WeldedMesh
+{
+	std::vector<unsigned char> vertices;
+	std::vector<unsigned int> indices;
+	std::size_t vertexCount{ 0 };
+	std::size_t vertexSize{ 0 };
+
+	// true when every index fits a GL_UNSIGNED_SHORT index buffer. 0xFFFF stays free, it is
+	// the primitive restart index of 16 bit strips (Stripifier.h)
+	bool fitsIndex16() const { return vertexCount < 65536; }
+	// 16 bit copy of indices, empty if it doesn't fit
+	std::vector<unsigned short> indices16() const;
+};
+
+// no vertices (ERROR::WELD printed) when gridSize is so fine a value's cell isn't exact, or
+// vertexSize isn't a multiple of 4 with gridSize > 0
+WeldedMesh weldVertices(const void* vertices, std::size_t vertexCount, std::size_t vertexSize,
+	float gridSize = 0.0f, unsigned int threadCount = 0);
+
+// tool: reads raw interleaved vertices from inputPath, writes <outputPrefix>.vertices and
+// <outputPrefix>.indices (16 bit if they fit, else 32 bit). returns false on io errors or when
+// weldVertices() fails. A partial vertex at the end of the file is ignored, with a warning
+bool weldFile(const char* inputPath, std::size_t vertexSize, const char* outputPrefix, float gridSize = 0.0f);
@@ -0,0 +1,277 @@
+#include "Meshlets.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MESHLETS_SSE 1
+	#include <emmintrin.h>
+#else
+	#define MESHLETS_SSE 0
+#endif
+
+static const float* vertexPosition(const float* positions, std::size_t stride, unsigned int v)
+{
+	return (const float*)((const char*)positions + v * stride);
+}
+
+static void computeBounds(MeshletMesh& mesh, const Meshlet& meshlet, const float* positions, std::size_t stride)
+{
+	// sphere: center of the AABB, radius to the farthest vertex
+	float minP[3] = { 1e30f, 1e30f, 1e30f }, maxP[3] = { -1e30f, -1e30f, -1e30f };
+	for (unsigned int i = 0; i < meshlet.vertexCount; i++)
+	{
+		const float* p = vertexPosition(positions, stride, mesh.vertices[meshlet.vertexOffset + i]);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			minP[axis] = std::min(minP[axis], p[axis]);
+			maxP[axis] = std::max(maxP[axis], p[axis]);
+		}
+	}
+	float center[3] = { (minP[0] + maxP[0]) * 0.5f, (minP[1] + maxP[1]) * 0.5f, (minP[2] + maxP[2]) * 0.5f };
+	float radius = 0.0f;
+	for (unsigned int i = 0; i < meshlet.vertexCount; i++)
+	{
+		const float* p = vertexPosition(positions, stride, mesh.vertices[meshlet.vertexOffset + i]);
+		float dx = p[0] - center[0], dy = p[1] - center[1], dz = p[2] - center[2];
+		radius = std::max(radius, std::sqrt(dx * dx + dy * dy + dz * dz));
+	}
+
+	// cone: average triangle normal, opened up to the widest one
+	std::vector<float> normals;
+	float axis[3] = { 0.0f, 0.0f, 0.0f };
+	for (unsigned int t = 0; t < meshlet.triangleCount; t++)
+	{
+		const unsigned char* local = &mesh.triangles[(meshlet.triangleOffset + t) * 3];
+		const float* p0 = vertexPosition(positions, stride, mesh.vertices[meshlet.vertexOffset + local[0]]);
+		const float* p1 = vertexPosition(positions, stride, mesh.vertices[meshlet.vertexOffset + local[1]]);
+		const float* p2 = vertexPosition(positions, stride, mesh.vertices[meshlet.vertexOffset + local[2]]);
+		float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+		float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length == 0.0f)
+			continue;	// degenerate, can't face anywhere
+
+		for (int k = 0; k < 3; k++)
+		{
+			normals.push_back(n[k] / length);
+			axis[k] += n[k] / length;
+		}
+	}
+
+	float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+	float cutoff = 1.0f;
+	if (axisLength > 0.0f)
+	{
+		for (int k = 0; k < 3; k++)
+			axis[k] /= axisLength;
+
+		float minDot = 1.0f;
+		for (std::size_t i = 0; i < normals.size(); i += 3)
+			minDot = std::min(minDot, normals[i] * axis[0] + normals[i + 1] * axis[1] + normals[i + 2] * axis[2]);
+
+		// cones wider than a hemisphere always have a triangle facing the camera
+		if (minDot > 0.0f)
+			cutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+
+	mesh.centerX.push_back(center[0]);
+	mesh.centerY.push_back(center[1]);
+	mesh.centerZ.push_back(center[2]);
+	mesh.radius.push_back(radius);
+	mesh.axisX.push_back(axis[0]);
+	mesh.axisY.push_back(axis[1]);
+	mesh.axisZ.push_back(axis[2]);
+	mesh.coneCutoff.push_back(cutoff);
+}
+
+MeshletMesh buildMeshlets(const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride)
+{
+	MeshletMesh mesh;
+	std::vector<int> localIndex(vertexCount, -1);
+	Meshlet current{ 0, 0, 0, 0 };
+
+	std::size_t triangleCount = indexCount / 3;
+	for (std::size_t t = 0; t <= triangleCount; t++)
+	{
+		unsigned int newVertices = 0;
+		if (t < triangleCount)
+		{
+			for (int k = 0; k < 3; k++)
+				newVertices += localIndex[indices[t * 3 + k]] < 0 ? 1 : 0;
+		}
+
+		// close the meshlet when this triangle doesn't fit, or at the end
+		bool full = current.vertexCount + newVertices > MeshletMesh::MAX_VERTICES || current.triangleCount + 1 > MeshletMesh::MAX_TRIANGLES;
+		if ((t == triangleCount || full) && current.triangleCount > 0)
+		{
+			for (unsigned int i = 0; i < current.vertexCount; i++)
+				localIndex[mesh.vertices[current.vertexOffset + i]] = -1;
+
+			mesh.meshlets.push_back(current);
+			computeBounds(mesh, current, positions, positionStride);
+			current = Meshlet{ (unsigned int)mesh.vertices.size(), (unsigned int)(mesh.triangles.size() / 3), 0, 0 };
+		}
+		if (t == triangleCount)
+			break;
+
+		for (int k = 0; k < 3; k++)
+		{
+			unsigned int v = indices[t * 3 + k];
+			if (localIndex[v] < 0)
+			{
+				localIndex[v] = (int)current.vertexCount++;
+				mesh.vertices.push_back(v);
+			}
+			mesh.triangles.push_back((unsigned char)localIndex[v]);
+			mesh.meshletIndices.push_back(v);
+		}
+		current.triangleCount++;
+	}
+
+	// pad the SoA bounds with spheres that are always culled
+	while (mesh.radius.size() % 4 != 0)
+	{
+		mesh.centerX.push_back(0.0f); mesh.centerY.push_back(0.0f); mesh.centerZ.push_back(0.0f);
+		mesh.radius.push_back(-1e30f);
+		mesh.axisX.push_back(0.0f); mesh.axisY.push_back(0.0f); mesh.axisZ.push_back(0.0f);
+		mesh.coneCutoff.push_back(1.0f);
+	}
+	return mesh;
+}
+
+void extractFrustumPlanes(const float m[16], float planes[6][4])
+{
+	// rows of the column major matrix
+	for (int i = 0; i < 3; i++)
+	{
+		for (int side = 0; side < 2; side++)
+		{
+			float sign = side == 0 ? 1.0f : -1.0f;
+			float* plane = planes[i * 2 + side];
+			for (int c = 0; c < 4; c++)
+				plane[c] = m[c * 4 + 3] + sign * m[c * 4 + i];
+
+			float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+			for (int c = 0; c < 4; c++)
+				plane[c] /= length > 0.0f ? length : 1.0f;
+		}
+	}
+}
+
+static bool isMeshletVisible(const MeshletMesh& mesh, const CullCamera& camera, std::size_t i)
+{
+	for (int p = 0; p < 6; p++)
+	{
+		const float* plane = camera.planes[p];
+		float distance = plane[0] * mesh.centerX[i] + plane[1] * mesh.centerY[i] + plane[2] * mesh.centerZ[i] + plane[3];
+		if (distance < -mesh.radius[i])
+			return false;
+	}
+
+	// back facing when the view direction lies inside the normal cone, with the sphere as margin
+	float dx = mesh.centerX[i] - camera.position[0];
+	float dy = mesh.centerY[i] - camera.position[1];
+	float dz = mesh.centerZ[i] - camera.position[2];
+	float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+	float alongAxis = dx * mesh.axisX[i] + dy * mesh.axisY[i] + dz * mesh.axisZ[i];
+	return alongAxis < mesh.coneCutoff[i] * distance + mesh.radius[i];
+}
+
+std::size_t cullMeshletsScalar(const MeshletMesh& mesh, const CullCamera& camera, unsigned int* visible)
+{
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < mesh.meshlets.size(); i++)
+	{
+		if (isMeshletVisible(mesh, camera, i))
+			visible[count++] = (unsigned int)i;
+	}
+	return count;
+}
+
+std::size_t cullMeshlets(const MeshletMesh& mesh, const CullCamera& camera, unsigned int* visible)
+{
+#if MESHLETS_SSE
+	std::size_t count = 0;
+	__m128 camX = _mm_set1_ps(camera.position[0]);
+	__m128 camY = _mm_set1_ps(camera.position[1]);
+	__m128 camZ = _mm_set1_ps(camera.position[2]);
+
+	for (std::size_t i = 0; i < mesh.radius.size(); i += 4)
+	{
+		__m128 cx = _mm_loadu_ps(&mesh.centerX[i]);
+		__m128 cy = _mm_loadu_ps(&mesh.centerY[i]);
+		__m128 cz = _mm_loadu_ps(&mesh.centerZ[i]);
+		__m128 r = _mm_loadu_ps(&mesh.radius[i]);
+		__m128 negR = _mm_sub_ps(_mm_setzero_ps(), r);
+
+		// frustum, 4 spheres against each plane
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < 6; p++)
+		{
+			const float* plane = camera.planes[p];
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), cx), _mm_mul_ps(_mm_set1_ps(plane[1]), cy)),
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), cz), _mm_set1_ps(plane[3])));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negR));
+		}
+
+		// normal cone
+		__m128 dx = _mm_sub_ps(cx, camX);
+		__m128 dy = _mm_sub_ps(cy, camY);
+		__m128 dz = _mm_sub_ps(cz, camZ);
+		__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+		__m128 alongAxis = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(&mesh.axisX[i])), _mm_mul_ps(dy, _mm_loadu_ps(&mesh.axisY[i]))),
+			_mm_mul_ps(dz, _mm_loadu_ps(&mesh.axisZ[i])));
+		__m128 limit = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mesh.coneCutoff[i]), distance), r);
+		inside = _mm_and_ps(inside, _mm_cmplt_ps(alongAxis, limit));
+
+		int mask = _mm_movemask_ps(inside);
+		while (mask != 0)
+		{
+			int lane = 0;
+			while (!(mask & (1 << lane)))
+				lane++;
+			mask &= ~(1 << lane);
+			visible[count++] = (unsigned int)(i + lane);
+		}
+	}
+	return count;
+#else
+	return cullMeshletsScalar(mesh, camera, visible);
+#endif
+}
+
+void buildVisibleIndices(const MeshletMesh& mesh, const unsigned int* visible, std::size_t visibleCount, std::vector<unsigned int>& indices)
+{
+	indices.clear();
+	for (std::size_t i = 0; i < visibleCount; i++)
+	{
+		const Meshlet& meshlet = mesh.meshlets[visible[i]];
+		const unsigned int* first = &mesh.meshletIndices[meshlet.triangleOffset * 3];
+		indices.insert(indices.end(), first, first + meshlet.triangleCount * 3);
+	}
+}
+
+void buildVisibleDraws(const MeshletMesh& mesh, const unsigned int* visible, std::size_t visibleCount,
+	std::vector<GLsizei>& counts, std::vector<const void*>& offsets)
+{
+	counts.clear();
+	offsets.clear();
+	unsigned int rangeEnd = 0xFFFFFFFF;
+	for (std::size_t i = 0; i < visibleCount; i++)
+	{
+		const Meshlet& meshlet = mesh.meshlets[visible[i]];
+		if (!counts.empty() && meshlet.triangleOffset == rangeEnd)
+		{
+			counts.back() += (GLsizei)(meshlet.triangleCount * 3);
+		}
+		else
+		{
+			counts.push_back((GLsizei)(meshlet.triangleCount * 3));
+			offsets.push_back((const void*)((std::size_t)meshlet.triangleOffset * 3 * sizeof(unsigned int)));
+		}
+		rangeEnd = meshlet.triangleOffset + meshlet.triangleCount;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+
+// Meshlets
+// --------
+/// \note: splits an indexed mesh into small clusters (at most 64 vertices / 124 triangles)
+///		   with a bounding sphere and a normal cone each, so whole clusters can be skipped
+///		   on the CPU before anything is submitted:
+///		    - off screen: the sphere is outside one of the frustum planes
+///		    - back facing: every triangle normal in the cone faces away from the camera
+///		   Build after optimizeVertexCache, the builder walks triangles in index order.
+///		   Drawing the visible set is either one compacted index list, or glMultiDrawElements
+///		   over the static meshletIndices buffer so nothing is uploaded per frame.
+struct Meshlet
+{
+	unsigned int vertexOffset;	// into MeshletMesh::vertices
+	unsigned int triangleOffset;	// into MeshletMesh::triangles, in triangles
+	unsigned int vertexCount;
+	unsigned int triangleCount;
+};
+
+struct MeshletMesh
+{
+	static const unsigned int MAX_VERTICES = 64;
+	static const unsigned int MAX_TRIANGLES = 124;
+
+	std::vector<Meshlet> meshlets;
+	std::vector<unsigned int> vertices;	// global vertex index per meshlet vertex
+	std::vector<unsigned char> triangles;	// 3 meshlet local indices per triangle
+	std::vector<unsigned int> meshletIndices;	// global indices in meshlet order, for the EBO
+
+	// bounds in SoA, padded to a multiple of 4 so the culling loop runs 4 wide
+	std::vector<float> centerX, centerY, centerZ, radius;
+	std::vector<float> axisX, axisY, axisZ, coneCutoff;	// cutoff = sin(cone half angle), 1 never culls
+};
+
+MeshletMesh buildMeshlets(const unsigned int* indices, std::size_t indexCount,
+	const float* positions, std::size_t vertexCount, std::size_t positionStride);
+
+struct CullCamera
+{
+	float position[3];
+	float planes[6][4];	// ax + by + cz + d >= 0 inside, normalized
+};
+
+// frustum planes from a column major view projection matrix (Gribb / Hartmann)
+void extractFrustumPlanes(const float viewProjection[16], float planes[6][4]);
+
+// writes the index of every visible meshlet, returns how many. visible needs meshlets.size() slots
+std::size_t cullMeshlets(const MeshletMesh& mesh, const CullCamera& camera, unsigned int* visible);
+std::size_t cullMeshletsScalar(const MeshletMesh& mesh, const CullCamera& camera, unsigned int* visible);
+
+// one compacted index list for a single glDrawElements
+void buildVisibleIndices(const MeshletMesh& mesh, const unsigned int* visible, std::size_t visibleCount, std::vector<unsigned int>& indices);
+
+// glMultiDrawElements(GL_TRIANGLES, counts, GL_UNSIGNED_INT, offsets, n) ranges into meshletIndices,
+// neighbouring visible meshlets are merged into one range
+void buildVisibleDraws(const MeshletMesh& mesh, const unsigned int* visible, std::size_t visibleCount,
+	std::vector<GLsizei>& counts, std::vector<const void*>& offsets);
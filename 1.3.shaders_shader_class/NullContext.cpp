@@ -0,0 +1,531 @@
+#include "NullContext.h"
+#include "GLExtensions.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// every function with a stub, without the gl
+#define NULL_GL_FUNCTIONS(X) \
+	X(AttachShader) X(BeginQuery) X(BindBuffer) X(BindBufferRange) X(BindFramebuffer) \
+	X(BindRenderbuffer) X(BindTexture) X(BindVertexArray) X(BindVertexBuffer) X(BlitFramebuffer) \
+	X(BufferData) X(BufferStorage) X(BufferSubData) X(CheckFramebufferStatus) X(Clear) \
+	X(ClearColor) X(ClientWaitSync) X(CompileShader) X(CreateBuffers) X(CreateProgram) \
+	X(CreateShader) X(CreateVertexArrays) X(DeleteBuffers) X(DeleteFramebuffers) X(DeleteProgram) \
+	X(DeleteQueries) X(DeleteRenderbuffers) X(DeleteShader) X(DeleteSync) X(DeleteTextures) \
+	X(DeleteVertexArrays) X(Disable) X(DrawArrays) X(DrawElements) X(DrawElementsBaseVertex) \
+	X(Enable) X(EnableVertexArrayAttrib) X(EnableVertexAttribArray) X(EndQuery) X(FenceSync) \
+	X(Finish) X(Flush) X(FlushMappedBufferRange) X(FramebufferRenderbuffer) X(FramebufferTexture2D) \
+	X(GenBuffers) X(GenFramebuffers) X(GenQueries) X(GenRenderbuffers) X(GenTextures) \
+	X(GenVertexArrays) X(GetError) X(GetIntegerv) X(GetProgramInfoLog) X(GetProgramiv) \
+	X(GetQueryObjectiv) X(GetQueryObjectui64v) X(GetShaderInfoLog) X(GetShaderiv) X(GetString) \
+	X(GetStringi) X(GetUniformBlockIndex) X(GetUniformLocation) X(LinkProgram) X(MapBufferRange) \
+	X(MultiDrawElements) X(NamedBufferStorage) X(NamedBufferSubData) X(PixelStorei) X(PrimitiveRestartIndex) \
+	X(ProgramUniform1f) X(ProgramUniform1i) X(ProgramUniform3f) X(ProgramUniform3fv) X(QueryCounter) \
+	X(ReadPixels) X(RenderbufferStorage) X(ShaderSource) X(TexImage2D) X(TexParameteri) \
+	X(TexSubImage2D) X(Uniform1f) X(Uniform1i) X(Uniform3f) X(Uniform3fv) \
+	X(UniformBlockBinding) X(UnmapBuffer) X(UseProgram) X(VertexArrayAttribBinding) X(VertexArrayAttribFormat) \
+	X(VertexArrayAttribIFormat) X(VertexArrayElementBuffer) X(VertexArrayVertexBuffer) X(VertexAttribBinding) X(VertexAttribFormat) \
+	X(VertexAttribIFormat) X(VertexAttribIPointer) X(VertexAttribPointer) X(Viewport)
+
+enum NullGLFunction
+{
+#define NULL_GL_ENUM(name) NULL_GL_##name,
+	NULL_GL_FUNCTIONS(NULL_GL_ENUM)
+#undef NULL_GL_ENUM
+	NULL_GL_FUNCTION_COUNT
+};
+
+// GL is called from one thread only, like a real context
+static unsigned long long nullCalls[NULL_GL_FUNCTION_COUNT];
+
+// State
+// -----
+// just what the stubs need to answer plausibly
+enum NullBufferSlot
+{
+	NULL_BUFFER_ARRAY,
+	NULL_BUFFER_ELEMENT_ARRAY,
+	NULL_BUFFER_COPY_READ,
+	NULL_BUFFER_COPY_WRITE,
+	NULL_BUFFER_UNIFORM,
+	NULL_BUFFER_PIXEL_PACK,
+	NULL_BUFFER_PIXEL_UNPACK,
+	NULL_BUFFER_OTHER,
+	NULL_BUFFER_SLOTS
+};
+
+struct NullGLState
+{
+	GLuint nextName{ 1 };
+	GLuint buffers[NULL_BUFFER_SLOTS]{};
+	GLint drawFramebuffer{ 0 };
+	GLint readFramebuffer{ 0 };
+	std::unordered_map<GLuint, std::vector<char>> storage;	// what glMapBufferRange returns, by buffer
+	std::size_t nextSync{ 1 };
+	std::unordered_map<GLuint, std::string> shaderSources;
+	std::unordered_map<GLuint, std::vector<GLuint>> programShaders;
+	std::unordered_map<GLuint, std::map<std::string, GLint>> programUniforms;	// set by glLinkProgram
+};
+
+static NullGLState nullState;
+
+static int bufferSlot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER: return NULL_BUFFER_ARRAY;
+	case GL_ELEMENT_ARRAY_BUFFER: return NULL_BUFFER_ELEMENT_ARRAY;
+	case GL_COPY_READ_BUFFER: return NULL_BUFFER_COPY_READ;
+	case GL_COPY_WRITE_BUFFER: return NULL_BUFFER_COPY_WRITE;
+	case GL_UNIFORM_BUFFER: return NULL_BUFFER_UNIFORM;
+	case GL_PIXEL_PACK_BUFFER: return NULL_BUFFER_PIXEL_PACK;
+	case GL_PIXEL_UNPACK_BUFFER: return NULL_BUFFER_PIXEL_UNPACK;
+	default: return NULL_BUFFER_OTHER;
+	}
+}
+
+static void generateNames(GLsizei n, GLuint* names)
+{
+	for (GLsizei i = 0; i < n; i++)
+		names[i] = nullState.nextName++;
+}
+
+static void resizeStorage(GLuint buffer, GLsizeiptr size)
+{
+	// same size (orphaning) keeps the memory, as mapped pointers may still be in use
+	std::vector<char>& storage = nullState.storage[buffer];
+	if ((GLsizeiptr)storage.size() != size)
+		storage.resize((std::size_t)size);
+}
+
+// the names of the uniforms source declares, in order. Block members have no location, as
+// with a driver
+static void declaredUniforms(const std::string& source, std::vector<std::string>& names)
+{
+	std::vector<std::string> tokens;
+	for (std::size_t i = 0; i < source.size();)
+	{
+		char c = source[i];
+		if (c == '/' && i + 1 < source.size() && source[i + 1] == '/')
+			i = std::min(source.find('\n', i), source.size());
+		else if (c == '/' && i + 1 < source.size() && source[i + 1] == '*')
+			i = std::min(source.find("*/", i + 2), source.size() - 2) + 2;
+		else if (std::isalpha((unsigned char)c) || c == '_')
+		{
+			std::size_t start = i;
+			while (i < source.size() && (std::isalnum((unsigned char)source[i]) || source[i] == '_'))
+				i++;
+			tokens.push_back(source.substr(start, i - start));
+		}
+		else
+		{
+			if (std::strchr("{}[];,", c) != NULL)
+				tokens.push_back(std::string(1, c));
+			i++;
+		}
+	}
+
+	for (std::size_t i = 0; i < tokens.size(); i++)
+	{
+		if (tokens[i] != "uniform")
+			continue;
+		// uniform [precision] type name [, name]... ; or uniform Block { ... } [instance];
+		std::size_t at = i + 1;
+		while (at < tokens.size() && (tokens[at] == "lowp" || tokens[at] == "mediump" || tokens[at] == "highp"))
+			at++;
+		at++;
+		if (at < tokens.size() && tokens[at] == "{")
+		{
+			while (at < tokens.size() && tokens[at] != "}")
+				at++;
+			i = at;
+			continue;
+		}
+		int depth = 0;	// inside [ ], array sizes aren't names
+		bool expectName = true;
+		for (; at < tokens.size() && tokens[at] != ";"; at++)
+		{
+			if (tokens[at] == "[")
+				depth++;
+			else if (tokens[at] == "]")
+				depth--;
+			else if (tokens[at] == ",")
+				expectName = depth == 0;
+			else if (expectName && depth == 0)
+			{
+				names.push_back(tokens[at]);
+				expectName = false;
+			}
+		}
+		i = at;
+	}
+}
+
+// Stubs
+// -----
+#define NULL_GL_COUNT(name) nullCalls[NULL_GL_##name]++
+#define NULL_GL_NOOP(name, parameters) static void APIENTRY null##name parameters { NULL_GL_COUNT(name); }
+
+NULL_GL_NOOP(BeginQuery, (GLenum, GLuint))
+NULL_GL_NOOP(BindBufferRange, (GLenum, GLuint, GLuint, GLintptr, GLsizeiptr))
+NULL_GL_NOOP(BindRenderbuffer, (GLenum, GLuint))
+NULL_GL_NOOP(BindTexture, (GLenum, GLuint))
+NULL_GL_NOOP(BindVertexArray, (GLuint))
+NULL_GL_NOOP(BindVertexBuffer, (GLuint, GLuint, GLintptr, GLsizei))
+NULL_GL_NOOP(BlitFramebuffer, (GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum))
+NULL_GL_NOOP(BufferSubData, (GLenum, GLintptr, GLsizeiptr, const void*))
+NULL_GL_NOOP(Clear, (GLbitfield))
+NULL_GL_NOOP(ClearColor, (GLfloat, GLfloat, GLfloat, GLfloat))
+NULL_GL_NOOP(CompileShader, (GLuint))
+NULL_GL_NOOP(DeleteFramebuffers, (GLsizei, const GLuint*))
+NULL_GL_NOOP(DeleteQueries, (GLsizei, const GLuint*))
+NULL_GL_NOOP(DeleteRenderbuffers, (GLsizei, const GLuint*))
+NULL_GL_NOOP(DeleteSync, (GLsync))
+NULL_GL_NOOP(DeleteTextures, (GLsizei, const GLuint*))
+NULL_GL_NOOP(DeleteVertexArrays, (GLsizei, const GLuint*))
+NULL_GL_NOOP(Disable, (GLenum))
+NULL_GL_NOOP(DrawArrays, (GLenum, GLint, GLsizei))
+NULL_GL_NOOP(DrawElements, (GLenum, GLsizei, GLenum, const void*))
+NULL_GL_NOOP(DrawElementsBaseVertex, (GLenum, GLsizei, GLenum, const void*, GLint))
+NULL_GL_NOOP(Enable, (GLenum))
+NULL_GL_NOOP(EnableVertexArrayAttrib, (GLuint, GLuint))
+NULL_GL_NOOP(EnableVertexAttribArray, (GLuint))
+NULL_GL_NOOP(EndQuery, (GLenum))
+NULL_GL_NOOP(Finish, ())
+NULL_GL_NOOP(Flush, ())
+NULL_GL_NOOP(FlushMappedBufferRange, (GLenum, GLintptr, GLsizeiptr))
+NULL_GL_NOOP(FramebufferRenderbuffer, (GLenum, GLenum, GLenum, GLuint))
+NULL_GL_NOOP(FramebufferTexture2D, (GLenum, GLenum, GLenum, GLuint, GLint))
+NULL_GL_NOOP(MultiDrawElements, (GLenum, const GLsizei*, GLenum, const void* const*, GLsizei))
+NULL_GL_NOOP(NamedBufferSubData, (GLuint, GLintptr, GLsizeiptr, const void*))
+NULL_GL_NOOP(PixelStorei, (GLenum, GLint))
+NULL_GL_NOOP(PrimitiveRestartIndex, (GLuint))
+NULL_GL_NOOP(ProgramUniform1f, (GLuint, GLint, GLfloat))
+NULL_GL_NOOP(ProgramUniform1i, (GLuint, GLint, GLint))
+NULL_GL_NOOP(ProgramUniform3f, (GLuint, GLint, GLfloat, GLfloat, GLfloat))
+NULL_GL_NOOP(ProgramUniform3fv, (GLuint, GLint, GLsizei, const GLfloat*))
+NULL_GL_NOOP(QueryCounter, (GLuint, GLenum))
+NULL_GL_NOOP(ReadPixels, (GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*))
+NULL_GL_NOOP(RenderbufferStorage, (GLenum, GLenum, GLsizei, GLsizei))
+NULL_GL_NOOP(TexImage2D, (GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*))
+NULL_GL_NOOP(TexParameteri, (GLenum, GLenum, GLint))
+NULL_GL_NOOP(TexSubImage2D, (GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const void*))
+NULL_GL_NOOP(Uniform1f, (GLint, GLfloat))
+NULL_GL_NOOP(Uniform1i, (GLint, GLint))
+NULL_GL_NOOP(Uniform3f, (GLint, GLfloat, GLfloat, GLfloat))
+NULL_GL_NOOP(Uniform3fv, (GLint, GLsizei, const GLfloat*))
+NULL_GL_NOOP(UniformBlockBinding, (GLuint, GLuint, GLuint))
+NULL_GL_NOOP(UseProgram, (GLuint))
+NULL_GL_NOOP(VertexArrayAttribBinding, (GLuint, GLuint, GLuint))
+NULL_GL_NOOP(VertexArrayAttribFormat, (GLuint, GLuint, GLint, GLenum, GLboolean, GLuint))
+NULL_GL_NOOP(VertexArrayAttribIFormat, (GLuint, GLuint, GLint, GLenum, GLuint))
+NULL_GL_NOOP(VertexArrayElementBuffer, (GLuint, GLuint))
+NULL_GL_NOOP(VertexArrayVertexBuffer, (GLuint, GLuint, GLuint, GLintptr, GLsizei))
+NULL_GL_NOOP(VertexAttribBinding, (GLuint, GLuint))
+NULL_GL_NOOP(VertexAttribFormat, (GLuint, GLint, GLenum, GLboolean, GLuint))
+NULL_GL_NOOP(VertexAttribIFormat, (GLuint, GLint, GLenum, GLuint))
+NULL_GL_NOOP(VertexAttribIPointer, (GLuint, GLint, GLenum, GLsizei, const void*))
+NULL_GL_NOOP(VertexAttribPointer, (GLuint, GLint, GLenum, GLboolean, GLsizei, const void*))
+NULL_GL_NOOP(Viewport, (GLint, GLint, GLsizei, GLsizei))
+#undef NULL_GL_NOOP
+
+// names
+static void APIENTRY nullGenBuffers(GLsizei n, GLuint* names) { NULL_GL_COUNT(GenBuffers); generateNames(n, names); }
+static void APIENTRY nullGenFramebuffers(GLsizei n, GLuint* names) { NULL_GL_COUNT(GenFramebuffers); generateNames(n, names); }
+static void APIENTRY nullGenQueries(GLsizei n, GLuint* names) { NULL_GL_COUNT(GenQueries); generateNames(n, names); }
+static void APIENTRY nullGenRenderbuffers(GLsizei n, GLuint* names) { NULL_GL_COUNT(GenRenderbuffers); generateNames(n, names); }
+static void APIENTRY nullGenTextures(GLsizei n, GLuint* names) { NULL_GL_COUNT(GenTextures); generateNames(n, names); }
+static void APIENTRY nullGenVertexArrays(GLsizei n, GLuint* names) { NULL_GL_COUNT(GenVertexArrays); generateNames(n, names); }
+static void APIENTRY nullCreateBuffers(GLsizei n, GLuint* names) { NULL_GL_COUNT(CreateBuffers); generateNames(n, names); }
+static void APIENTRY nullCreateVertexArrays(GLsizei n, GLuint* names) { NULL_GL_COUNT(CreateVertexArrays); generateNames(n, names); }
+static GLuint APIENTRY nullCreateProgram() { NULL_GL_COUNT(CreateProgram); return nullState.nextName++; }
+static GLuint APIENTRY nullCreateShader(GLenum) { NULL_GL_COUNT(CreateShader); return nullState.nextName++; }
+
+// buffers
+static void APIENTRY nullBindBuffer(GLenum target, GLuint buffer)
+{
+	NULL_GL_COUNT(BindBuffer);
+	nullState.buffers[bufferSlot(target)] = buffer;
+}
+
+static void APIENTRY nullBufferData(GLenum target, GLsizeiptr size, const void*, GLenum)
+{
+	NULL_GL_COUNT(BufferData);
+	resizeStorage(nullState.buffers[bufferSlot(target)], size);
+}
+
+static void APIENTRY nullBufferStorage(GLenum target, GLsizeiptr size, const void*, GLbitfield)
+{
+	NULL_GL_COUNT(BufferStorage);
+	resizeStorage(nullState.buffers[bufferSlot(target)], size);
+}
+
+static void APIENTRY nullNamedBufferStorage(GLuint buffer, GLsizeiptr size, const void*, GLbitfield)
+{
+	NULL_GL_COUNT(NamedBufferStorage);
+	resizeStorage(buffer, size);
+}
+
+static void APIENTRY nullDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	NULL_GL_COUNT(DeleteBuffers);
+	for (GLsizei i = 0; i < n; i++)
+		nullState.storage.erase(buffers[i]);
+}
+
+static void* APIENTRY nullMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield)
+{
+	NULL_GL_COUNT(MapBufferRange);
+	std::vector<char>& storage = nullState.storage[nullState.buffers[bufferSlot(target)]];
+	if ((GLsizeiptr)storage.size() < offset + length)
+		storage.resize((std::size_t)(offset + length));
+	return storage.data() + offset;
+}
+
+static GLboolean APIENTRY nullUnmapBuffer(GLenum) { NULL_GL_COUNT(UnmapBuffer); return GL_TRUE; }
+
+// framebuffers
+static void APIENTRY nullBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	NULL_GL_COUNT(BindFramebuffer);
+	if (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER)
+		nullState.drawFramebuffer = (GLint)framebuffer;
+	if (target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER)
+		nullState.readFramebuffer = (GLint)framebuffer;
+}
+
+static GLenum APIENTRY nullCheckFramebufferStatus(GLenum) { NULL_GL_COUNT(CheckFramebufferStatus); return GL_FRAMEBUFFER_COMPLETE; }
+
+// sync and queries: always done, the GPU time is 0
+static GLsync APIENTRY nullFenceSync(GLenum, GLbitfield) { NULL_GL_COUNT(FenceSync); return (GLsync)nullState.nextSync++; }
+static GLenum APIENTRY nullClientWaitSync(GLsync, GLbitfield, GLuint64) { NULL_GL_COUNT(ClientWaitSync); return GL_ALREADY_SIGNALED; }
+
+static void APIENTRY nullGetQueryObjectiv(GLuint, GLenum pname, GLint* params)
+{
+	NULL_GL_COUNT(GetQueryObjectiv);
+	*params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+static void APIENTRY nullGetQueryObjectui64v(GLuint, GLenum, GLuint64* params) { NULL_GL_COUNT(GetQueryObjectui64v); *params = 0; }
+
+// programs: everything compiles and links. Uniforms get locations at link, 0, 1, ... per
+// program in declaration order, -1 for a name none of its shaders declares. That keeps
+// per location state (the Shader uniform shadows) as it is on a driver
+static void APIENTRY nullShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+	NULL_GL_COUNT(ShaderSource);
+	std::string& source = nullState.shaderSources[shader];
+	source.clear();
+	for (GLsizei i = 0; i < count; i++)
+	{
+		if (length != NULL && length[i] >= 0)
+			source.append(string[i], (std::size_t)length[i]);
+		else
+			source.append(string[i]);
+	}
+}
+
+static void APIENTRY nullDeleteShader(GLuint shader)
+{
+	NULL_GL_COUNT(DeleteShader);
+	nullState.shaderSources.erase(shader);
+}
+
+static void APIENTRY nullAttachShader(GLuint program, GLuint shader)
+{
+	NULL_GL_COUNT(AttachShader);
+	nullState.programShaders[program].push_back(shader);
+}
+
+static void APIENTRY nullLinkProgram(GLuint program)
+{
+	NULL_GL_COUNT(LinkProgram);
+	std::map<std::string, GLint>& uniforms = nullState.programUniforms[program];
+	uniforms.clear();
+	for (GLuint shader : nullState.programShaders[program])
+	{
+		std::vector<std::string> names;
+		declaredUniforms(nullState.shaderSources[shader], names);
+		// declared by both stages is one uniform
+		for (const std::string& name : names)
+			uniforms.insert(std::make_pair(name, (GLint)uniforms.size()));
+	}
+}
+
+static void APIENTRY nullDeleteProgram(GLuint program)
+{
+	NULL_GL_COUNT(DeleteProgram);
+	nullState.programShaders.erase(program);
+	nullState.programUniforms.erase(program);
+}
+
+static void APIENTRY nullGetShaderiv(GLuint, GLenum pname, GLint* params)
+{
+	NULL_GL_COUNT(GetShaderiv);
+	*params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+static void APIENTRY nullGetProgramiv(GLuint, GLenum pname, GLint* params)
+{
+	NULL_GL_COUNT(GetProgramiv);
+	*params = pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS ? GL_TRUE : 0;
+}
+
+static void APIENTRY nullGetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	NULL_GL_COUNT(GetShaderInfoLog);
+	if (length != NULL)
+		*length = 0;
+	if (bufSize > 0)
+		infoLog[0] = '\0';
+}
+
+static void APIENTRY nullGetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	NULL_GL_COUNT(GetProgramInfoLog);
+	if (length != NULL)
+		*length = 0;
+	if (bufSize > 0)
+		infoLog[0] = '\0';
+}
+
+static GLint APIENTRY nullGetUniformLocation(GLuint program, const GLchar* name)
+{
+	NULL_GL_COUNT(GetUniformLocation);
+	std::unordered_map<GLuint, std::map<std::string, GLint>>::const_iterator uniforms = nullState.programUniforms.find(program);
+	if (uniforms == nullState.programUniforms.end())
+		return -1;
+	std::map<std::string, GLint>::const_iterator it = uniforms->second.find(name);
+	return it != uniforms->second.end() ? it->second : -1;
+}
+
+static GLuint APIENTRY nullGetUniformBlockIndex(GLuint, const GLchar*) { NULL_GL_COUNT(GetUniformBlockIndex); return 0; }
+
+// queries
+static GLenum APIENTRY nullGetError() { NULL_GL_COUNT(GetError); return GL_NO_ERROR; }
+
+static void APIENTRY nullGetIntegerv(GLenum pname, GLint* data)
+{
+	NULL_GL_COUNT(GetIntegerv);
+	switch (pname)
+	{
+	case GL_MAJOR_VERSION: *data = 3; break;
+	case GL_MINOR_VERSION: *data = 3; break;
+	case GL_MAX_VERTEX_ATTRIBS: *data = 16; break;
+	case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT: *data = 256; break;
+	case GL_NUM_EXTENSIONS: *data = 1; break;
+	case GL_DRAW_FRAMEBUFFER_BINDING: *data = nullState.drawFramebuffer; break;
+	case GL_READ_FRAMEBUFFER_BINDING: *data = nullState.readFramebuffer; break;
+	default: *data = 0; break;	// GL_CONTEXT_FLAGS among them
+	}
+}
+
+static const GLubyte* APIENTRY nullGetString(GLenum name)
+{
+	NULL_GL_COUNT(GetString);
+	switch (name)
+	{
+	case GL_VERSION: return (const GLubyte*)"3.3 (null)";
+	case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"3.30";
+	case GL_VENDOR: return (const GLubyte*)"learn_opengl";
+	case GL_RENDERER: return (const GLubyte*)"null";
+	default: return (const GLubyte*)"";
+	}
+}
+
+// one made up extension, glad refuses a 3.x context without any
+static const GLubyte* APIENTRY nullGetStringi(GLenum name, GLuint index)
+{
+	NULL_GL_COUNT(GetStringi);
+	return name == GL_EXTENSIONS && index == 0 ? (const GLubyte*)"GL_LEARNOPENGL_null" : NULL;
+}
+#undef NULL_GL_COUNT
+
+// Loader
+// ------
+struct NullGLEntry
+{
+	const char* name;
+	void* function;
+};
+
+static const NullGLEntry NULL_GL_ENTRIES[] =
+{
+#define NULL_GL_ENTRY(name) { "gl" #name, (void*)null##name },
+	NULL_GL_FUNCTIONS(NULL_GL_ENTRY)
+#undef NULL_GL_ENTRY
+};
+
+void* nullGLGetProcAddress(const char* name)
+{
+	for (const NullGLEntry& entry : NULL_GL_ENTRIES)
+	{
+		if (std::strcmp(entry.name, name) == 0)
+			return entry.function;
+	}
+	return NULL;
+}
+
+void resetNullGLCalls()
+{
+	std::fill(nullCalls, nullCalls + NULL_GL_FUNCTION_COUNT, 0ull);
+}
+
+void printNullGLCalls(int frames)
+{
+	std::vector<int> called;
+	unsigned long long total = 0;
+	for (int i = 0; i < NULL_GL_FUNCTION_COUNT; i++)
+	{
+		total += nullCalls[i];
+		if (nullCalls[i] > 0)
+			called.push_back(i);
+	}
+	std::stable_sort(called.begin(), called.end(), [](int a, int b) { return nullCalls[a] > nullCalls[b]; });
+
+	double perFrame = frames > 0 ? 1.0 / frames : 0.0;
+	std::cout << "NULLGL::CALLS frames=" << frames << " total=" << total << " per_frame=" << total * perFrame << std::endl;
+	for (int i : called)
+	{
+		std::cout << "NULLGL::CALL name=" << NULL_GL_ENTRIES[i].name << " calls=" << nullCalls[i]
+			<< " per_frame=" << nullCalls[i] * perFrame << std::endl;
+	}
+}
+
+#undef NULL_GL_FUNCTIONS
+
+// Null context
+// ------------
+NullContext::NullContext(const ContextOptions& options)
+	: width(options.width), height(options.height), frameLimit(options.frames), frame(0)
+{
+}
+
+NullContext::~NullContext()
+{
+	printNullGLCalls(frame);
+	nullState = NullGLState();
+}
+
+ContextProvider* createNullContext(const ContextOptions& options)
+{
+	resetNullGLCalls();
+	if (!gladLoadGLLoader((GLADloadproc)nullGLGetProcAddress))
+	{
+		std::cout << "Failed to load GLAD!" << std::endl;
+		return NULL;
+	}
+	loadGLExtensions((GLADloadproc)nullGLGetProcAddress);
+
+	NullContext* context = new NullContext(options);
+	glViewport(0, 0, options.width, options.height);
+	std::cout << "Context: OpenGL " << glGetString(GL_VERSION) << " on " << glGetString(GL_RENDERER)
+		<< " (no GL, " << options.width << "x" << options.height << ")" << std::endl;
+	return context;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "Context.h"
+
+// Null GL
+// -------
+/// \note: a GL that does nothing, to measure what is left: our own CPU cost (uniform
+///		   lookups, state tracking, scene traversal) with no driver time mixed in, on any
+///		   machine. glad is loaded through nullGLGetProcAddress(), which hands out stubs that
+///		   count their calls and return plausible results: fresh names from glGen* / glCreate*,
+///		   complete framebuffers, compiled and linked programs, signaled fences, writable
+///		   memory from glMapBufferRange, a location per uniform its shaders declare (-1 for
+///		   any other name, though a driver also drops unused ones). glGetString reports
+///		   3.3 and no real extension, so the 3.3 code paths run. GPU timer queries read 0 and
+///		   glReadPixels writes nothing, so golden tests can't pass on it.
+///		   Only the functions this project calls have a stub, the others stay NULL as they
+///		   would with a driver lacking them: add one here when the code starts calling it.
+///
+///		   --null-gl [--frames 1000] [--scene 1.3.shaders --profile]
+void* nullGLGetProcAddress(const char* name);
+
+// NULLGL::CALLS with the total, then a NULLGL::CALL line per function called, most first
+void printNullGLCalls(int frames);
+void resetNullGLCalls();
+
+// Null context
+// ------------
+/// \note: the ContextProvider for it, otherwise a HeadlessContext: no window, options.frames
+///		   frames, the time follows the frame count. waitEvents() doesn't sleep, there is no
+///		   GPU to wait for. Prints the call counts when deleted.
+class NullContext : public ContextProvider
+{
+	int width, height;
+	int frameLimit;
+	int frame;
+
+public:
+	NullContext(const ContextOptions& options);
+	~NullContext();
+
+	NullContext(const NullContext&) = delete;
+	NullContext& operator=(const NullContext&) = delete;
+
+	bool shouldClose() const override { return frame >= frameLimit; }
+	void pollEvents() override {}
+	void waitEvents(double) override { frame++; }
+	void swapBuffers() override { frame++; }
+
+	bool setSwapInterval(int) override { return false; }
+	bool supportsAdaptiveSync() const override { return false; }
+	double getRefreshRate() const override { return 60.0; }
+	double getTime() const override { return frame / getRefreshRate(); }
+
+	int getWidth() const override { return width; }
+	int getHeight() const override { return height; }
+
+	int getFrame() const { return frame; }
+};
+
+// loads glad (and the GLExtensions) with the stubs. NULL if that fails
+ContextProvider* createNullContext(const ContextOptions& options);
@@ -0,0 +1,204 @@
+#include "RedrawScheduler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+RedrawOptions parseRedrawOptions(int argc, char* argv[], RedrawOptions options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--on-demand") == 0)
+			options.onDemand = true;
+		else if (std::strcmp(argv[i], "--animation-rate") == 0 && i + 1 < argc)
+			options.animationRate = std::atof(argv[++i]);
+	}
+	return options;
+}
+
+double processCpuSeconds()
+{
+#ifdef _WIN32
+	FILETIME created, exited, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user))
+		return 0.0;
+	// 100ns units
+	unsigned long long kernelTicks = ((unsigned long long)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+	unsigned long long userTicks = ((unsigned long long)user.dwHighDateTime << 32) | user.dwLowDateTime;
+	return (kernelTicks + userTicks) * 1e-7;
+#else
+	timespec time;
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0)
+		return 0.0;
+	return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+}
+
+// Callbacks
+// ---------
+/// \note: GLFW has one callback slot per event, so whatever was installed before is kept and
+///		   called first. The active scheduler is file static rather than the window user
+///		   pointer, which stays free for the application.
+static RedrawScheduler* activeScheduler = NULL;
+static GLFWkeyfun previousKey = NULL;
+static GLFWmousebuttonfun previousMouseButton = NULL;
+static GLFWscrollfun previousScroll = NULL;
+static GLFWwindowrefreshfun previousRefresh = NULL;
+
+static void redrawKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	if (previousKey != NULL)
+		previousKey(window, key, scancode, action, mods);
+	if (activeScheduler != NULL)
+		activeScheduler->requestRedraw();
+}
+
+static void redrawMouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+{
+	if (previousMouseButton != NULL)
+		previousMouseButton(window, button, action, mods);
+	if (activeScheduler != NULL)
+		activeScheduler->requestRedraw();
+}
+
+static void redrawScrollCallback(GLFWwindow* window, double x, double y)
+{
+	if (previousScroll != NULL)
+		previousScroll(window, x, y);
+	if (activeScheduler != NULL)
+		activeScheduler->requestRedraw();
+}
+
+static void redrawRefreshCallback(GLFWwindow* window)
+{
+	if (previousRefresh != NULL)
+		previousRefresh(window);
+	if (activeScheduler != NULL)
+		activeScheduler->requestRedraw();
+}
+
+// Redraw scheduler
+// ----------------
+RedrawScheduler::RedrawScheduler(ContextProvider& context, const RedrawOptions& options)
+	: context(context), options(options), animated(false), dirty(true), idled(false), resumed(false),
+	width(context.getWidth()), height(context.getHeight()),
+	nextAnimationFrame(clock::now()), start(clock::now()), cpuStart(processCpuSeconds())
+{
+	GLFWwindow* window = context.getWindow();
+	if (options.onDemand && window != NULL)
+	{
+		activeScheduler = this;
+		previousKey = glfwSetKeyCallback(window, redrawKeyCallback);
+		previousMouseButton = glfwSetMouseButtonCallback(window, redrawMouseButtonCallback);
+		previousScroll = glfwSetScrollCallback(window, redrawScrollCallback);
+		previousRefresh = glfwSetWindowRefreshCallback(window, redrawRefreshCallback);
+	}
+}
+
+RedrawScheduler::~RedrawScheduler()
+{
+	if (activeScheduler != this)
+		return;
+
+	GLFWwindow* window = context.getWindow();
+	glfwSetKeyCallback(window, previousKey);
+	glfwSetMouseButtonCallback(window, previousMouseButton);
+	glfwSetScrollCallback(window, previousScroll);
+	glfwSetWindowRefreshCallback(window, previousRefresh);
+	activeScheduler = NULL;
+}
+
+void RedrawScheduler::setAnimated(bool animated)
+{
+	if (animated && !this->animated)
+		nextAnimationFrame = clock::now();
+	this->animated = animated;
+}
+
+bool RedrawScheduler::needsRedraw(clock::time_point now)
+{
+	// the framebuffer size callback belongs to the application, so resizes are seen by polling
+	int newWidth = context.getWidth();
+	int newHeight = context.getHeight();
+	if (newWidth != width || newHeight != height)
+	{
+		width = newWidth;
+		height = newHeight;
+		dirty = true;
+	}
+	return dirty || (animated && now >= nextAnimationFrame);
+}
+
+bool RedrawScheduler::waitForRedraw()
+{
+	if (!options.onDemand)
+	{
+		stats.frames++;
+		return true;
+	}
+
+	clock::time_point now = clock::now();
+	if (!needsRedraw(now))
+	{
+		double timeout = options.idleTimeout;
+		if (animated)
+			timeout = std::min(timeout, std::chrono::duration<double>(nextAnimationFrame - now).count());
+
+		double cpuBefore = processCpuSeconds();
+		context.waitEvents(std::max(timeout, 0.0));
+		clock::time_point woken = clock::now();
+		stats.idleCpuSeconds += processCpuSeconds() - cpuBefore;
+		stats.idleWallSeconds += std::chrono::duration<double>(woken - now).count();
+		stats.wakeups++;
+		idled = idled || !animated;
+
+		now = woken;
+		if (!needsRedraw(now))
+			return false;
+	}
+
+	if (animated)
+	{
+		double rate = options.animationRate > 0.0 ? options.animationRate : context.getRefreshRate();
+		clock::duration interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / rate));
+		// a late frame reschedules from now instead of bursting to catch up
+		nextAnimationFrame = std::max(nextAnimationFrame + interval, now);
+	}
+	dirty = false;
+	resumed = idled;
+	idled = false;
+	stats.frames++;
+	return true;
+}
+
+RedrawStats RedrawScheduler::getStats() const
+{
+	RedrawStats current = stats;
+	current.wallSeconds = std::chrono::duration<double>(clock::now() - start).count();
+	current.cpuSeconds = processCpuSeconds() - cpuStart;
+	return current;
+}
+
+void RedrawScheduler::printStats() const
+{
+	RedrawStats current = getStats();
+	double cpuPercent = current.wallSeconds > 0.0 ? 100.0 * current.cpuSeconds / current.wallSeconds : 0.0;
+	double idlePercent = current.idleWallSeconds > 0.0 ? 100.0 * current.idleCpuSeconds / current.idleWallSeconds : 0.0;
+	std::cout << "REDRAW::" << (options.onDemand ? "on_demand" : "continuous")
+		<< " animated=" << (animated ? 1 : 0)
+		<< " frames=" << current.frames
+		<< " wakeups=" << current.wakeups
+		<< " wall_s=" << current.wallSeconds
+		<< " cpu_percent=" << cpuPercent
+		<< " idle_s=" << current.idleWallSeconds
+		<< " idle_cpu_percent=" << idlePercent << std::endl;
+}
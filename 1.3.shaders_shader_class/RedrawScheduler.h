@@ -0,0 +1,94 @@
+#pragma once
+#include <chrono>
+
+#include "Context.h"
+
+// Redraw options
+// --------------
+/// \note: continuous redraws every loop iteration, as fast as the pacer allows. onDemand
+///		   blocks in waitEvents() and only redraws after input, a resize, a window refresh
+///		   request (exposed after being covered), requestRedraw(), or, while the scene is
+///		   animated, the next animation frame.
+struct RedrawOptions
+{
+	bool onDemand{ false };
+	double animationRate{ 0.0 };	// redraws per second while animated, 0 = refresh rate
+	double idleTimeout{ 1.0 };		// longest single wait, seconds
+};
+
+// reads --on-demand and --animation-rate <fps>
+RedrawOptions parseRedrawOptions(int argc, char* argv[], RedrawOptions options);
+
+struct RedrawStats
+{
+	unsigned long long frames{ 0 };		// redraws
+	unsigned long long wakeups{ 0 };	// waits that returned, with or without a redraw
+	double wallSeconds{ 0.0 };
+	double cpuSeconds{ 0.0 };			// whole process, driver threads included
+	double idleWallSeconds{ 0.0 };		// inside waitEvents()
+	double idleCpuSeconds{ 0.0 };
+};
+
+// Redraw scheduler
+// ----------------
+/// \note: decides whether the loop draws this iteration. A scene is animated when it reads
+///		   something time dependent, e.g. uTime being active in the linked program
+///		   (glGetUniformLocation is -1 for a uniform the compiler dropped):
+///
+///		   redraw.setAnimated(shader.getUniformLocation("uTime") != -1);
+///		   while (!context->shouldClose())
+///		   {
+///			if (!redraw.waitForRedraw())
+///				continue;
+///			... draw and swap ...
+///		   }
+///
+///		   Input and refresh callbacks are installed on the window, the previous ones
+///		   still get called. Only one scheduler can be alive at a time.
+class RedrawScheduler
+{
+	typedef std::chrono::steady_clock clock;
+
+	ContextProvider& context;
+	RedrawOptions options;
+	bool animated;
+	bool dirty;
+	bool idled;			// slept with nothing animated since the last redraw
+	bool resumed;
+	int width, height;
+	clock::time_point nextAnimationFrame;
+
+	clock::time_point start;
+	double cpuStart;
+	RedrawStats stats;
+
+public:
+	RedrawScheduler(ContextProvider& context, const RedrawOptions& options);
+	~RedrawScheduler();
+
+	RedrawScheduler(const RedrawScheduler&) = delete;
+	RedrawScheduler& operator=(const RedrawScheduler&) = delete;
+
+	void setAnimated(bool animated);
+	// the next waitForRedraw() returns true without waiting
+	void requestRedraw() { dirty = true; }
+
+	// continuous: always true and doesn't touch events. onDemand: handles events, waiting
+	// up to the next animation frame (or idleTimeout), true when something needs a redraw.
+	// false just means the loop should check shouldClose() and call it again
+	bool waitForRedraw();
+
+	bool isOnDemand() const { return options.onDemand; }
+	// true when this redraw ends an idle wait (nothing animated): the time since the last
+	// frame was spent asleep and shouldn't be simulated, see FixedTimestep::resync()
+	bool resumedFromIdle() const { return resumed; }
+	RedrawStats getStats() const;
+	// REDRAW:: line with frames, wakeups, CPU usage overall and while idle
+	void printStats() const;
+
+private:
+	bool needsRedraw(clock::time_point now);
+};
+
+// CPU time used by the whole process since it started, seconds
+double processCpuSeconds();
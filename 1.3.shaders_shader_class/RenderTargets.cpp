@@ -0,0 +1,131 @@
+#include "RenderTargets.h"
+#include "GLDebug.h"
+
+#include <algorithm>
+#include <iostream>
+
+// bytes per pixel of storage: RGBA8 color + D24S8 depth/stencil
+static const std::size_t TARGET_PIXEL_BYTES = 8;
+
+RenderTargetPool::RenderTargetPool(int bucket)
+	: bucket(bucket < 1 ? 1 : bucket)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+	for (Slot& slot : slots)
+	{
+		destroy(slot.target);
+	}
+}
+
+int RenderTargetPool::roundUp(int size) const
+{
+	return (std::max(size, 1) + bucket - 1) / bucket * bucket;
+}
+
+void RenderTargetPool::allocate(RenderTarget& target, int width, int height)
+{
+	// storage never shrinks, a target that was wide and is now tall keeps both
+	int allocatedWidth = std::max(target.allocatedWidth, roundUp(width));
+	int allocatedHeight = std::max(target.allocatedHeight, roundUp(height));
+	destroy(target);
+
+	glGenRenderbuffers(1, &target.colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, target.colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, allocatedWidth, allocatedHeight);
+	glGenRenderbuffers(1, &target.depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, target.depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, allocatedWidth, allocatedHeight);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	// bound on the draw target only, so whatever is bound for drawing is put back below
+	GLint previous;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+	glGenFramebuffers(1, &target.FBO);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target.FBO);
+	glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.colorBuffer);
+	glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depthBuffer);
+	if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::RENDER_TARGET::FRAMEBUFFER_INCOMPLETE " << allocatedWidth << "x" << allocatedHeight << std::endl;
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previous);
+	glCheckError();
+
+	target.allocatedWidth = allocatedWidth;
+	target.allocatedHeight = allocatedHeight;
+	stats.allocations++;
+	stats.bytes += (std::size_t)allocatedWidth * allocatedHeight * TARGET_PIXEL_BYTES;
+}
+
+void RenderTargetPool::destroy(RenderTarget& target)
+{
+	if (target.FBO == 0)
+		return;
+	glDeleteFramebuffers(1, &target.FBO);
+	glDeleteRenderbuffers(1, &target.colorBuffer);
+	glDeleteRenderbuffers(1, &target.depthBuffer);
+	stats.bytes -= (std::size_t)target.allocatedWidth * target.allocatedHeight * TARGET_PIXEL_BYTES;
+	target.FBO = target.colorBuffer = target.depthBuffer = 0;
+}
+
+int RenderTargetPool::acquire(int width, int height)
+{
+	int fitting = -1, largest = -1, empty = -1;
+	for (std::size_t i = 0; i < slots.size(); i++)
+	{
+		const Slot& slot = slots[i];
+		if (slot.inUse)
+			continue;
+		const RenderTarget& target = slot.target;
+		if (target.FBO == 0)
+		{
+			empty = (int)i;
+			continue;
+		}
+		long long area = (long long)target.allocatedWidth * target.allocatedHeight;
+		if (target.allocatedWidth >= width && target.allocatedHeight >= height
+			&& (fitting < 0 || area < (long long)get(fitting).allocatedWidth * get(fitting).allocatedHeight))
+			fitting = (int)i;
+		if (largest < 0 || area > (long long)get(largest).allocatedWidth * get(largest).allocatedHeight)
+			largest = (int)i;
+	}
+
+	int chosen = fitting >= 0 ? fitting : largest >= 0 ? largest : empty;
+	if (chosen < 0)
+	{
+		slots.push_back(Slot{ RenderTarget(), false });
+		chosen = (int)slots.size() - 1;
+	}
+
+	slots[chosen].inUse = true;
+	resize(chosen, width, height);
+	return chosen;
+}
+
+void RenderTargetPool::release(int target)
+{
+	slots[target].inUse = false;
+}
+
+void RenderTargetPool::resize(int target, int width, int height)
+{
+	RenderTarget& t = slots[target].target;
+	if (t.FBO != 0 && width <= t.allocatedWidth && height <= t.allocatedHeight)
+		stats.reuses++;
+	else
+		allocate(t, width, height);
+	t.width = width;
+	t.height = height;
+}
+
+void RenderTargetPool::trim()
+{
+	for (Slot& slot : slots)
+	{
+		if (slot.inUse)
+			continue;
+		destroy(slot.target);
+		slot.target = RenderTarget();
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <glad/glad.h>
+
+// Render target pool
+// ------------------
+/// \note: offscreen color (RGBA8) + depth/stencil (D24S8) targets whose storage is rounded up
+///		   to a multiple of bucket and never shrinks. A target is used at any size up to its
+///		   storage (render with a width x height viewport, blit from that corner), so a
+///		   window dragged back and forth only reallocates when it crosses into a bucket it
+///		   has never been in. Released targets keep their storage for the next acquire().
+///
+///		   RenderTargetPool pool;
+///		   int scene = pool.acquire(width, height);
+///		   glBindFramebuffer(GL_FRAMEBUFFER, pool.get(scene).FBO);
+///		   ...
+///		   pool.resize(scene, newWidth, newHeight);   // usually no reallocation
+struct RenderTarget
+{
+	unsigned int FBO{ 0 };
+	unsigned int colorBuffer{ 0 };
+	unsigned int depthBuffer{ 0 };
+	int width{ 0 };				// in use
+	int height{ 0 };
+	int allocatedWidth{ 0 };	// storage
+	int allocatedHeight{ 0 };
+};
+
+struct RenderTargetStats
+{
+	unsigned long long allocations{ 0 };	// storage (re)allocations
+	unsigned long long reuses{ 0 };			// acquire / resize served by existing storage
+	std::size_t bytes{ 0 };					// storage currently held
+};
+
+class RenderTargetPool
+{
+	struct Slot
+	{
+		RenderTarget target;
+		bool inUse;
+	};
+
+	std::vector<Slot> slots;	// indices are the handles, trimmed slots stay as empty entries
+	int bucket;
+	RenderTargetStats stats;
+
+public:
+	RenderTargetPool(int bucket = 256);
+	~RenderTargetPool();
+
+	RenderTargetPool(const RenderTargetPool&) = delete;
+	RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+	// the free target that fits with the least storage, else the largest free one grown,
+	// else a new one. returns its handle
+	int acquire(int width, int height);
+	void release(int target);
+	// changes the size in use, reallocating only when it doesn't fit the storage
+	void resize(int target, int width, int height);
+	// frees the storage of released targets
+	void trim();
+
+	const RenderTarget& get(int target) const { return slots[target].target; }
+	RenderTargetStats getStats() const { return stats; }
+
+private:
+	int roundUp(int size) const;
+	void allocate(RenderTarget& target, int width, int height);
+	void destroy(RenderTarget& target);
+};
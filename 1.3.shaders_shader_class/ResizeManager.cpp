@@ -0,0 +1,152 @@
+#include "ResizeManager.h"
+#include "GLDebug.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+ResizeOptions parseResizeOptions(int argc, char* argv[], ResizeOptions options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--offscreen") == 0)
+			options.offscreen = true;
+		else if (std::strcmp(argv[i], "--resize-fixed") == 0)
+			options.offscreen = options.fixedDuringResize = true;
+		else if (std::strcmp(argv[i], "--resize-settle") == 0 && i + 1 < argc)
+			options.settleSeconds = std::atof(argv[++i]);
+	}
+	return options;
+}
+
+// Callback
+// --------
+static ResizeManager* activeManager = NULL;
+static GLFWframebuffersizefun previousResize = NULL;
+
+static void resizeCallback(GLFWwindow* window, int width, int height)
+{
+	if (previousResize != NULL)
+		previousResize(window, width, height);
+	if (activeManager != NULL)
+		activeManager->onResize(width, height);
+}
+
+// Resize manager
+// --------------
+ResizeManager::ResizeManager(ContextProvider& context, RenderTargetPool& pool, const ResizeOptions& options)
+	: context(context), pool(pool), options(options), pending(false), pendingWidth(0), pendingHeight(0),
+	lastEventTime(-1.0), width(context.getWidth()), height(context.getHeight()), sceneTarget(-1)
+{
+	if (options.offscreen)
+		sceneTarget = pool.acquire(width, height);
+	glViewport(0, 0, width, height);
+
+	GLFWwindow* window = context.getWindow();
+	if (window != NULL)
+	{
+		activeManager = this;
+		previousResize = glfwSetFramebufferSizeCallback(window, resizeCallback);
+	}
+}
+
+ResizeManager::~ResizeManager()
+{
+	if (sceneTarget >= 0)
+		pool.release(sceneTarget);
+	if (activeManager == this)
+	{
+		glfwSetFramebufferSizeCallback(context.getWindow(), previousResize);
+		activeManager = NULL;
+	}
+}
+
+void ResizeManager::onResize(int width, int height)
+{
+	pending = true;
+	pendingWidth = width;
+	pendingHeight = height;
+	lastEventTime = context.getTime();
+	stats.events++;
+}
+
+bool ResizeManager::isResizing() const
+{
+	return options.fixedDuringResize && lastEventTime >= 0.0 && context.getTime() - lastEventTime < options.settleSeconds;
+}
+
+bool ResizeManager::beginFrame()
+{
+	bool changed = false;
+	if (pending)
+	{
+		pending = false;
+		if (pendingWidth != width || pendingHeight != height)
+		{
+			width = pendingWidth;
+			height = pendingHeight;
+			stats.applied++;
+			changed = true;
+		}
+	}
+
+	// a minimized window reports 0 x 0, the target keeps its last size until it comes back
+	if (sceneTarget >= 0 && width > 0 && height > 0 && !isResizing())
+	{
+		const RenderTarget& target = pool.get(sceneTarget);
+		if (target.width != width || target.height != height)
+		{
+			pool.resize(sceneTarget, width, height);
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+void ResizeManager::bindSceneTarget() const
+{
+	if (sceneTarget < 0)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, context.getFramebuffer());
+		glViewport(0, 0, width, height);
+		return;
+	}
+	const RenderTarget& target = pool.get(sceneTarget);
+	glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+	glViewport(0, 0, target.width, target.height);
+}
+
+void ResizeManager::present() const
+{
+	if (sceneTarget < 0)
+		return;
+
+	const RenderTarget& target = pool.get(sceneTarget);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, target.FBO);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, context.getFramebuffer());
+	// only stretched while a resize is in progress
+	bool scaled = target.width != width || target.height != height;
+	glBlitFramebuffer(0, 0, target.width, target.height, 0, 0, width, height,
+		GL_COLOR_BUFFER_BIT, scaled ? GL_LINEAR : GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, context.getFramebuffer());
+	glCheckError();
+}
+
+ResizeStats ResizeManager::getStats() const
+{
+	ResizeStats current = stats;
+	current.targets = pool.getStats();
+	return current;
+}
+
+void ResizeManager::printStats() const
+{
+	ResizeStats current = getStats();
+	std::cout << "RESIZE::STATS offscreen=" << (options.offscreen ? 1 : 0)
+		<< " fixed_during_resize=" << (options.fixedDuringResize ? 1 : 0)
+		<< " events=" << current.events
+		<< " applied=" << current.applied
+		<< " allocations=" << current.targets.allocations
+		<< " reuses=" << current.targets.reuses
+		<< " target_bytes=" << current.targets.bytes << std::endl;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "Context.h"
+#include "RenderTargets.h"
+
+// Resize options
+// --------------
+/// \note: offscreen renders the scene into a pooled target that present() blits to the
+///		   window, the path every post processing pass will take. fixedDuringResize keeps
+///		   that target at its pre-resize size until no resize event has arrived for
+///		   settleSeconds and stretches it to the window meanwhile, so a drag reallocates
+///		   nothing until it ends.
+struct ResizeOptions
+{
+	bool offscreen{ false };
+	bool fixedDuringResize{ false };
+	double settleSeconds{ 0.15 };
+	int bucket{ 256 };
+};
+
+// reads --offscreen, --resize-fixed (implies --offscreen) and --resize-settle <seconds>
+ResizeOptions parseResizeOptions(int argc, char* argv[], ResizeOptions options);
+
+struct ResizeStats
+{
+	unsigned long long events{ 0 };		// framebuffer size callbacks
+	unsigned long long applied{ 0 };	// frames that saw a new size
+	RenderTargetStats targets;
+};
+
+// Resize manager
+// --------------
+/// \note: owns the framebuffer size callback (the previous one is chained). The callback only
+///		   records the size; beginFrame() applies the latest one, so any number of events
+///		   between two frames costs one glViewport and at most one target resize.
+///
+///		   ResizeManager resize(*context, pool, options);
+///		   while (...)
+///		   {
+///			resize.beginFrame();
+///			resize.bindSceneTarget();   // viewport included
+///			... draw ...
+///			resize.present();           // blit to the window, nothing without offscreen
+///			swap
+///		   }
+class ResizeManager
+{
+	ContextProvider& context;
+	RenderTargetPool& pool;
+	ResizeOptions options;
+
+	bool pending;
+	int pendingWidth, pendingHeight;
+	double lastEventTime;
+	int width, height;			// window framebuffer, as applied
+	int sceneTarget;			// -1 without offscreen
+	ResizeStats stats;
+
+public:
+	ResizeManager(ContextProvider& context, RenderTargetPool& pool, const ResizeOptions& options);
+	~ResizeManager();
+
+	ResizeManager(const ResizeManager&) = delete;
+	ResizeManager& operator=(const ResizeManager&) = delete;
+
+	// from the callback, or by hand for a provider without one
+	void onResize(int width, int height);
+
+	// applies the latest size, true when it changed (or the scene target settled)
+	bool beginFrame();
+	void bindSceneTarget() const;
+	void present() const;
+
+	// true while events are still arriving and the scene target is held at its old size
+	bool isResizing() const;
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	// what bindSceneTarget() renders at, the held size while resizing with a fixed target
+	int getSceneWidth() const { return sceneTarget < 0 ? width : pool.get(sceneTarget).width; }
+	int getSceneHeight() const { return sceneTarget < 0 ? height : pool.get(sceneTarget).height; }
+
+	ResizeStats getStats() const;
+	void printStats() const;
+};
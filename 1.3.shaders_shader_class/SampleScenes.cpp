@@ -0,0 +1,422 @@
+#include "SampleScenes.h"
+#include "GLResources.h"
+#include "MeshCooker.h"
+#include "ShaderLanes.h"
+#include "VertexFormat.h"
+
+#include <cmath>
+#include <cstring>
+
+// every sample fits position + color, the position only ones just leave aColor unread
+struct SampleVertex
+{
+	float position[3];
+	float color[3];
+	typedef VertexFormat<attrib::Float<3>, attrib::Float<3>> Format;
+};
+VERTEX_FORMAT_CHECK(SampleVertex);
+
+// Sample scene
+// ------------
+/// \note: a clear color and parts, each part one mesh drawn with one program. Uniforms a
+///		   program doesn't have are skipped (location -1), so every part can get all of them.
+///		   The CPU backend runs the same files, transpiled (TranspiledShaders.cpp).
+struct SampleUniforms
+{
+	float color[3];		// uColor
+	float offsetX;		// uOffsetX
+	float time;			// uTime
+};
+
+struct SamplePart
+{
+	std::vector<SampleVertex> vertices;
+	std::vector<unsigned int> indices;	// none: drawn as listed, with glDrawArrays like the samples
+	const char* vertexPath;
+	const char* fragmentPath;
+	float color[3];		// uColor
+	float offsetX;		// uOffsetX
+	bool pulse;			// 1.3.shaders: uColor green follows sin(time)
+};
+
+class SampleScene : public Scene
+{
+	float clearColor[4];
+	std::vector<SamplePart> parts;
+
+	BufferArena* arena;
+	std::vector<MeshAllocation> meshes;
+	std::vector<Shader*> shaders;
+	Interpolated<float> time;
+	bool animated;
+
+public:
+	SampleScene(float r, float g, float b)
+		: arena(NULL), time(0.0f), animated(false)
+	{
+		clearColor[0] = r;
+		clearColor[1] = g;
+		clearColor[2] = b;
+		clearColor[3] = 1.0f;
+	}
+
+	SamplePart& addPart(const char* vertexPath, const char* fragmentPath, const SampleVertex* vertices, unsigned int vertexCount)
+	{
+		SamplePart part{ std::vector<SampleVertex>(vertices, vertices + vertexCount), {}, vertexPath, fragmentPath,
+			{ 1.0f, 1.0f, 1.0f }, 0.0f, false };
+		parts.push_back(part);
+		return parts.back();
+	}
+
+	bool init(SceneResources& resources) override
+	{
+		arena = &resources.getArena(SampleVertex::Format::layout());
+		for (const SamplePart& part : parts)
+		{
+			MeshAllocation mesh = arena->allocate(part.vertices.data(), (unsigned int)part.vertices.size(),
+				part.indices.data(), (unsigned int)part.indices.size());
+			if (!mesh.isValid())
+				return false;
+			meshes.push_back(mesh);
+
+			Shader& shader = resources.getProgram(part.vertexPath, part.fragmentPath);
+			shaders.push_back(&shader);
+			animated = animated || part.pulse || shader.getUniformLocation("uTime") != -1;
+		}
+		return true;
+	}
+
+	void update(const SimulationStep& step, const InputMapper&) override
+	{
+		time.push((float)step.time);
+	}
+
+	void render(double alpha) override
+	{
+		glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		float now = time.get(alpha);
+		for (std::size_t i = 0; i < meshes.size(); i++)
+		{
+			SampleUniforms uniforms = getUniforms(parts[i], now);
+			Shader& shader = *shaders[i];
+			shader.setUniformVec3(shader.getUniformLocation("uColor"), uniforms.color);
+			shader.setUniformFloat(shader.getUniformLocation("uOffsetX"), uniforms.offsetX);
+			shader.setUniformFloat(shader.getUniformLocation("uTime"), uniforms.time);
+
+			shader.useShader();
+			arena->draw(meshes[i]);
+		}
+	}
+
+	bool renderSoftware(SoftwareRasterizer& raster, double alpha) override
+	{
+		raster.clear(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+		float now = time.get(alpha);
+		for (const SamplePart& part : parts)
+		{
+			TranspiledProgram program(part.vertexPath, part.fragmentPath);
+			if (!program.isValid())
+				return false;
+
+			SampleUniforms uniforms = getUniforms(part, now);
+			program.setUniform("uColor", uniforms.color, 3);
+			program.setUniform("uOffsetX", &uniforms.offsetX, 1);
+			program.setUniform("uTime", &uniforms.time, 1);
+			// the stages run in raster.finish(), after this returns
+			RasterPipeline pipeline = program.makePipeline([&part](unsigned int index, float* attributes)
+			{
+				const SampleVertex& vertex = part.vertices[index];
+				std::memcpy(attributes, vertex.position, sizeof(vertex.position));
+				std::memcpy(attributes + 4, vertex.color, sizeof(vertex.color));
+			});
+			// the rasterizer only takes indices, listed vertices are 0..n-1
+			std::vector<unsigned int> indices = part.indices;
+			if (indices.empty())
+			{
+				for (unsigned int index = 0; index < part.vertices.size(); index++)
+					indices.push_back(index);
+			}
+			raster.draw(pipeline, indices.data(), (unsigned int)indices.size());
+		}
+		return true;
+	}
+
+	void shutdown(SceneResources&) override
+	{
+		for (MeshAllocation& mesh : meshes)
+		{
+			arena->free(mesh);
+		}
+		meshes.clear();
+		shaders.clear();
+	}
+
+	bool isAnimated() const override { return animated; }
+
+private:
+	static SampleUniforms getUniforms(const SamplePart& part, float now)
+	{
+		SampleUniforms uniforms{ { part.color[0], part.color[1], part.color[2] }, part.offsetX, now };
+		if (part.pulse)
+		{
+			// as in the sample, the / 0.5 lets it saturate for part of the period
+			uniforms.color[0] = 0.0f;
+			uniforms.color[1] = std::sin(now) / 0.5f + 0.5f;
+			uniforms.color[2] = 0.0f;
+		}
+		return uniforms;
+	}
+};
+
+// 1.3.shaders_shader_class --quantized: unorm16 positions + rgba8 colors from MeshCooker
+class QuantizedTriangleScene : public Scene
+{
+	BufferArena* arena;
+	MeshAllocation mesh;
+	Shader* shader;
+	Interpolated<float> time;
+	std::vector<CookedColorVertex> vertices;
+	float positionScale[3];
+	float positionBias[3];
+
+public:
+	QuantizedTriangleScene();
+
+	bool init(SceneResources& resources) override;
+
+	void update(const SimulationStep& step, const InputMapper&) override
+	{
+		time.push((float)step.time);
+	}
+
+	void render(double alpha) override
+	{
+		glClearColor(0.25f, 0.3f, 0.5f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		shader->setUniformVec3(shader->getUniformLocation("uPositionScale"), positionScale);
+		shader->setUniformVec3(shader->getUniformLocation("uPositionBias"), positionBias);
+		shader->setUniformFloat(shader->getUniformLocation("uTime"), time.get(alpha));
+		shader->useShader();
+		arena->draw(mesh);
+	}
+
+	void shutdown(SceneResources&) override
+	{
+		if (arena != NULL)
+			arena->free(mesh);
+	}
+
+	bool renderSoftware(SoftwareRasterizer& raster, double alpha) override
+	{
+		raster.clear(0.25f, 0.3f, 0.5f, 1.0f);
+		TranspiledProgram program("vertex_shader_quantized.vert", "fragment_shader.frag");
+		if (!program.isValid())
+			return false;
+		float now = time.get(alpha);
+		program.setUniform("uPositionScale", positionScale, 3);
+		program.setUniform("uPositionBias", positionBias, 3);
+		program.setUniform("uTime", &now, 1);
+		// unorm16 / unorm8 to float, as the attribute fetch does
+		RasterPipeline pipeline = program.makePipeline([this](unsigned int index, float* attributes)
+		{
+			const CookedColorVertex& in = vertices[index];
+			for (int c = 0; c < 4; c++)
+			{
+				attributes[c] = in.position[c] / 65535.0f;
+				attributes[4 + c] = in.color[c] / 255.0f;
+			}
+		});
+		const unsigned int indices[] = { 0, 1, 2 };
+		raster.draw(pipeline, indices, 3);
+		return true;
+	}
+
+	bool isAnimated() const override { return shader != NULL && shader->getUniformLocation("uTime") != -1; }
+};
+
+// Samples
+// -------
+static const float BACKGROUND[3] = { 0.2f, 0.2f, 0.4f };
+static const float SHADER_CLASS_BACKGROUND[3] = { 0.25f, 0.3f, 0.5f };
+
+static const SampleVertex TRIANGLE[] =
+{
+	{{ -0.5f, -0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f }},
+	{{  0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f }},
+	{{  0.0f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }}
+};
+
+// the 1.3 exercises list it from the top vertex
+static const SampleVertex COLOR_TRIANGLE[] =
+{
+	{{  0.0f,  0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f }},
+	{{ -0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f }},
+	{{  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }}
+};
+
+static const SampleVertex TWO_TRIANGLES[] =
+{
+	{{ -0.5f,  0.5f, 0.0f }, {}}, {{ -0.1f, -0.5f, 0.0f }, {}}, {{ -0.9f, -0.5f, 0.0f }, {}},
+	{{  0.5f,  0.5f, 0.0f }, {}}, {{  0.9f, -0.5f, 0.0f }, {}}, {{  0.1f, -0.5f, 0.0f }, {}}
+};
+
+static const SampleVertex RECTANGLE[] =
+{
+	{{  0.5f,  0.5f, 0.0f }, {}},	// top right
+	{{  0.5f, -0.5f, 0.0f }, {}},	// bottom right
+	{{ -0.5f, -0.5f, 0.0f }, {}},	// bottom left
+	{{ -0.5f,  0.5f, 0.0f }, {}}	// top left
+};
+
+static void setColor(SamplePart& part, float r, float g, float b)
+{
+	part.color[0] = r;
+	part.color[1] = g;
+	part.color[2] = b;
+}
+
+static SampleScene* sampleScene(const float* background)
+{
+	return new SampleScene(background[0], background[1], background[2]);
+}
+
+static Scene* helloWindow()
+{
+	return new SampleScene(1.0f, 1.0f, 1.0f);
+}
+
+static Scene* helloTriangle()
+{
+	SampleScene* scene = sampleScene(BACKGROUND);
+	setColor(scene->addPart("position.vert", "solid_color.frag", TRIANGLE, 3), 1.0f, 1.0f, 0.0f);
+	return scene;
+}
+
+static Scene* helloTriangleEbo()
+{
+	SampleScene* scene = sampleScene(BACKGROUND);
+	SamplePart& part = scene->addPart("position.vert", "solid_color.frag", RECTANGLE, 4);
+	setColor(part, 1.0f, 1.0f, 0.0f);
+	part.indices = { 0, 1, 3, 1, 2, 3 };
+	return scene;
+}
+
+static Scene* helloTriangleExercise1()
+{
+	SampleScene* scene = sampleScene(BACKGROUND);
+	setColor(scene->addPart("position.vert", "solid_color.frag", TWO_TRIANGLES, 6), 1.0f, 1.0f, 0.0f);
+	return scene;
+}
+
+static Scene* helloTriangleExercise2()
+{
+	SampleScene* scene = sampleScene(BACKGROUND);
+	setColor(scene->addPart("position.vert", "solid_color.frag", TWO_TRIANGLES, 3), 1.0f, 1.0f, 0.0f);
+	setColor(scene->addPart("position.vert", "solid_color.frag", TWO_TRIANGLES + 3, 3), 1.0f, 1.0f, 0.0f);
+	return scene;
+}
+
+static Scene* helloTriangleExercise3()
+{
+	SampleScene* scene = sampleScene(BACKGROUND);
+	setColor(scene->addPart("position.vert", "solid_color.frag", TWO_TRIANGLES, 3), 1.0f, 1.0f, 0.0f);
+	setColor(scene->addPart("position.vert", "solid_color.frag", TWO_TRIANGLES + 3, 3), 1.0f, 0.0f, 1.0f);
+	return scene;
+}
+
+static Scene* shaders()
+{
+	SampleScene* scene = sampleScene(BACKGROUND);
+	scene->addPart("position.vert", "solid_color.frag", TRIANGLE, 3).pulse = true;
+	return scene;
+}
+
+static Scene* shadersMoreAttributes()
+{
+	SampleScene* scene = sampleScene(BACKGROUND);
+	scene->addPart("vertex_shader.vert", "fragment_shader.frag", TRIANGLE, 3);
+	return scene;
+}
+
+static Scene* shadersExercise1()
+{
+	SampleScene* scene = sampleScene(SHADER_CLASS_BACKGROUND);
+	scene->addPart("vertex_color_flipped.vert", "fragment_shader.frag", COLOR_TRIANGLE, 3);
+	return scene;
+}
+
+static Scene* shadersExercise2()
+{
+	SampleScene* scene = sampleScene(SHADER_CLASS_BACKGROUND);
+	scene->addPart("vertex_color_offset.vert", "fragment_shader.frag", COLOR_TRIANGLE, 3).offsetX = 0.5f;
+	return scene;
+}
+
+static Scene* shadersExercise3()
+{
+	SampleScene* scene = sampleScene(SHADER_CLASS_BACKGROUND);
+	scene->addPart("position_color.vert", "position_color.frag", COLOR_TRIANGLE, 3);
+	return scene;
+}
+
+static Scene* shaderClass()
+{
+	SampleScene* scene = sampleScene(SHADER_CLASS_BACKGROUND);
+	scene->addPart("vertex_shader.vert", "fragment_shader.frag", COLOR_TRIANGLE, 3);
+	return scene;
+}
+
+static Scene* shaderClassQuantized()
+{
+	return new QuantizedTriangleScene();
+}
+
+QuantizedTriangleScene::QuantizedTriangleScene()
+	: arena(NULL), shader(NULL), time(0.0f)
+{
+	float positionColors[18];
+	for (int i = 0; i < 3; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			positionColors[i * 6 + c] = COLOR_TRIANGLE[i].position[c];
+			positionColors[i * 6 + 3 + c] = COLOR_TRIANGLE[i].color[c];
+		}
+	}
+	CookedMesh<CookedColorVertex> cooked = cookColorMesh(positionColors, 3);
+	vertices = cooked.vertices;
+	for (int c = 0; c < 3; c++)
+	{
+		positionScale[c] = cooked.positionScale[c];
+		positionBias[c] = cooked.positionBias[c];
+	}
+}
+
+bool QuantizedTriangleScene::init(SceneResources& resources)
+{
+	const unsigned int indices[] = { 0, 1, 2 };
+	arena = &resources.getArena(CookedColorVertex::Format::layout());
+	mesh = arena->allocate(vertices.data(), (unsigned int)vertices.size(), indices, 3);
+	shader = &resources.getProgram("vertex_shader_quantized.vert", "fragment_shader.frag");
+	return mesh.isValid();
+}
+
+void registerSampleScenes(SceneRegistry& registry)
+{
+	registry.add("1.1.hello_window", "clear to white", helloWindow);
+	registry.add("1.2.hello_triangle", "one yellow triangle", helloTriangle);
+	registry.add("1.2.hello_triangle_ebo", "indexed rectangle", helloTriangleEbo);
+	registry.add("1.2.hello_triangle_exercise_1", "two triangles, one draw", helloTriangleExercise1);
+	registry.add("1.2.hello_triangle_exercise_2", "two triangles, two meshes", helloTriangleExercise2);
+	registry.add("1.2.hello_triangle_exercise_3", "two triangles, two colors", helloTriangleExercise3);
+	registry.add("1.3.shaders", "uniform color over time", shaders);
+	registry.add("1.3.shaders_more_attributes", "per vertex colors", shadersMoreAttributes);
+	registry.add("1.3.shaders_exercise_1", "upside down", shadersExercise1);
+	registry.add("1.3.shaders_exercise_2", "offset uniform", shadersExercise2);
+	registry.add("1.3.shaders_exercise_3", "position as color", shadersExercise3);
+	registry.add("1.3.shaders_shader_class", "Shader class, per vertex colors", shaderClass);
+	registry.add("1.3.shaders_shader_class_quantized", "unorm16 / rgba8 vertices", shaderClassQuantized);
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "Scene.h"
+
+// Sample scenes
+// -------------
+/// \note: the chapter samples (1.1.hello_window through 1.3.shaders_shader_class) as scenes,
+///		   named after their directories. Each keeps its sample's geometry, colors and shader
+///		   logic; the inline shader strings became the .vert / .frag files next to this one.
+///		   The _naive exercise variants draw the same images as the others and aren't
+///		   registered separately.
+void registerSampleScenes(SceneRegistry& registry);
@@ -0,0 +1,153 @@
+#include "Scene.h"
+#include "GLDebug.h"
+#include "GLResources.h"
+
+#include <chrono>
+#include <iostream>
+
+// Scene resources
+// ---------------
+SceneResources::SceneResources(ContextProvider& context, int targetBucket)
+	: context(context), targets(targetBucket)
+{
+}
+
+SceneResources::~SceneResources()
+{
+	for (std::map<std::string, Shader>::iterator it = programs.begin(); it != programs.end(); ++it)
+	{
+		deleteProgram(it->second.getID());
+	}
+	for (std::map<unsigned long long, BufferArena*>::iterator it = arenas.begin(); it != arenas.end(); ++it)
+	{
+		delete it->second;
+	}
+}
+
+Shader& SceneResources::getProgram(const char* vertexPath, const char* fragmentPath)
+{
+	// '|' can't be in either path on any platform we build for
+	std::string key = std::string(vertexPath) + "|" + fragmentPath;
+	std::map<std::string, Shader>::iterator it = programs.find(key);
+	if (it != programs.end())
+	{
+		stats.programHits++;
+		return it->second;
+	}
+	stats.programLinks++;
+	return programs.emplace(key, Shader(vertexPath, fragmentPath)).first->second;
+}
+
+SceneResourceStats SceneResources::getStats() const
+{
+	SceneResourceStats current = stats;
+	current.vertexArrays = (unsigned int)vertexArrays.size();
+	return current;
+}
+
+BufferArena& SceneResources::getArena(const VertexLayout& layout)
+{
+	std::map<unsigned long long, BufferArena*>::iterator it = arenas.find(layout.hash);
+	if (it != arenas.end())
+		return *it->second;
+	// small pages, the samples are a handful of vertices each
+	BufferArena* arena = new BufferArena(layout, 1 << 12, 3 << 12, &vertexArrays);
+	arenas[layout.hash] = arena;
+	stats.arenas++;
+	return *arena;
+}
+
+// Scene registry
+// --------------
+void SceneRegistry::add(const char* name, const char* description, SceneFactory factory, double budgetMs)
+{
+	scenes.push_back(SceneInfo{ name, description, factory, budgetMs });
+}
+
+int SceneRegistry::find(const char* name) const
+{
+	for (std::size_t i = 0; i < scenes.size(); i++)
+	{
+		if (scenes[i].name == name)
+			return (int)i;
+	}
+	return -1;
+}
+
+void SceneRegistry::print() const
+{
+	for (std::size_t i = 0; i < scenes.size(); i++)
+	{
+		std::cout << "  " << scenes[i].name << "\t" << scenes[i].description << std::endl;
+	}
+}
+
+// Scene launcher
+// --------------
+SceneLauncher::SceneLauncher(const SceneRegistry& registry, SceneResources& resources)
+	: registry(registry), resources(resources), active(NULL), activeIndex(0)
+{
+}
+
+SceneLauncher::~SceneLauncher()
+{
+	stop();
+}
+
+void SceneLauncher::stop()
+{
+	if (active == NULL)
+		return;
+	active->shutdown(resources);
+	delete active;
+	active = NULL;
+}
+
+bool SceneLauncher::switchTo(int index)
+{
+	if (index < 0 || index >= registry.size())
+	{
+		std::cout << "ERROR::SCENE::INVALID_INDEX " << index << std::endl;
+		return false;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned long long linksBefore = resources.getStats().programLinks;
+
+	stop();
+	const SceneInfo& info = registry.get(index);
+	activeIndex = index;
+	active = info.factory();
+	bool initialized = active->init(resources);
+	if (!initialized)
+	{
+		std::cout << "ERROR::SCENE::INIT_FAILED " << info.name << std::endl;
+		stop();
+	}
+	// the driver may still be compiling or uploading, the switch isn't over until it is
+	glFinish();
+	glCheckError();
+
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "SCENE::SWITCH to=" << info.name << " ms=" << ms
+		<< " programs_linked=" << resources.getStats().programLinks - linksBefore
+		<< " vaos=" << resources.getStats().vertexArrays << std::endl;
+	return initialized;
+}
+
+void SceneLauncher::update(const SimulationStep& step, const InputMapper& input)
+{
+	if (active != NULL)
+		active->update(step, input);
+}
+
+void SceneLauncher::render(double alpha)
+{
+	if (active != NULL)
+		active->render(alpha);
+}
+
+bool SceneLauncher::renderSoftware(SoftwareRasterizer& raster, double alpha)
+{
+	return active != NULL && active->renderSoftware(raster, alpha);
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BufferArena.h"
+#include "Context.h"
+#include "FixedTimestep.h"
+#include "InputQueue.h"
+#include "RenderTargets.h"
+#include "Shader.h"
+#include "SoftwareRasterizer.h"
+
+// Scene resources
+// ---------------
+/// \note: what outlives a scene: linked programs (one per vertex + fragment path pair), one
+///		   buffer arena per vertex layout, the VAOs their pages share and the render target pool. A scene frees its own
+///		   meshes on shutdown, but the arena pages and the programs stay, so entering a scene
+///		   a second time compiles and allocates nothing.
+struct SceneResourceStats
+{
+	unsigned long long programLinks{ 0 };
+	unsigned long long programHits{ 0 };
+	unsigned int arenas{ 0 };
+	unsigned int vertexArrays{ 0 };	// VAOs the arena pages share, one per layout on 4.3+
+};
+
+class SceneResources
+{
+	ContextProvider& context;
+	std::map<std::string, Shader> programs;
+	VertexArrayCache vertexArrays;	// declared first, the arenas are deleted before it
+	std::map<unsigned long long, BufferArena*> arenas;	// by VertexLayout::hash
+	RenderTargetPool targets;
+	SceneResourceStats stats;
+
+public:
+	// targetBucket: see RenderTargetPool
+	SceneResources(ContextProvider& context, int targetBucket = 256);
+	~SceneResources();
+
+	SceneResources(const SceneResources&) = delete;
+	SceneResources& operator=(const SceneResources&) = delete;
+
+	ContextProvider& getContext() { return context; }
+	Shader& getProgram(const char* vertexPath, const char* fragmentPath);
+	BufferArena& getArena(const VertexLayout& layout);
+	RenderTargetPool& getTargets() { return targets; }
+
+	SceneResourceStats getStats() const;
+};
+
+// Scene
+// -----
+/// \note: one sample. init() gets everything from the resources, update() runs once per
+///		   fixed simulation step and render() draws into the bound framebuffer (viewport set)
+///		   with alpha the position between the last two steps, see FixedTimestep.h.
+///		   shutdown() has to free what init() allocated that isn't shared.
+///		   renderSoftware() draws the same image with the CPU rasterizer. It must not touch
+///		   GL: it runs without a context, and without init() having been called.
+class Scene
+{
+public:
+	virtual ~Scene() {}
+
+	// false when the scene can't run, shutdown() is still called
+	virtual bool init(SceneResources& resources) = 0;
+	virtual void update(const SimulationStep&, const InputMapper&) {}
+	virtual void render(double alpha) = 0;
+	virtual void shutdown(SceneResources& resources) = 0;
+	// false when the scene has no CPU path
+	virtual bool renderSoftware(SoftwareRasterizer&, double) { return false; }
+
+	// changes over time without input, on-demand mode keeps redrawing it
+	virtual bool isAnimated() const { return false; }
+};
+
+// Scene registry
+// --------------
+typedef Scene* (*SceneFactory)();
+
+struct SceneInfo
+{
+	std::string name;
+	std::string description;
+	SceneFactory factory;
+	double budgetMs;	// golden test frame time budget
+};
+
+class SceneRegistry
+{
+	std::vector<SceneInfo> scenes;
+
+public:
+	void add(const char* name, const char* description, SceneFactory factory, double budgetMs = 2.0);
+
+	// -1 if there is no such scene
+	int find(const char* name) const;
+	int size() const { return (int)scenes.size(); }
+	const SceneInfo& get(int index) const { return scenes[index]; }
+
+	void print() const;
+};
+
+// Scene launcher
+// --------------
+/// \note: runs one scene at a time out of a registry. Switching shuts the current scene down
+///		   and initializes the next in the same context, with the same resources, and prints
+///		   a SCENE::SWITCH line with the time it took (glFinish included) and how many
+///		   programs had to be linked for it.
+class SceneLauncher
+{
+	const SceneRegistry& registry;
+	SceneResources& resources;
+	Scene* active;
+	int activeIndex;
+
+public:
+	SceneLauncher(const SceneRegistry& registry, SceneResources& resources);
+	~SceneLauncher();
+
+	SceneLauncher(const SceneLauncher&) = delete;
+	SceneLauncher& operator=(const SceneLauncher&) = delete;
+
+	// false if the scene failed to initialize, nothing is active then
+	bool switchTo(int index);
+	// wrap around the registry
+	bool next() { return switchTo((activeIndex + 1) % registry.size()); }
+	bool previous() { return switchTo((activeIndex + registry.size() - 1) % registry.size()); }
+
+	void update(const SimulationStep& step, const InputMapper& input);
+	void render(double alpha);
+	bool renderSoftware(SoftwareRasterizer& raster, double alpha);
+
+	Scene* getActive() const { return active; }
+	int getActiveIndex() const { return activeIndex; }
+	bool isAnimated() const { return active != NULL && active->isAnimated(); }
+
+private:
+	void stop();
+};
@@ -1,4 +1,8 @@
 #include "Shader.h"
+#include "GLDebug.h"
+#include "GLResources.h"
+
+#include <cstring>
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath)
 {
@@ -56,27 +60,81 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
 	glAttachShader(ID, vertexShader);
 	glAttachShader(ID, fragmentShader);
 	glLinkProgram(ID);
+	// kept in release: once per program, and a bad shader must not pass silently.
+	// Only the per-call glGetError checks are compiled out
 	errorCheck(ID, "PROGRAM");
+	glCheckError();
 }
 
 void Shader::addUniformInt(const char* name, int value)
 {
-	glUniform1i(glGetUniformLocation(ID, name), value);
+	programUniform1i(ID, glGetUniformLocation(ID, name), value);
 }
 
 void Shader::addUniformFloat(const char* name, float value)
 {
-	glUniform1f(glGetUniformLocation(ID, name), value);
+	programUniform1f(ID, glGetUniformLocation(ID, name), value);
 }
 	
 void Shader::addUniformBool(const char* name, bool value)
 {
-	glUniform1i(glGetUniformLocation(ID, name), (int)value);
+	programUniform1i(ID, glGetUniformLocation(ID, name), (int)value);
+}
+
+void Shader::addUniformVec3(const char* name, float x, float y, float z)
+{
+	programUniform3f(ID, glGetUniformLocation(ID, name), x, y, z);
+}
+
+void Shader::addUniformVec3(const char* name, const float* value)
+{
+	programUniform3fv(ID, glGetUniformLocation(ID, name), value);
+}
+
+GLint Shader::getUniformLocation(const char* name)
+{
+	std::map<std::string, GLint>::iterator it = locations.find(name);
+	if (it != locations.end())
+		return it->second;
+
+	GLint location = glGetUniformLocation(ID, name);
+	locations[name] = location;
+	return location;
+}
+
+void Shader::setUniformFloat(GLint location, float value)
+{
+	if (location < 0)
+		return;
+	if ((std::size_t)location >= shadows.size())
+		shadows.resize(location + 1, UniformShadow{ { 0.0f, 0.0f, 0.0f }, false });
+
+	UniformShadow& shadow = shadows[location];
+	if (shadow.valid && shadow.value[0] == value)
+		return;
+	shadow.value[0] = value;
+	shadow.valid = true;
+	programUniform1f(ID, location, value);
+}
+
+void Shader::setUniformVec3(GLint location, const float* value)
+{
+	if (location < 0)
+		return;
+	if ((std::size_t)location >= shadows.size())
+		shadows.resize(location + 1, UniformShadow{ { 0.0f, 0.0f, 0.0f }, false });
+
+	UniformShadow& shadow = shadows[location];
+	if (shadow.valid && std::memcmp(shadow.value, value, sizeof(shadow.value)) == 0)
+		return;
+	std::memcpy(shadow.value, value, sizeof(shadow.value));
+	shadow.valid = true;
+	programUniform3fv(ID, location, value);
 }
 
 void Shader::useShader()
 {
-	glUseProgram(ID);
+	useProgram(ID);
 }
 
 void Shader::errorCheck(unsigned int shaderID, const char* type)
@@ -84,7 +142,7 @@ void Shader::errorCheck(unsigned int shaderID, const char* type)
 	int success;
 	char infoLog[512];
 
-	if (type != "PROGRAM")
+	if (std::strcmp(type, "PROGRAM") != 0)
 	{
 		glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
 		if (!success)
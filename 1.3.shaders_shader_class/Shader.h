@@ -4,20 +4,39 @@
 #include <sstream>
 #include <string>
 #include <cstdlib>
+#include <map>
+#include <vector>
 #include <glad/glad.h>
 
 class Shader
 {
 	unsigned int ID;
 
+	struct UniformShadow
+	{
+		float value[3];
+		bool valid;
+	};
+	std::map<std::string, GLint> locations;
+	std::vector<UniformShadow> shadows;	// indexed by location
+
 public:
 	Shader(const char* vertexPath, const char* fragmentPath);
 	
 	void addUniformInt(const char* name, int value);
 	void addUniformFloat(const char* name, float value);
 	void addUniformBool(const char* name, bool value);
+	void addUniformVec3(const char* name, float x, float y, float z);
+	void addUniformVec3(const char* name, const float* value);
+
+	// location looked up once per name. The setters shadow the last value they sent for a
+	// location and skip the GL call when it hasn't changed (don't mix with addUniform*)
+	GLint getUniformLocation(const char* name);
+	void setUniformFloat(GLint location, float value);
+	void setUniformVec3(GLint location, const float* value);
 	
 	void useShader();
+	unsigned int getID() const { return ID; }
 
 private:
 	void errorCheck(unsigned int shaderID, const char* type);
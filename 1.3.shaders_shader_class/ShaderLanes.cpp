@@ -0,0 +1,116 @@
+#include "ShaderLanes.h"
+
+#include <cstring>
+#include <iostream>
+
+// offset of name among the stage's uniforms, -1 if it has none by that name
+static int findUniform(const TranspiledShader& shader, const char* name, int& components)
+{
+	int offset = 0;
+	for (int i = 0; i < shader.uniformCount; i++)
+	{
+		if (std::strcmp(shader.uniforms[i].name, name) == 0)
+		{
+			components = shader.uniforms[i].components;
+			return offset;
+		}
+		offset += shader.uniforms[i].components;
+	}
+	return -1;
+}
+
+static int uniformFloats(const TranspiledShader& shader)
+{
+	int count = 0;
+	for (int i = 0; i < shader.uniformCount; i++)
+		count += shader.uniforms[i].components;
+	return count;
+}
+
+TranspiledProgram::TranspiledProgram(const char* vertexPath, const char* fragmentPath)
+	: vertexShader(findTranspiledShader(vertexPath)), fragmentShader(findTranspiledShader(fragmentPath)),
+	varyingCount(0), valid(false)
+{
+	if (vertexShader == NULL || vertexShader->vertexMain == NULL || fragmentShader == NULL || fragmentShader->fragmentMain == NULL)
+	{
+		std::cout << "ERROR::TRANSPILER::NOT_TRANSPILED: " << vertexPath << " + " << fragmentPath
+			<< ", see TranspiledShaders.cpp" << std::endl;
+		return;
+	}
+	vertexUniforms.assign(uniformFloats(*vertexShader), 0.0f);
+	fragmentUniforms.assign(uniformFloats(*fragmentShader), 0.0f);
+
+	// as the GLSL linker does: by name, and the types have to agree
+	for (int i = 0; i < vertexShader->outputCount; i++)
+		varyingCount += vertexShader->outputs[i].components;
+	for (int i = 0; i < fragmentShader->inputCount; i++)
+	{
+		const ShaderVariable& input = fragmentShader->inputs[i];
+		int offset = 0;
+		int j = 0;
+		for (; j < vertexShader->outputCount; j++)
+		{
+			if (std::strcmp(vertexShader->outputs[j].name, input.name) == 0)
+				break;
+			offset += vertexShader->outputs[j].components;
+		}
+		if (j == vertexShader->outputCount || vertexShader->outputs[j].components != input.components)
+		{
+			std::cout << "ERROR::TRANSPILER::LINK: " << fragmentPath << " reads " << input.name
+				<< ", which " << vertexPath << " doesn't write" << std::endl;
+			return;
+		}
+		for (int c = 0; c < input.components; c++)
+			varyingOffsets.push_back(offset + c);
+	}
+	valid = true;
+}
+
+void TranspiledProgram::setUniform(const char* name, const float* value, int components)
+{
+	if (!valid)
+		return;
+	int declared = 0;
+	int offset = findUniform(*vertexShader, name, declared);
+	for (int c = 0; offset >= 0 && c < components && c < declared; c++)
+		vertexUniforms[offset + c] = value[c];
+	offset = findUniform(*fragmentShader, name, declared);
+	for (int c = 0; offset >= 0 && c < components && c < declared; c++)
+		fragmentUniforms[offset + c] = value[c];
+}
+
+RasterPipeline TranspiledProgram::makePipeline(const AttributeFetch& fetch) const
+{
+	RasterPipeline pipeline;
+	if (!valid)
+		return pipeline;
+
+	pipeline.varyingCount = varyingCount;
+	TranspiledVertexMain vertexMain = vertexShader->vertexMain;
+	std::vector<float> vertexValues = vertexUniforms;
+	pipeline.vertex = [fetch, vertexMain, vertexValues](unsigned int index, RasterVertex& out)
+	{
+		float attributes[SHADER_MAX_ATTRIBUTES * 4];
+		for (int i = 0; i < SHADER_MAX_ATTRIBUTES * 4; i++)
+			attributes[i] = i % 4 == 3 ? 1.0f : 0.0f;
+		fetch(index, attributes);
+		vertexMain(attributes, vertexValues.data(), out.position, out.varyings);
+	};
+
+	TranspiledFragmentMain fragmentMain = fragmentShader->fragmentMain;
+	std::vector<float> fragmentValues = fragmentUniforms;
+	std::vector<int> offsets = varyingOffsets;
+	pipeline.fragment = [fragmentMain, fragmentValues, offsets](const FragmentLanes& in, FragmentColor& out)
+	{
+		Float8 varyings[RASTER_MAX_VARYINGS];
+		for (std::size_t i = 0; i < offsets.size(); i++)
+			varyings[i] = in.varyings[offsets[i]];
+		Float8 color[4];
+		fragmentMain(varyings, fragmentValues.data(), color);
+		out.r = color[0];
+		out.g = color[1];
+		out.b = color[2];
+		out.a = color[3];
+	};
+	return pipeline;
+}
@@ -0,0 +1,260 @@
+#pragma once
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "SimdLanes.h"
+#include "SoftwareRasterizer.h"
+
+// Shader lanes
+// ------------
+/// \note: what the shaders transpiled by ShaderTranspiler.h run on. GLSL float becomes T and
+///		   vecN becomes Vec<N, T>, T being float for a vertex (one at a time) and Float8 for
+///		   fragments (a tile row, structure of arrays: every component holds 8 pixels), so
+///		   the same generated function serves both. Literals and uniforms are turned into T
+///		   where they are read, which keeps every operator below a plain template.
+template <int N, typename T>
+struct Vec
+{
+	T c[N];
+};
+
+template <int N, typename T>
+inline Vec<N, T> splat(const T& value)
+{
+	Vec<N, T> result;
+	for (int i = 0; i < N; i++)
+		result.c[i] = value;
+	return result;
+}
+
+// a uniform: N floats, each splatted to T
+template <int N, typename T>
+inline Vec<N, T> loadUniform(const float* values)
+{
+	Vec<N, T> result;
+	for (int i = 0; i < N; i++)
+		result.c[i] = T(values[i]);
+	return result;
+}
+
+template <int N, typename T>
+inline Vec<N, T> loadVec(const T* values)
+{
+	Vec<N, T> result;
+	for (int i = 0; i < N; i++)
+		result.c[i] = values[i];
+	return result;
+}
+
+template <int N, typename T>
+inline void storeVec(T* values, const Vec<N, T>& v)
+{
+	for (int i = 0; i < N; i++)
+		values[i] = v.c[i];
+}
+
+// vecN(...) constructors: the components of every argument in turn, extra ones dropped
+template <int N, typename T>
+inline void appendComponents(Vec<N, T>& out, int& count, const T& value)
+{
+	if (count < N)
+		out.c[count++] = value;
+}
+
+template <int N, typename T, int M>
+inline void appendComponents(Vec<N, T>& out, int& count, const Vec<M, T>& value)
+{
+	for (int i = 0; i < M; i++)
+		appendComponents(out, count, value.c[i]);
+}
+
+template <int N, typename T, typename... Args>
+inline Vec<N, T> makeVec(const Args&... args)
+{
+	Vec<N, T> result;
+	int count = 0;
+	int expand[] = { (appendComponents(result, count, args), 0)... };
+	(void)expand;
+	return result;
+}
+
+// v.zyx and the like
+template <int... I, int N, typename T>
+inline Vec<sizeof...(I), T> swizzle(const Vec<N, T>& v)
+{
+	return Vec<sizeof...(I), T>{ { v.c[I]... } };
+}
+
+// component wise arithmetic, vector with vector or with a scalar on either side
+#define SHADER_LANES_OPERATOR(op) \
+	template <int N, typename T> \
+	inline Vec<N, T> operator op(const Vec<N, T>& a, const Vec<N, T>& b) \
+	{ Vec<N, T> r; for (int i = 0; i < N; i++) r.c[i] = a.c[i] op b.c[i]; return r; } \
+	template <int N, typename T> \
+	inline Vec<N, T> operator op(const Vec<N, T>& a, const T& b) \
+	{ Vec<N, T> r; for (int i = 0; i < N; i++) r.c[i] = a.c[i] op b; return r; } \
+	template <int N, typename T> \
+	inline Vec<N, T> operator op(const T& a, const Vec<N, T>& b) \
+	{ Vec<N, T> r; for (int i = 0; i < N; i++) r.c[i] = a op b.c[i]; return r; }
+
+SHADER_LANES_OPERATOR(+)
+SHADER_LANES_OPERATOR(-)
+SHADER_LANES_OPERATOR(*)
+SHADER_LANES_OPERATOR(/)
+#undef SHADER_LANES_OPERATOR
+
+template <int N, typename T>
+inline Vec<N, T> operator-(const Vec<N, T>& a)
+{
+	Vec<N, T> r;
+	for (int i = 0; i < N; i++)
+		r.c[i] = -a.c[i];
+	return r;
+}
+
+// Built-in functions
+// ------------------
+// min, max, clamp, mix, dot, sin and cos, on floats, Float8 and vectors of either
+inline float glslMin(float a, float b) { return b < a ? b : a; }
+inline float glslMax(float a, float b) { return b > a ? b : a; }
+inline float glslSin(float a) { return std::sin(a); }
+inline float glslCos(float a) { return std::cos(a); }
+inline Float8 glslMin(const Float8& a, const Float8& b) { return min(a, b); }
+inline Float8 glslMax(const Float8& a, const Float8& b) { return max(a, b); }
+
+// no vector sin / cos in SimdLanes.h, one lane at a time
+inline Float8 glslSin(const Float8& a)
+{
+	float values[SIMD_LANES];
+	a.store(values);
+	for (int i = 0; i < SIMD_LANES; i++)
+		values[i] = std::sin(values[i]);
+	return Float8::load(values);
+}
+
+inline Float8 glslCos(const Float8& a)
+{
+	float values[SIMD_LANES];
+	a.store(values);
+	for (int i = 0; i < SIMD_LANES; i++)
+		values[i] = std::cos(values[i]);
+	return Float8::load(values);
+}
+
+template <typename T>
+inline T glslClamp(const T& x, const T& low, const T& high) { return glslMin(glslMax(x, low), high); }
+template <typename T>
+inline T glslMix(const T& a, const T& b, const T& t) { return a + (b - a) * t; }
+
+template <int N, typename T>
+inline Vec<N, T> glslMin(const Vec<N, T>& a, const Vec<N, T>& b)
+{
+	Vec<N, T> r;
+	for (int i = 0; i < N; i++)
+		r.c[i] = glslMin(a.c[i], b.c[i]);
+	return r;
+}
+
+template <int N, typename T>
+inline Vec<N, T> glslMax(const Vec<N, T>& a, const Vec<N, T>& b)
+{
+	Vec<N, T> r;
+	for (int i = 0; i < N; i++)
+		r.c[i] = glslMax(a.c[i], b.c[i]);
+	return r;
+}
+
+template <int N, typename T>
+inline Vec<N, T> glslSin(const Vec<N, T>& a)
+{
+	Vec<N, T> r;
+	for (int i = 0; i < N; i++)
+		r.c[i] = glslSin(a.c[i]);
+	return r;
+}
+
+template <int N, typename T>
+inline Vec<N, T> glslCos(const Vec<N, T>& a)
+{
+	Vec<N, T> r;
+	for (int i = 0; i < N; i++)
+		r.c[i] = glslCos(a.c[i]);
+	return r;
+}
+
+template <int N, typename T>
+inline T glslDot(const Vec<N, T>& a, const Vec<N, T>& b)
+{
+	T sum = a.c[0] * b.c[0];
+	for (int i = 1; i < N; i++)
+		sum = sum + a.c[i] * b.c[i];
+	return sum;
+}
+
+// Transpiled shaders
+// ------------------
+/// \note: one .vert or .frag as generated. Vertex attributes come in as 4 floats per
+///		   location (missing components 0, 0, 0, 1 like GL), uniforms as floats packed in
+///		   declaration order. A vertex writes gl_Position and its outs packed in declaration
+///		   order, a fragment reads its ins packed in its own declaration order and writes
+///		   its first out as RGBA.
+struct ShaderVariable
+{
+	const char* name;
+	int components;
+	int location;	// vertex attributes, -1 otherwise
+};
+
+const int SHADER_MAX_ATTRIBUTES = 8;
+
+typedef void (*TranspiledVertexMain)(const float* shaderIn, const float* shaderUniforms, float* shaderPosition, float* shaderOut);
+typedef void (*TranspiledFragmentMain)(const Float8* shaderIn, const float* shaderUniforms, Float8* shaderOut);
+
+struct TranspiledShader
+{
+	const char* path;
+	const ShaderVariable* inputs;
+	int inputCount;
+	const ShaderVariable* outputs;
+	int outputCount;
+	const ShaderVariable* uniforms;
+	int uniformCount;
+	TranspiledVertexMain vertexMain;		// NULL for a fragment shader
+	TranspiledFragmentMain fragmentMain;	// NULL for a vertex shader
+};
+
+// from TranspiledShaders.cpp, NULL when path wasn't transpiled
+const TranspiledShader* findTranspiledShader(const char* path);
+
+// Transpiled program
+// ------------------
+/// \note: a vertex + fragment pair for the software rasterizer, the CPU side of Shader:
+///		   varyings are matched by name, uniforms set by name (names neither stage has are
+///		   ignored, as a -1 location is in GL).
+///
+///		   TranspiledProgram program("vertex_shader.vert", "fragment_shader.frag");
+///		   program.setUniform("uTime", &time, 1);
+///		   raster.draw(program.makePipeline(fetch), indices, count);
+class TranspiledProgram
+{
+	const TranspiledShader* vertexShader;
+	const TranspiledShader* fragmentShader;
+	std::vector<float> vertexUniforms;
+	std::vector<float> fragmentUniforms;
+	std::vector<int> varyingOffsets;	// per fragment input, where the vertex stage wrote it
+	int varyingCount;					// floats the vertex stage writes
+	bool valid;
+
+public:
+	TranspiledProgram(const char* vertexPath, const char* fragmentPath);
+
+	// false (and an ERROR line printed) when a stage is missing or the varyings don't link
+	bool isValid() const { return valid; }
+	void setUniform(const char* name, const float* value, int components);
+
+	// fetch(index, attributes) fills 4 floats per attribute location. The pipeline keeps a
+	// copy of the uniforms as they are now
+	typedef std::function<void(unsigned int index, float* attributes)> AttributeFetch;
+	RasterPipeline makePipeline(const AttributeFetch& fetch) const;
+};
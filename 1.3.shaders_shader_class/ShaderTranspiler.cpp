@@ -0,0 +1,943 @@
+#include "ShaderTranspiler.h"
+#include "ShaderLanes.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+// Tokens
+// ------
+enum class TokenType
+{
+	Identifier,
+	Number,
+	Symbol,
+	End
+};
+
+struct Token
+{
+	TokenType type;
+	std::string text;
+	int line;
+};
+
+static void printError(const char* kind, const char* path, int line, const std::string& message)
+{
+	std::cout << "ERROR::TRANSPILER::" << kind << ": " << path << ":" << line << " " << message << std::endl;
+}
+
+// false on anything the subset has no token for
+static bool tokenize(const char* path, const std::string& source, std::vector<Token>& tokens)
+{
+	int line = 1;
+	std::size_t i = 0;
+	while (i < source.size())
+	{
+		char c = source[i];
+		char next = i + 1 < source.size() ? source[i + 1] : '\0';
+		if (c == '\n')
+		{
+			line++;
+			i++;
+		}
+		else if (std::isspace((unsigned char)c))
+		{
+			i++;
+		}
+		else if (c == '/' && next == '/')
+		{
+			while (i < source.size() && source[i] != '\n')
+				i++;
+		}
+		else if (c == '/' && next == '*')
+		{
+			for (i += 2; i < source.size() && !(source[i] == '*' && i + 1 < source.size() && source[i + 1] == '/'); i++)
+			{
+				if (source[i] == '\n')
+					line++;
+			}
+			i += 2;
+		}
+		else if (c == '#')
+		{
+			// #version only, the rest of the preprocessor would change what the code means
+			std::size_t end = source.find('\n', i);
+			if (source.compare(i, 8, "#version") != 0)
+			{
+				printError("UNSUPPORTED", path, line, source.substr(i, end - i));
+				return false;
+			}
+			i = end == std::string::npos ? source.size() : end;
+		}
+		else if (std::isalpha((unsigned char)c) || c == '_')
+		{
+			std::size_t start = i;
+			while (i < source.size() && (std::isalnum((unsigned char)source[i]) || source[i] == '_'))
+				i++;
+			tokens.push_back(Token{ TokenType::Identifier, source.substr(start, i - start), line });
+		}
+		else if (std::isdigit((unsigned char)c) || (c == '.' && std::isdigit((unsigned char)next)))
+		{
+			std::size_t start = i;
+			while (i < source.size() && (std::isdigit((unsigned char)source[i]) || source[i] == '.'))
+				i++;
+			if (i < source.size() && (source[i] == 'e' || source[i] == 'E'))
+			{
+				i++;
+				if (i < source.size() && (source[i] == '+' || source[i] == '-'))
+					i++;
+				while (i < source.size() && std::isdigit((unsigned char)source[i]))
+					i++;
+			}
+			if (i < source.size() && (source[i] == 'f' || source[i] == 'F'))
+				i++;
+			tokens.push_back(Token{ TokenType::Number, source.substr(start, i - start), line });
+		}
+		else if (std::strchr("+-*/", c) != NULL && next == '=')
+		{
+			tokens.push_back(Token{ TokenType::Symbol, source.substr(i, 2), line });
+			i += 2;
+		}
+		else if (c != '\0' && std::strchr("(){};,.=+-*/", c) != NULL)
+		{
+			tokens.push_back(Token{ TokenType::Symbol, std::string(1, c), line });
+			i++;
+		}
+		else
+		{
+			printError("UNSUPPORTED", path, line, std::string("character ") + c);
+			return false;
+		}
+	}
+	tokens.push_back(Token{ TokenType::End, "end of file", line });
+	return true;
+}
+
+// Parser
+// ------
+/// \note: one pass, emitting C++ as it goes. Every expression carries its component count,
+///		   which is all the type checking the subset needs: scalars mix with any vector, two
+///		   vectors have to be the same size.
+struct ShaderSymbol
+{
+	enum Kind
+	{
+		Input,
+		Output,
+		Uniform,
+		Local,
+		Position	// gl_Position
+	};
+
+	std::string name;
+	int components;
+	int location;
+	Kind kind;
+	bool used;
+};
+
+struct Expression
+{
+	std::string code;
+	int components;		// 0 after an error
+};
+
+struct ShaderBuiltin
+{
+	const char* name;
+	const char* function;
+	int arguments;
+};
+
+static const ShaderBuiltin SHADER_BUILTINS[] =
+{
+	{ "min", "glslMin", 2 },
+	{ "max", "glslMax", 2 },
+	{ "clamp", "glslClamp", 3 },
+	{ "mix", "glslMix", 3 },
+	{ "dot", "glslDot", 2 },
+	{ "sin", "glslSin", 1 },
+	{ "cos", "glslCos", 1 }
+};
+
+// GLSL can name a variable like these, the generated C++ can't
+static const char* const RESERVED_NAMES[] =
+{
+	"shaderIn", "shaderUniforms", "shaderPosition", "shaderOut", "assigned", "T", "Vec",
+	"splat", "loadVec", "loadUniform", "storeVec", "makeVec", "swizzle",
+	"auto", "class", "delete", "new", "namespace", "operator", "private", "protected", "public",
+	"template", "this", "typename", "using", "virtual", "static", "std"
+};
+
+static int typeComponents(const Token& token)
+{
+	if (token.type != TokenType::Identifier)
+		return 0;
+	if (token.text == "float")
+		return 1;
+	if (token.text.size() == 4 && token.text.compare(0, 3, "vec") == 0 && token.text[3] >= '2' && token.text[3] <= '4')
+		return token.text[3] - '0';
+	return 0;
+}
+
+static std::string typeName(int components)
+{
+	return components == 1 ? "T" : "Vec<" + std::to_string(components) + ", T>";
+}
+
+// for the errors
+static std::string glslType(int components)
+{
+	return components == 1 ? "float" : "vec" + std::to_string(components);
+}
+
+// "1" -> "1.0f", so it is a float literal in C++ as well
+static std::string floatLiteral(std::string text)
+{
+	if (text.back() == 'f' || text.back() == 'F')
+		text.pop_back();
+	if (text.find_first_of(".eE") == std::string::npos)
+		text += ".0";
+	return "T(" + text + "f)";
+}
+
+class ShaderParser
+{
+	const char* path;
+	const std::vector<Token>& tokens;
+	std::size_t at;
+	bool vertex;
+	bool failed;
+
+	std::vector<ShaderSymbol> globals;	// in declaration order
+	std::map<std::string, ShaderSymbol> locals;
+	std::ostringstream body;
+
+public:
+	ShaderParser(const char* path, const std::vector<Token>& tokens, bool vertex)
+		: path(path), tokens(tokens), at(0), vertex(vertex), failed(false)
+	{
+		if (vertex)
+			globals.push_back(ShaderSymbol{ "gl_Position", 4, -1, ShaderSymbol::Position, false });
+	}
+
+	bool parse();
+	void emit(const std::string& function, const std::string& tables, TranspiledSource& out) const;
+
+private:
+	const Token& peek() const { return tokens[at]; }
+	const Token& next() { return tokens[at < tokens.size() - 1 ? at++ : at]; }
+
+	bool accept(const char* text)
+	{
+		if (peek().type == TokenType::End || peek().text != text)
+			return false;
+		at++;
+		return true;
+	}
+
+	void expect(const char* text)
+	{
+		if (!accept(text))
+			error(peek(), std::string("expected ") + text + ", found " + peek().text);
+	}
+
+	void error(const Token& token, const std::string& message)
+	{
+		// the first one only, the rest would follow from it
+		if (!failed)
+			printError("SYNTAX", path, token.line, message);
+		failed = true;
+	}
+
+	Token expectIdentifier();
+	ShaderSymbol* find(const std::string& name);
+	void declare(const Token& name, int components, int location, ShaderSymbol::Kind kind);
+	int parseLocation();
+	void parseGlobal(ShaderSymbol::Kind kind, int location);
+	void parseMain();
+	void parseStatement();
+	std::vector<int> parseSwizzle(const Token& token, int components);
+
+	Expression parseExpression();
+	Expression parseMultiplicative();
+	Expression parseUnary();
+	Expression parsePostfix();
+	Expression parsePrimary();
+	std::vector<Expression> parseArguments();
+	Expression binary(const Token& token, const Expression& a, char op, const Expression& b);
+	Expression construct(const Token& token, int components, const std::vector<Expression>& arguments);
+	Expression call(const Token& token, const ShaderBuiltin& builtin, const std::vector<Expression>& arguments);
+	Expression widen(const Expression& value, int components);
+};
+
+Token ShaderParser::expectIdentifier()
+{
+	Token token = next();
+	if (token.type != TokenType::Identifier)
+		error(token, "expected a name, found " + token.text);
+	return token;
+}
+
+ShaderSymbol* ShaderParser::find(const std::string& name)
+{
+	std::map<std::string, ShaderSymbol>::iterator local = locals.find(name);
+	if (local != locals.end())
+		return &local->second;
+	for (ShaderSymbol& symbol : globals)
+	{
+		if (symbol.name == name)
+			return &symbol;
+	}
+	return NULL;
+}
+
+void ShaderParser::declare(const Token& name, int components, int location, ShaderSymbol::Kind kind)
+{
+	for (const char* reserved : RESERVED_NAMES)
+	{
+		if (name.text == reserved)
+			error(name, name.text + " is reserved by the generated C++, rename it");
+	}
+	if (name.text.compare(0, 3, "gl_") == 0 || typeComponents(name) > 0)
+		error(name, name.text + " is reserved");
+	if (find(name.text) != NULL)
+		error(name, name.text + " is already declared");
+
+	ShaderSymbol symbol{ name.text, components, location, kind, false };
+	if (kind == ShaderSymbol::Local)
+		locals[name.text] = symbol;
+	else
+		globals.push_back(symbol);
+}
+
+// layout (location = N), after the layout
+int ShaderParser::parseLocation()
+{
+	expect("(");
+	if (!accept("location"))
+		error(peek(), "only layout (location = N) is supported, found " + peek().text);
+	expect("=");
+	Token number = next();
+	if (number.type != TokenType::Number || number.text.find_first_not_of("0123456789") != std::string::npos)
+		error(number, "expected a location, found " + number.text);
+	expect(")");
+	return failed ? -1 : std::atoi(number.text.c_str());
+}
+
+// in / out / uniform <type> <name>;
+void ShaderParser::parseGlobal(ShaderSymbol::Kind kind, int location)
+{
+	Token type = next();
+	int components = typeComponents(type);
+	if (components == 0)
+	{
+		error(type, kind == ShaderSymbol::Uniform && peek().text == "{" ? "uniform blocks are not supported"
+			: "only float and vec2 - vec4 are supported, found " + type.text);
+		return;
+	}
+	Token name = expectIdentifier();
+	expect(";");
+
+	if (kind == ShaderSymbol::Input && vertex)
+	{
+		if (location < 0 || location >= SHADER_MAX_ATTRIBUTES)
+			error(name, "vertex inputs need layout (location = 0 - " + std::to_string(SHADER_MAX_ATTRIBUTES - 1) + ")");
+		for (const ShaderSymbol& symbol : globals)
+		{
+			if (symbol.kind == ShaderSymbol::Input && symbol.location == location)
+				error(name, "location " + std::to_string(location) + " is taken by " + symbol.name);
+		}
+	}
+	declare(name, components, kind == ShaderSymbol::Input && vertex ? location : -1, kind);
+}
+
+bool ShaderParser::parse()
+{
+	while (!failed && peek().type != TokenType::End)
+	{
+		int location = -1;
+		if (accept("layout"))
+			location = parseLocation();
+
+		if (accept("in"))
+			parseGlobal(ShaderSymbol::Input, location);
+		else if (accept("out"))
+			parseGlobal(ShaderSymbol::Output, location);
+		else if (accept("uniform"))
+			parseGlobal(ShaderSymbol::Uniform, location);
+		else if (accept("precision"))
+		{
+			while (!failed && !accept(";"))
+				next();
+		}
+		else if (accept("void"))
+			parseMain();
+		else
+			error(peek(), "unsupported: " + peek().text);
+	}
+	if (failed)
+		return false;
+
+	int varyings = 0;
+	int colors = 0;
+	int colorComponents = 0;
+	for (const ShaderSymbol& symbol : globals)
+	{
+		if ((symbol.kind == ShaderSymbol::Input && !vertex) || (symbol.kind == ShaderSymbol::Output && vertex))
+			varyings += symbol.components;
+		else if (symbol.kind == ShaderSymbol::Output)
+		{
+			colors++;
+			colorComponents = symbol.components;
+		}
+	}
+	if (varyings > RASTER_MAX_VARYINGS)
+		error(peek(), std::to_string(varyings) + " varying floats, the software rasterizer interpolates " + std::to_string(RASTER_MAX_VARYINGS));
+	if (!vertex && (colors != 1 || colorComponents != 4))
+		error(peek(), "a fragment shader has to have one vec4 out");
+	return !failed;
+}
+
+void ShaderParser::parseMain()
+{
+	Token name = expectIdentifier();
+	if (name.text != "main")
+		error(name, "functions other than main are not supported");
+	expect("(");
+	expect(")");
+	expect("{");
+	while (!failed && !accept("}"))
+	{
+		if (peek().type == TokenType::End)
+			error(peek(), "main is missing its }");
+		else
+			parseStatement();
+	}
+}
+
+void ShaderParser::parseStatement()
+{
+	// <type> <name> [= <expression>];
+	int components = typeComponents(peek());
+	if (components > 0)
+	{
+		next();
+		Token name = expectIdentifier();
+		declare(name, components, -1, ShaderSymbol::Local);
+		Expression value{ "splat<" + std::to_string(components) + ">(T(0.0f))", components };
+		if (components == 1)
+			value.code = "T(0.0f)";
+		if (accept("="))
+		{
+			value = parseExpression();
+			if (!failed && value.components != components)
+				error(name, "initializing a " + glslType(components) + " with a " + glslType(value.components));
+		}
+		expect(";");
+		body << "\t" << typeName(components) << " " << name.text << " = " << value.code << ";\n";
+		return;
+	}
+
+	// <name>[.<swizzle>] <op> <expression>;
+	Token name = expectIdentifier();
+	ShaderSymbol* target = find(name.text);
+	if (target == NULL)
+	{
+		error(name, "unknown name " + name.text);
+		return;
+	}
+	if (target->kind == ShaderSymbol::Input || target->kind == ShaderSymbol::Uniform)
+		error(name, name.text + " is read only");
+	target->used = true;
+
+	std::vector<int> lanes;
+	for (int i = 0; i < target->components; i++)
+		lanes.push_back(i);
+	bool swizzled = accept(".");
+	if (swizzled)
+	{
+		lanes = parseSwizzle(next(), target->components);
+		for (std::size_t i = 0; i < lanes.size(); i++)
+		{
+			for (std::size_t j = 0; j < i; j++)
+			{
+				if (lanes[i] == lanes[j])
+					error(name, "a component is assigned twice");
+			}
+		}
+	}
+
+	Token op = next();
+	if (op.text != "=" && op.text != "+=" && op.text != "-=" && op.text != "*=" && op.text != "/=")
+	{
+		error(op, "expected an assignment, found " + op.text);
+		return;
+	}
+	Expression value = parseExpression();
+	expect(";");
+	if (failed)
+		return;
+
+	if (op.text != "=")
+	{
+		Expression current{ target->name, target->components };
+		if (swizzled && lanes.size() == 1)
+			current = Expression{ target->name + ".c[" + std::to_string(lanes[0]) + "]", 1 };
+		else if (swizzled)
+		{
+			current.code = "swizzle<";
+			for (std::size_t i = 0; i < lanes.size(); i++)
+				current.code += (i > 0 ? ", " : "") + std::to_string(lanes[i]);
+			current.code += ">(" + target->name + ")";
+			current.components = (int)lanes.size();
+		}
+		value = binary(op, current, op.text[0], value);
+	}
+	if (value.components != (int)lanes.size())
+	{
+		error(op, "assigning a " + glslType(value.components) + " to a " + glslType((int)lanes.size()));
+		return;
+	}
+
+	if (!swizzled)
+		body << "\t" << target->name << " = " << value.code << ";\n";
+	else if (lanes.size() == 1)
+		body << "\t" << target->name << ".c[" << lanes[0] << "] = " << value.code << ";\n";
+	else
+	{
+		body << "\t{\n\t\t" << typeName((int)lanes.size()) << " assigned = " << value.code << ";\n";
+		for (std::size_t i = 0; i < lanes.size(); i++)
+			body << "\t\t" << target->name << ".c[" << lanes[i] << "] = assigned.c[" << i << "];\n";
+		body << "\t}\n";
+	}
+}
+
+// xyzw, rgba or stpq, not mixed
+std::vector<int> ShaderParser::parseSwizzle(const Token& token, int components)
+{
+	static const char* const SETS[] = { "xyzw", "rgba", "stpq" };
+	std::vector<int> lanes;
+	if (components == 1)
+		error(token, "swizzling a float");
+	if (token.type != TokenType::Identifier || token.text.size() > 4)
+		error(token, "bad swizzle ." + token.text);
+	if (failed)
+		return lanes;
+
+	for (const char* set : SETS)
+	{
+		lanes.clear();
+		for (char c : token.text)
+		{
+			const char* lane = std::strchr(set, c);
+			if (lane == NULL)
+				break;
+			lanes.push_back((int)(lane - set));
+		}
+		if (lanes.size() == token.text.size())
+		{
+			for (int lane : lanes)
+			{
+				if (lane >= components)
+					error(token, "." + token.text + " on a " + glslType(components));
+			}
+			return lanes;
+		}
+	}
+	error(token, "bad swizzle ." + token.text);
+	lanes.assign(1, 0);
+	return lanes;
+}
+
+// Expressions
+// -----------
+Expression ShaderParser::parseExpression()
+{
+	Expression left = parseMultiplicative();
+	while (!failed && (peek().text == "+" || peek().text == "-") && peek().type == TokenType::Symbol)
+	{
+		Token op = next();
+		left = binary(op, left, op.text[0], parseMultiplicative());
+	}
+	return left;
+}
+
+Expression ShaderParser::parseMultiplicative()
+{
+	Expression left = parseUnary();
+	while (!failed && (peek().text == "*" || peek().text == "/") && peek().type == TokenType::Symbol)
+	{
+		Token op = next();
+		left = binary(op, left, op.text[0], parseUnary());
+	}
+	return left;
+}
+
+Expression ShaderParser::parseUnary()
+{
+	if (accept("-"))
+	{
+		Expression value = parseUnary();
+		return Expression{ "(-" + value.code + ")", value.components };
+	}
+	if (accept("+"))
+		return parseUnary();
+	return parsePostfix();
+}
+
+Expression ShaderParser::parsePostfix()
+{
+	Expression value = parsePrimary();
+	while (!failed && accept("."))
+	{
+		std::vector<int> lanes = parseSwizzle(next(), value.components);
+		if (failed)
+			break;
+		if (lanes.size() == 1)
+		{
+			value = Expression{ value.code + ".c[" + std::to_string(lanes[0]) + "]", 1 };
+			continue;
+		}
+		std::string code = "swizzle<";
+		for (std::size_t i = 0; i < lanes.size(); i++)
+			code += (i > 0 ? ", " : "") + std::to_string(lanes[i]);
+		value = Expression{ code + ">(" + value.code + ")", (int)lanes.size() };
+	}
+	return value;
+}
+
+Expression ShaderParser::parsePrimary()
+{
+	Token token = next();
+	if (token.type == TokenType::Number)
+		return Expression{ floatLiteral(token.text), 1 };
+
+	if (token.text == "(" && token.type == TokenType::Symbol)
+	{
+		Expression value = parseExpression();
+		expect(")");
+		return value;
+	}
+
+	if (token.type != TokenType::Identifier)
+	{
+		error(token, "expected an expression, found " + token.text);
+		return Expression{ "", 0 };
+	}
+
+	int components = typeComponents(token);
+	if (components > 0)
+		return construct(token, components, parseArguments());
+	for (const ShaderBuiltin& builtin : SHADER_BUILTINS)
+	{
+		if (token.text == builtin.name)
+			return call(token, builtin, parseArguments());
+	}
+
+	ShaderSymbol* symbol = find(token.text);
+	if (symbol == NULL)
+	{
+		error(token, peek().text == "(" ? "unsupported function " + token.text : "unknown name " + token.text);
+		return Expression{ "", 0 };
+	}
+	symbol->used = true;
+	return Expression{ symbol->name, symbol->components };
+}
+
+std::vector<Expression> ShaderParser::parseArguments()
+{
+	std::vector<Expression> arguments;
+	expect("(");
+	if (accept(")"))
+		return arguments;
+	do
+	{
+		arguments.push_back(parseExpression());
+	}
+	while (!failed && accept(","));
+	expect(")");
+	return arguments;
+}
+
+Expression ShaderParser::binary(const Token& token, const Expression& a, char op, const Expression& b)
+{
+	if (failed)
+		return Expression{ "", 0 };
+	if (a.components != b.components && a.components != 1 && b.components != 1)
+	{
+		error(token, glslType(a.components) + " " + op + " " + glslType(b.components));
+		return Expression{ "", 0 };
+	}
+	return Expression{ "(" + a.code + " " + op + " " + b.code + ")", a.components > b.components ? a.components : b.components };
+}
+
+// vecN(...) and float(...)
+Expression ShaderParser::construct(const Token& token, int components, const std::vector<Expression>& arguments)
+{
+	if (failed)
+		return Expression{ "", 0 };
+	if (arguments.empty())
+	{
+		error(token, token.text + "() without arguments");
+		return Expression{ "", 0 };
+	}
+	if (components == 1)
+	{
+		if (arguments.size() != 1 || arguments[0].components != 1)
+			error(token, "float() takes one float");
+		return arguments[0];
+	}
+	if (arguments.size() == 1 && arguments[0].components == 1)
+		return widen(arguments[0], components);
+
+	// enough components, and none of the arguments entirely past the end
+	int total = 0;
+	std::string code = "makeVec<" + std::to_string(components) + ", T>(";
+	for (std::size_t i = 0; i < arguments.size(); i++)
+	{
+		if (total >= components)
+			error(token, "too many arguments to " + token.text);
+		total += arguments[i].components;
+		code += (i > 0 ? ", " : "") + arguments[i].code;
+	}
+	if (total < components)
+		error(token, "not enough components for " + token.text);
+	return Expression{ code + ")", components };
+}
+
+// component wise, scalars widened to the first argument, except dot
+Expression ShaderParser::call(const Token& token, const ShaderBuiltin& builtin, const std::vector<Expression>& arguments)
+{
+	if (failed)
+		return Expression{ "", 0 };
+	if ((int)arguments.size() != builtin.arguments)
+	{
+		error(token, std::string(builtin.name) + " takes " + std::to_string(builtin.arguments) + " arguments");
+		return Expression{ "", 0 };
+	}
+
+	int components = arguments[0].components;
+	bool dot = std::strcmp(builtin.name, "dot") == 0;
+	std::string code = std::string(builtin.function) + "(";
+	for (std::size_t i = 0; i < arguments.size(); i++)
+	{
+		if (arguments[i].components != components && (dot || arguments[i].components != 1))
+			error(token, std::string(builtin.name) + " with a " + glslType(components) + " and a " + glslType(arguments[i].components));
+		code += (i > 0 ? ", " : "") + widen(arguments[i], components).code;
+	}
+	return Expression{ code + ")", dot ? 1 : components };
+}
+
+Expression ShaderParser::widen(const Expression& value, int components)
+{
+	if (value.components == components)
+		return value;
+	return Expression{ "splat<" + std::to_string(components) + ">(" + value.code + ")", components };
+}
+
+// Emitting
+// --------
+// vertex: (const T* shaderIn, const float* shaderUniforms, T* shaderPosition, T* shaderOut)
+// fragment: (const T* shaderIn, const float* shaderUniforms, T* shaderOut)
+void ShaderParser::emit(const std::string& function, const std::string& tables, TranspiledSource& out) const
+{
+	std::ostringstream code;
+	std::ostringstream stores;
+	std::ostringstream variables[3];	// inputs, outputs, uniforms
+	int counts[3] = { 0, 0, 0 };
+
+	code << "// " << path << "\n";
+	code << "template <typename T>\n";
+	code << "static void " << function << "(const T* shaderIn, const float* shaderUniforms, "
+		<< (vertex ? "T* shaderPosition, " : "") << "T* shaderOut)\n{\n";
+
+	// every stage has the same signature, so the generated file builds warning free
+	bool readsInputs = false, readsUniforms = false, writesOutputs = false;
+	for (const ShaderSymbol& symbol : globals)
+	{
+		readsInputs = readsInputs || (symbol.kind == ShaderSymbol::Input && symbol.used);
+		readsUniforms = readsUniforms || (symbol.kind == ShaderSymbol::Uniform && symbol.used);
+		writesOutputs = writesOutputs || symbol.kind == ShaderSymbol::Output;
+	}
+	if (!readsInputs)
+		code << "\t(void)shaderIn;\n";
+	if (!readsUniforms)
+		code << "\t(void)shaderUniforms;\n";
+	if (!writesOutputs)
+		code << "\t(void)shaderOut;\n";
+
+	int inputOffset = 0;
+	int outputOffset = 0;
+	int uniformOffset = 0;
+	for (const ShaderSymbol& symbol : globals)
+	{
+		std::string n = std::to_string(symbol.components);
+		std::string type = typeName(symbol.components);
+		if (symbol.kind == ShaderSymbol::Input)
+		{
+			// vertex inputs by location, 4 floats each, fragment inputs packed
+			int offset = vertex ? symbol.location * 4 : inputOffset;
+			inputOffset += symbol.components;
+			if (symbol.used && symbol.components == 1)
+				code << "\tT " << symbol.name << " = shaderIn[" << offset << "];\n";
+			else if (symbol.used)
+				code << "\t" << type << " " << symbol.name << " = loadVec<" << n << ">(shaderIn + " << offset << ");\n";
+			variables[0] << "\t{ \"" << symbol.name << "\", " << n << ", " << symbol.location << " },\n";
+			counts[0]++;
+		}
+		else if (symbol.kind == ShaderSymbol::Uniform)
+		{
+			if (symbol.used && symbol.components == 1)
+				code << "\tT " << symbol.name << " = T(shaderUniforms[" << uniformOffset << "]);\n";
+			else if (symbol.used)
+				code << "\t" << type << " " << symbol.name << " = loadUniform<" << n << ", T>(shaderUniforms + " << uniformOffset << ");\n";
+			uniformOffset += symbol.components;
+			variables[2] << "\t{ \"" << symbol.name << "\", " << n << ", -1 },\n";
+			counts[2]++;
+		}
+		else
+		{
+			// outputs and gl_Position start at 0, GLSL leaves them undefined
+			code << "\t" << type << " " << symbol.name << " = "
+				<< (symbol.components == 1 ? std::string("T(0.0f)") : "splat<" + n + ">(T(0.0f))") << ";\n";
+			if (symbol.kind == ShaderSymbol::Position)
+				stores << "\tstoreVec(shaderPosition, " << symbol.name << ");\n";
+			else if (symbol.components == 1)
+				stores << "\tshaderOut[" << outputOffset << "] = " << symbol.name << ";\n";
+			else
+				stores << "\tstoreVec(shaderOut + " << outputOffset << ", " << symbol.name << ");\n";
+			if (symbol.kind == ShaderSymbol::Output)
+			{
+				outputOffset += symbol.components;
+				variables[1] << "\t{ \"" << symbol.name << "\", " << n << ", -1 },\n";
+				counts[1]++;
+			}
+		}
+	}
+	code << "\n" << body.str() << "\n" << stores.str() << "}\n";
+
+	static const char* const SUFFIXES[] = { "_INPUTS", "_OUTPUTS", "_UNIFORMS" };
+	std::ostringstream entry;
+	entry << "\t{ \"" << path << "\"";
+	for (int i = 0; i < 3; i++)
+	{
+		if (counts[i] == 0)
+		{
+			entry << ", NULL, 0";
+			continue;
+		}
+		code << "\nstatic const ShaderVariable " << tables << SUFFIXES[i] << "[] =\n{\n" << variables[i].str() << "};\n";
+		entry << ", " << tables << SUFFIXES[i] << ", " << counts[i];
+	}
+	entry << (vertex ? ", " + function + "<float>, NULL }" : ", NULL, " + function + "<Float8> }");
+
+	out.path = path;
+	out.code = code.str();
+	out.entry = entry.str();
+}
+
+// Transpiler
+// ----------
+bool transpileShader(const char* path, TranspiledSource& out)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "ERROR::TRANSPILER::FAILED_TO_READ: " << path << std::endl;
+		return false;
+	}
+	std::stringstream source;
+	source << file.rdbuf();
+
+	std::size_t length = std::strlen(path);
+	bool vertex = length > 5 && std::strcmp(path + length - 5, ".vert") == 0;
+	bool fragment = length > 5 && std::strcmp(path + length - 5, ".frag") == 0;
+	if (!vertex && !fragment)
+	{
+		std::cout << "ERROR::TRANSPILER::UNKNOWN_STAGE: " << path << ", expected .vert or .frag" << std::endl;
+		return false;
+	}
+
+	std::vector<Token> tokens;
+	if (!tokenize(path, source.str(), tokens))
+		return false;
+	ShaderParser parser(path, tokens, vertex);
+	if (!parser.parse())
+		return false;
+
+	// vertex_color_offset.vert -> vertexColorOffsetVert and VERTEX_COLOR_OFFSET_VERT
+	const char* name = path;
+	for (const char* c = path; *c != '\0'; c++)
+	{
+		if (*c == '/' || *c == '\\')
+			name = c + 1;
+	}
+	std::string function;
+	std::string tables;
+	bool capitalize = false;
+	for (const char* c = name; *c != '\0'; c++)
+	{
+		if (!std::isalnum((unsigned char)*c))
+		{
+			capitalize = !function.empty();
+			if (!tables.empty() && tables.back() != '_')
+				tables += '_';
+			continue;
+		}
+		function += capitalize ? (char)std::toupper((unsigned char)*c) : *c;
+		tables += (char)std::toupper((unsigned char)*c);
+		capitalize = false;
+	}
+	if (function.empty() || std::isdigit((unsigned char)function[0]))
+	{
+		function = "shader" + function;
+		tables = "SHADER_" + tables;
+	}
+
+	parser.emit(function, tables, out);
+	return true;
+}
+
+bool transpileShaders(const std::vector<std::string>& paths, const char* outputPath)
+{
+	std::vector<TranspiledSource> sources(paths.size());
+	bool succeeded = true;
+	for (std::size_t i = 0; i < paths.size(); i++)
+		succeeded = transpileShader(paths[i].c_str(), sources[i]) && succeeded;
+	if (!succeeded)
+		return false;
+
+	std::ofstream output(outputPath, std::ios::binary);
+	if (!output)
+	{
+		std::cout << "ERROR::TRANSPILER::FAILED_TO_WRITE: " << outputPath << std::endl;
+		return false;
+	}
+
+	output << "// Generated by ShaderTranspiler.h from the shaders below, don't edit: change the shader\n";
+	output << "// and run\n";
+	output << "//   1.3.shaders_shader_class --transpile " << outputPath;
+	for (const std::string& path : paths)
+		output << " " << path;
+	output << "\n#include \"ShaderLanes.h\"\n\n#include <cstring>\n";
+	for (const TranspiledSource& source : sources)
+		output << "\n" << source.code;
+
+	output << "\nstatic const TranspiledShader TRANSPILED_SHADERS[] =\n{\n";
+	for (std::size_t i = 0; i < sources.size(); i++)
+		output << sources[i].entry << (i + 1 < sources.size() ? ",\n" : "\n");
+	output << "};\n\n";
+	output << "const TranspiledShader* findTranspiledShader(const char* path)\n{\n";
+	output << "\tfor (const TranspiledShader& shader : TRANSPILED_SHADERS)\n\t{\n";
+	output << "\t\tif (std::strcmp(shader.path, path) == 0)\n\t\t\treturn &shader;\n\t}\n";
+	output << "\treturn NULL;\n}\n";
+
+	std::cout << "TRANSPILER:: " << paths.size() << " shaders -> " << outputPath << std::endl;
+	return true;
+}
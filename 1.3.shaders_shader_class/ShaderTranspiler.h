@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Shader transpiler
+// -----------------
+/// \note: turns the GLSL subset the samples are written in into C++ on ShaderLanes.h, so
+///		   the same .vert / .frag runs in the software rasterizer without a hand port.
+///		   Offline: the output is checked in as TranspiledShaders.cpp, which lists the command
+///		   that regenerates it, to be run whenever one of those shaders changes.
+///		   The subset:
+///		   - float and vec2 - vec4, nothing else (no ints, bools, matrices or arrays)
+///		   - layout (location = N) in (vertex inputs), in, out, uniform
+///		   - void main() made of declarations and assignments (= += -= *= /=) to whole
+///		     variables or swizzles, no control flow
+///		   - + - * /, unary -, constructors, swizzles, min max clamp mix dot sin cos
+///		   Anything outside it (uniform blocks, other built-ins, ...) is an error naming the
+///		   file and the line, and nothing is written.
+struct TranspiledSource
+{
+	std::string path;
+	std::string code;		// the shader's function and its variable tables
+	std::string entry;		// its TranspiledShader initializer
+};
+
+// false (ERROR::TRANSPILER lines printed) when path can't be read or leaves the subset
+bool transpileShader(const char* path, TranspiledSource& out);
+
+// tool: transpiles every path into one .cpp, written only if all of them succeed
+bool transpileShaders(const std::vector<std::string>& paths, const char* outputPath);
@@ -0,0 +1,326 @@
+#pragma once
+
+// SIMD lanes
+// ----------
+/// \note: 8 floats / 8 ints processed together, the width of one software rasterizer tile
+///		   row. Built on AVX2 when the compiler targets it (/arch:AVX2, -mavx2), else on two
+///		   SSE2 halves (every x64 CPU), else on plain arrays, so code written against Float8
+///		   and Int8 compiles everywhere.
+///		   Comparisons return Int8 masks with every bit of a lane set or clear.
+///
+///		   Float8 x = Float8::load(xs);
+///		   Float8 y = x * x + Float8(1.0f);
+///		   Int8 inside = greaterThan(y, Float8(2.0f));
+#if defined(__AVX2__)
+	#define SIMD_LANES_AVX2 1
+	#define SIMD_LANES_SSE2 0
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SIMD_LANES_AVX2 0
+	#define SIMD_LANES_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define SIMD_LANES_AVX2 0
+	#define SIMD_LANES_SSE2 0
+#endif
+
+const int SIMD_LANES = 8;
+
+inline const char* simdLanesName()
+{
+	return SIMD_LANES_AVX2 ? "avx2" : SIMD_LANES_SSE2 ? "sse2" : "scalar";
+}
+
+struct Int8;
+
+struct Float8
+{
+#if SIMD_LANES_AVX2
+	__m256 v;
+#elif SIMD_LANES_SSE2
+	__m128 lo, hi;
+#else
+	float v[8];
+#endif
+
+	Float8() {}
+	Float8(float value)
+	{
+#if SIMD_LANES_AVX2
+		v = _mm256_set1_ps(value);
+#elif SIMD_LANES_SSE2
+		lo = hi = _mm_set1_ps(value);
+#else
+		for (int i = 0; i < 8; i++)
+			v[i] = value;
+#endif
+	}
+
+	static Float8 load(const float* values)
+	{
+		Float8 result;
+#if SIMD_LANES_AVX2
+		result.v = _mm256_loadu_ps(values);
+#elif SIMD_LANES_SSE2
+		result.lo = _mm_loadu_ps(values);
+		result.hi = _mm_loadu_ps(values + 4);
+#else
+		for (int i = 0; i < 8; i++)
+			result.v[i] = values[i];
+#endif
+		return result;
+	}
+
+	void store(float* values) const
+	{
+#if SIMD_LANES_AVX2
+		_mm256_storeu_ps(values, v);
+#elif SIMD_LANES_SSE2
+		_mm_storeu_ps(values, lo);
+		_mm_storeu_ps(values + 4, hi);
+#else
+		for (int i = 0; i < 8; i++)
+			values[i] = v[i];
+#endif
+	}
+};
+
+struct Int8
+{
+#if SIMD_LANES_AVX2
+	__m256i v;
+#elif SIMD_LANES_SSE2
+	__m128i lo, hi;
+#else
+	int v[8];
+#endif
+
+	Int8() {}
+	Int8(int value)
+	{
+#if SIMD_LANES_AVX2
+		v = _mm256_set1_epi32(value);
+#elif SIMD_LANES_SSE2
+		lo = hi = _mm_set1_epi32(value);
+#else
+		for (int i = 0; i < 8; i++)
+			v[i] = value;
+#endif
+	}
+
+	static Int8 load(const int* values)
+	{
+		Int8 result;
+#if SIMD_LANES_AVX2
+		result.v = _mm256_loadu_si256((const __m256i*)values);
+#elif SIMD_LANES_SSE2
+		result.lo = _mm_loadu_si128((const __m128i*)values);
+		result.hi = _mm_loadu_si128((const __m128i*)(values + 4));
+#else
+		for (int i = 0; i < 8; i++)
+			result.v[i] = values[i];
+#endif
+		return result;
+	}
+
+	void store(int* values) const
+	{
+#if SIMD_LANES_AVX2
+		_mm256_storeu_si256((__m256i*)values, v);
+#elif SIMD_LANES_SSE2
+		_mm_storeu_si128((__m128i*)values, lo);
+		_mm_storeu_si128((__m128i*)(values + 4), hi);
+#else
+		for (int i = 0; i < 8; i++)
+			values[i] = v[i];
+#endif
+	}
+};
+
+// one macro per shape of operation, so the three implementations can't drift apart
+#if SIMD_LANES_AVX2
+	#define SIMD_LANES_BINARY(Type, op, avx, sse) \
+		inline Type operator op(const Type& a, const Type& b) { Type r; r.v = avx(a.v, b.v); return r; }
+#elif SIMD_LANES_SSE2
+	#define SIMD_LANES_BINARY(Type, op, avx, sse) \
+		inline Type operator op(const Type& a, const Type& b) { Type r; r.lo = sse(a.lo, b.lo); r.hi = sse(a.hi, b.hi); return r; }
+#else
+	#define SIMD_LANES_BINARY(Type, op, avx, sse) \
+		inline Type operator op(const Type& a, const Type& b) { Type r; for (int i = 0; i < 8; i++) r.v[i] = a.v[i] op b.v[i]; return r; }
+#endif
+
+SIMD_LANES_BINARY(Float8, +, _mm256_add_ps, _mm_add_ps)
+SIMD_LANES_BINARY(Float8, -, _mm256_sub_ps, _mm_sub_ps)
+SIMD_LANES_BINARY(Float8, *, _mm256_mul_ps, _mm_mul_ps)
+SIMD_LANES_BINARY(Float8, /, _mm256_div_ps, _mm_div_ps)
+SIMD_LANES_BINARY(Int8, +, _mm256_add_epi32, _mm_add_epi32)
+SIMD_LANES_BINARY(Int8, -, _mm256_sub_epi32, _mm_sub_epi32)
+SIMD_LANES_BINARY(Int8, &, _mm256_and_si256, _mm_and_si128)
+SIMD_LANES_BINARY(Int8, |, _mm256_or_si256, _mm_or_si128)
+#undef SIMD_LANES_BINARY
+
+inline Float8& operator+=(Float8& a, const Float8& b) { return a = a + b; }
+inline Float8& operator-=(Float8& a, const Float8& b) { return a = a - b; }
+inline Float8& operator*=(Float8& a, const Float8& b) { return a = a * b; }
+inline Int8& operator+=(Int8& a, const Int8& b) { return a = a + b; }
+inline Float8 operator-(const Float8& a) { return Float8(0.0f) - a; }
+
+inline Float8 min(const Float8& a, const Float8& b)
+{
+	Float8 r;
+#if SIMD_LANES_AVX2
+	r.v = _mm256_min_ps(a.v, b.v);
+#elif SIMD_LANES_SSE2
+	r.lo = _mm_min_ps(a.lo, b.lo);
+	r.hi = _mm_min_ps(a.hi, b.hi);
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i];
+#endif
+	return r;
+}
+
+inline Float8 max(const Float8& a, const Float8& b)
+{
+	Float8 r;
+#if SIMD_LANES_AVX2
+	r.v = _mm256_max_ps(a.v, b.v);
+#elif SIMD_LANES_SSE2
+	r.lo = _mm_max_ps(a.lo, b.lo);
+	r.hi = _mm_max_ps(a.hi, b.hi);
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = b.v[i] > a.v[i] ? b.v[i] : a.v[i];
+#endif
+	return r;
+}
+
+inline Float8 clamp(const Float8& x, float low, float high)
+{
+	return min(max(x, Float8(low)), Float8(high));
+}
+
+// a > b per lane, all bits set where true
+inline Int8 greaterThan(const Int8& a, const Int8& b)
+{
+	Int8 r;
+#if SIMD_LANES_AVX2
+	r.v = _mm256_cmpgt_epi32(a.v, b.v);
+#elif SIMD_LANES_SSE2
+	r.lo = _mm_cmpgt_epi32(a.lo, b.lo);
+	r.hi = _mm_cmpgt_epi32(a.hi, b.hi);
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = a.v[i] > b.v[i] ? -1 : 0;
+#endif
+	return r;
+}
+
+inline Int8 greaterThan(const Float8& a, const Float8& b)
+{
+	Int8 r;
+#if SIMD_LANES_AVX2
+	r.v = _mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ));
+#elif SIMD_LANES_SSE2
+	r.lo = _mm_castps_si128(_mm_cmpgt_ps(a.lo, b.lo));
+	r.hi = _mm_castps_si128(_mm_cmpgt_ps(a.hi, b.hi));
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = a.v[i] > b.v[i] ? -1 : 0;
+#endif
+	return r;
+}
+
+// mask ? a : b per lane, mask from a comparison
+inline Int8 select(const Int8& mask, const Int8& a, const Int8& b)
+{
+	Int8 r;
+#if SIMD_LANES_AVX2
+	r.v = _mm256_or_si256(_mm256_and_si256(mask.v, a.v), _mm256_andnot_si256(mask.v, b.v));
+#elif SIMD_LANES_SSE2
+	r.lo = _mm_or_si128(_mm_and_si128(mask.lo, a.lo), _mm_andnot_si128(mask.lo, b.lo));
+	r.hi = _mm_or_si128(_mm_and_si128(mask.hi, a.hi), _mm_andnot_si128(mask.hi, b.hi));
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = (mask.v[i] & a.v[i]) | (~mask.v[i] & b.v[i]);
+#endif
+	return r;
+}
+
+inline Float8 select(const Int8& mask, const Float8& a, const Float8& b)
+{
+	Float8 r;
+#if SIMD_LANES_AVX2
+	__m256 m = _mm256_castsi256_ps(mask.v);
+	r.v = _mm256_or_ps(_mm256_and_ps(m, a.v), _mm256_andnot_ps(m, b.v));
+#elif SIMD_LANES_SSE2
+	__m128 mlo = _mm_castsi128_ps(mask.lo), mhi = _mm_castsi128_ps(mask.hi);
+	r.lo = _mm_or_ps(_mm_and_ps(mlo, a.lo), _mm_andnot_ps(mlo, b.lo));
+	r.hi = _mm_or_ps(_mm_and_ps(mhi, a.hi), _mm_andnot_ps(mhi, b.hi));
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+#endif
+	return r;
+}
+
+inline Int8 shiftLeft(const Int8& a, int bits)
+{
+	Int8 r;
+#if SIMD_LANES_AVX2
+	r.v = _mm256_slli_epi32(a.v, bits);
+#elif SIMD_LANES_SSE2
+	r.lo = _mm_slli_epi32(a.lo, bits);
+	r.hi = _mm_slli_epi32(a.hi, bits);
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = (int)((unsigned int)a.v[i] << bits);
+#endif
+	return r;
+}
+
+// rounds toward zero, like a C cast
+inline Int8 truncate(const Float8& a)
+{
+	Int8 r;
+#if SIMD_LANES_AVX2
+	r.v = _mm256_cvttps_epi32(a.v);
+#elif SIMD_LANES_SSE2
+	r.lo = _mm_cvttps_epi32(a.lo);
+	r.hi = _mm_cvttps_epi32(a.hi);
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = (int)a.v[i];
+#endif
+	return r;
+}
+
+inline Float8 toFloat(const Int8& a)
+{
+	Float8 r;
+#if SIMD_LANES_AVX2
+	r.v = _mm256_cvtepi32_ps(a.v);
+#elif SIMD_LANES_SSE2
+	r.lo = _mm_cvtepi32_ps(a.lo);
+	r.hi = _mm_cvtepi32_ps(a.hi);
+#else
+	for (int i = 0; i < 8; i++)
+		r.v[i] = (float)a.v[i];
+#endif
+	return r;
+}
+
+// bit i set when lane i of a mask is set
+inline int laneMask(const Int8& mask)
+{
+#if SIMD_LANES_AVX2
+	return _mm256_movemask_ps(_mm256_castsi256_ps(mask.v));
+#elif SIMD_LANES_SSE2
+	return _mm_movemask_ps(_mm_castsi128_ps(mask.lo)) | (_mm_movemask_ps(_mm_castsi128_ps(mask.hi)) << 4);
+#else
+	int bits = 0;
+	for (int i = 0; i < 8; i++)
+		bits |= (mask.v[i] < 0 ? 1 : 0) << i;
+	return bits;
+#endif
+}
@@ -0,0 +1,56 @@
+#include "SoftwarePresenter.h"
+#include "GLDebug.h"
+
+#include <algorithm>
+#include <iostream>
+
+SoftwarePresenter::SoftwarePresenter()
+	: texture(0), FBO(0), allocatedWidth(0), allocatedHeight(0)
+{
+}
+
+SoftwarePresenter::~SoftwarePresenter()
+{
+	glDeleteFramebuffers(1, &FBO);
+	glDeleteTextures(1, &texture);
+}
+
+void SoftwarePresenter::present(const SoftwareRasterizer& raster)
+{
+	int width = raster.getWidth(), height = raster.getHeight();
+	GLint previousRead;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+
+	if (width > allocatedWidth || height > allocatedHeight)
+	{
+		glDeleteFramebuffers(1, &FBO);
+		glDeleteTextures(1, &texture);
+		allocatedWidth = std::max(width, allocatedWidth);
+		allocatedHeight = std::max(height, allocatedHeight);
+
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, allocatedWidth, allocatedHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glGenFramebuffers(1, &FBO);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+		if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "ERROR::SOFTWARE_PRESENTER::FRAMEBUFFER_INCOMPLETE " << allocatedWidth << "x" << allocatedHeight << std::endl;
+	}
+
+	// rows are pitch pixels apart in the raster
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, raster.getPitch());
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, raster.getPixels());
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+	glCheckError();
+}
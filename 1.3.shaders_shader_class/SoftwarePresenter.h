@@ -0,0 +1,25 @@
+#pragma once
+#include "SoftwareRasterizer.h"
+
+// Software presenter
+// ------------------
+/// \note: puts a SoftwareRasterizer frame on screen: uploads it into a texture whose storage
+///		   only grows (like the render target pool) and blits it into the framebuffer bound
+///		   for drawing, at the raster's size. Everything after the scene pass, present() of
+///		   the ResizeManager and the pacer, stays the same as with the GL backend.
+class SoftwarePresenter
+{
+	unsigned int texture;
+	unsigned int FBO;
+	int allocatedWidth;
+	int allocatedHeight;
+
+public:
+	SoftwarePresenter();
+	~SoftwarePresenter();
+
+	SoftwarePresenter(const SoftwarePresenter&) = delete;
+	SoftwarePresenter& operator=(const SoftwarePresenter&) = delete;
+
+	void present(const SoftwareRasterizer& raster);
+};
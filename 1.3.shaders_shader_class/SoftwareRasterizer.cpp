@@ -0,0 +1,675 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// positions are snapped to 1/16 pixel, as most GPUs do
+static const int SUBPIXEL_BITS = 4;
+static const int SUBPIXEL = 1 << SUBPIXEL_BITS;
+// vertices further out are dropped rather than clipped. With the largest target this keeps
+// every edge function value inside a tile an edge crosses within 32 bits
+static const float GUARD_BAND = 16384.0f;
+
+static const int LANE_INDICES[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+static const float LANE_CENTERS[8] = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+
+static unsigned int packColor(float r, float g, float b, float a)
+{
+	float c[4] = { r, g, b, a };
+	unsigned int packed = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		float unorm = std::min(std::max(c[i], 0.0f), 1.0f) * 255.0f + 0.5f;
+		packed |= (unsigned int)unorm << (i * 8);
+	}
+	return packed;
+}
+
+static int popCount(int bits)
+{
+	int count = 0;
+	for (; bits != 0; bits &= bits - 1)
+		count++;
+	return count;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Workers
+// -------
+/// \note: threads that stay alive between frames and run one job at a time on all of them,
+///		   the calling thread being thread 0, so a phase costs a wake up instead of starting
+///		   threads the way parallelFor in MeshWelder.cpp does.
+class RasterWorkers
+{
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable started;
+	std::condition_variable finished;
+	std::function<void(unsigned int)> job;
+	unsigned long long generation;
+	unsigned int running;
+	bool quit;
+
+public:
+	RasterWorkers(unsigned int count)
+		: generation(0), running(0), quit(false)
+	{
+		for (unsigned int t = 1; t < count; t++)
+			threads.emplace_back(&RasterWorkers::work, this, t);
+	}
+
+	~RasterWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		started.notify_all();
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	// job(thread) on every thread, returns once all of them are done
+	void run(const std::function<void(unsigned int)>& job)
+	{
+		if (threads.empty())
+		{
+			job(0);
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			this->job = job;
+			running = (unsigned int)threads.size();
+			generation++;
+		}
+		started.notify_all();
+		job(0);
+
+		std::unique_lock<std::mutex> lock(mutex);
+		finished.wait(lock, [this] { return running == 0; });
+	}
+
+private:
+	void work(unsigned int index)
+	{
+		unsigned long long seen = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;)
+		{
+			started.wait(lock, [&] { return quit || generation != seen; });
+			if (quit)
+				return;
+			seen = generation;
+			// job only changes once every thread has finished it
+			lock.unlock();
+			job(index);
+			lock.lock();
+			if (--running == 0)
+				finished.notify_one();
+		}
+	}
+};
+
+// Triangle setup
+// --------------
+/// \note: edges are E(x, y) = A x + B y + C on the snapped positions, positive inside once the
+///		   triangle is counter-clockwise. The fill rule is folded into a bias: pixel centers
+///		   exactly on a left or top edge are inside, on any other edge outside, so E + bias
+///		   >= 0 is the whole test. Varyings are planes over the window (value / w and 1 / w,
+///		   divided back per pixel), set up in double and evaluated in float.
+struct Edge
+{
+	long long A, B, C;
+	long long bias;
+};
+
+static Edge setupEdge(long long ax, long long ay, long long bx, long long by)
+{
+	Edge edge;
+	edge.A = ay - by;
+	edge.B = bx - ax;
+	edge.C = -(edge.A * ax + edge.B * ay);
+	// interior on the left: a left edge runs down, a top edge runs left
+	bool topLeft = by < ay || (by == ay && bx < ax);
+	edge.bias = topLeft ? 0 : -1;
+	return edge;
+}
+
+struct Plane
+{
+	float a, b, c;
+};
+
+static Plane setupPlane(const double* x, const double* y, double f0, double f1, double f2)
+{
+	double dx1 = x[1] - x[0], dy1 = y[1] - y[0];
+	double dx2 = x[2] - x[0], dy2 = y[2] - y[0];
+	double area = dx1 * dy2 - dx2 * dy1;
+	double a = ((f1 - f0) * dy2 - (f2 - f0) * dy1) / area;
+	double b = ((f2 - f0) * dx1 - (f1 - f0) * dx2) / area;
+	return Plane{ (float)a, (float)b, (float)(f0 - a * x[0] - b * y[0]) };
+}
+
+struct TriangleSetup
+{
+	Edge edges[3];
+	Plane w;
+	Plane varyings[RASTER_MAX_VARYINGS];
+	const RasterPipeline* pipeline;
+	int minX, minY, maxX, maxY;		// pixels, inside the target
+};
+
+enum class SetupResult { Visible, Dropped, Outside };
+
+static SetupResult setupTriangle(int width, int height, const RasterPipeline& pipeline,
+	const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, TriangleSetup& setup)
+{
+	const RasterVertex* v[3] = { &v0, &v1, &v2 };
+
+	// viewport transform and snapping
+	long long sx[3], sy[3];
+	double oneOverW[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const float* p = v[i]->position;
+		if (!(p[3] > 0.0f))
+			return SetupResult::Dropped;
+		float windowX = (p[0] / p[3] * 0.5f + 0.5f) * width;
+		float windowY = (p[1] / p[3] * 0.5f + 0.5f) * height;
+		if (!(std::fabs(windowX) <= GUARD_BAND && std::fabs(windowY) <= GUARD_BAND))
+			return SetupResult::Dropped;
+		sx[i] = (long long)std::floor(windowX * SUBPIXEL + 0.5f);
+		sy[i] = (long long)std::floor(windowY * SUBPIXEL + 0.5f);
+		oneOverW[i] = 1.0 / p[3];
+	}
+
+	long long area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+	if (area == 0)
+		return SetupResult::Dropped;
+	if (area < 0)
+	{
+		// both windings are drawn, clockwise ones are turned around
+		std::swap(v[1], v[2]);
+		std::swap(sx[1], sx[2]);
+		std::swap(sy[1], sy[2]);
+		std::swap(oneOverW[1], oneOverW[2]);
+	}
+
+	// bounding box in pixels, inside the target
+	long long minX = std::min(sx[0], std::min(sx[1], sx[2])), maxX = std::max(sx[0], std::max(sx[1], sx[2]));
+	long long minY = std::min(sy[0], std::min(sy[1], sy[2])), maxY = std::max(sy[0], std::max(sy[1], sy[2]));
+	if (maxX < 0 || maxY < 0)
+		return SetupResult::Outside;
+	setup.minX = (int)std::max(minX / SUBPIXEL, 0LL);
+	setup.minY = (int)std::max(minY / SUBPIXEL, 0LL);
+	setup.maxX = (int)std::min(maxX / SUBPIXEL, (long long)width - 1);
+	setup.maxY = (int)std::min(maxY / SUBPIXEL, (long long)height - 1);
+	if (setup.minX > setup.maxX || setup.minY > setup.maxY)
+		return SetupResult::Outside;
+
+	setup.edges[0] = setupEdge(sx[1], sy[1], sx[2], sy[2]);
+	setup.edges[1] = setupEdge(sx[2], sy[2], sx[0], sy[0]);
+	setup.edges[2] = setupEdge(sx[0], sy[0], sx[1], sy[1]);
+
+	double px[3], py[3];
+	for (int i = 0; i < 3; i++)
+	{
+		px[i] = (double)sx[i] / SUBPIXEL;
+		py[i] = (double)sy[i] / SUBPIXEL;
+	}
+	setup.w = setupPlane(px, py, oneOverW[0], oneOverW[1], oneOverW[2]);
+	for (int k = 0; k < pipeline.varyingCount; k++)
+	{
+		setup.varyings[k] = setupPlane(px, py, v[0]->varyings[k] * oneOverW[0],
+			v[1]->varyings[k] * oneOverW[1], v[2]->varyings[k] * oneOverW[2]);
+	}
+	setup.pipeline = &pipeline;
+	return SetupResult::Visible;
+}
+
+// Tiles
+// -----
+// the part of one triangle inside [x0, x1) x [y0, y1), 8x8 tile aligned
+static void rasterTriangle(const TriangleSetup& setup, int x0, int y0, int x1, int y1,
+	unsigned int* color, int pitch, RasterStats& stats)
+{
+	int firstTileX = std::max(setup.minX, x0) / RASTER_TILE_SIZE;
+	int firstTileY = std::max(setup.minY, y0) / RASTER_TILE_SIZE;
+	int lastTileX = std::min(setup.maxX, x1 - 1) / RASTER_TILE_SIZE;
+	int lastTileY = std::min(setup.maxY, y1 - 1) / RASTER_TILE_SIZE;
+	const RasterPipeline& pipeline = *setup.pipeline;
+	const Edge* edges = setup.edges;
+
+	// per pixel steps of each edge along a row
+	const long long TILE_SPAN = (RASTER_TILE_SIZE - 1) * SUBPIXEL;
+	Int8 laneSteps[3];
+	for (int e = 0; e < 3; e++)
+	{
+		int steps[8];
+		for (int lane = 0; lane < 8; lane++)
+			steps[lane] = (int)(edges[e].A * SUBPIXEL * lane);
+		laneSteps[e] = Int8::load(steps);
+	}
+	Float8 laneX = Float8::load(LANE_CENTERS);
+
+	for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+	{
+		for (int tileX = firstTileX; tileX <= lastTileX; tileX++)
+		{
+			int tx = tileX * RASTER_TILE_SIZE, ty = tileY * RASTER_TILE_SIZE;
+			long long sampleX = (long long)tx * SUBPIXEL + SUBPIXEL / 2;
+			long long sampleY = (long long)ty * SUBPIXEL + SUBPIXEL / 2;
+
+			// each edge at the tile's first pixel center, then its smallest and largest
+			// value over the tile decide: all outside, all inside, or crossing
+			long long origin[3];
+			bool crossing[3];
+			bool rejected = false, full = true;
+			for (int e = 0; e < 3; e++)
+			{
+				const Edge& edge = edges[e];
+				origin[e] = edge.A * sampleX + edge.B * sampleY + edge.C + edge.bias;
+				long long low = origin[e] + std::min(0LL, edge.A * TILE_SPAN) + std::min(0LL, edge.B * TILE_SPAN);
+				long long high = origin[e] + std::max(0LL, edge.A * TILE_SPAN) + std::max(0LL, edge.B * TILE_SPAN);
+				rejected = rejected || high < 0;
+				crossing[e] = low < 0;
+				full = full && !crossing[e];
+			}
+			if (rejected)
+				continue;
+
+			// the last tile column and row may hang over the target's edge
+			int columns = std::min(RASTER_TILE_SIZE, x1 - tx);
+			int rows = std::min(RASTER_TILE_SIZE, y1 - ty);
+			Int8 scissor = greaterThan(Int8(columns), Int8::load(LANE_INDICES));
+			if (full && columns == RASTER_TILE_SIZE && rows == RASTER_TILE_SIZE)
+				stats.fullTiles++;
+			else
+				stats.partialTiles++;
+
+			Int8 rowEdges[3];
+			for (int e = 0; e < 3; e++)
+			{
+				if (crossing[e])
+					rowEdges[e] = Int8((int)origin[e]) + laneSteps[e];
+			}
+
+			FragmentLanes fragment;
+			fragment.x = Float8((float)tx) + laneX;
+			for (int row = 0; row < rows; row++)
+			{
+				Int8 covered = scissor;
+				for (int e = 0; e < 3; e++)
+				{
+					if (crossing[e])
+					{
+						covered = covered & greaterThan(rowEdges[e], Int8(-1));
+						rowEdges[e] += Int8((int)(edges[e].B * SUBPIXEL));
+					}
+				}
+				int mask = laneMask(covered);
+				if (mask == 0)
+					continue;
+
+				int y = ty + row;
+				fragment.y = Float8(y + 0.5f);
+				fragment.covered = covered;
+				Float8 w = Float8(1.0f) / (Float8(setup.w.a) * fragment.x + Float8(setup.w.b) * fragment.y + Float8(setup.w.c));
+				for (int k = 0; k < pipeline.varyingCount; k++)
+				{
+					const Plane& plane = setup.varyings[k];
+					fragment.varyings[k] = (Float8(plane.a) * fragment.x + Float8(plane.b) * fragment.y + Float8(plane.c)) * w;
+				}
+
+				FragmentColor out;
+				pipeline.fragment(fragment, out);
+				stats.fragmentCalls++;
+				stats.pixels += popCount(mask);
+
+				// to unorm8 with round to nearest, packed R in the low byte
+				Float8 half(0.5f), scale(255.0f);
+				Int8 packed = truncate(clamp(out.r, 0.0f, 1.0f) * scale + half)
+					| shiftLeft(truncate(clamp(out.g, 0.0f, 1.0f) * scale + half), 8)
+					| shiftLeft(truncate(clamp(out.b, 0.0f, 1.0f) * scale + half), 16)
+					| shiftLeft(truncate(clamp(out.a, 0.0f, 1.0f) * scale + half), 24);
+				int* target = (int*)&color[(std::size_t)y * pitch + tx];
+				select(covered, packed, Int8::load(target)).store(target);
+			}
+		}
+	}
+}
+
+// Threads
+// -------
+struct RasterThread
+{
+	std::vector<TriangleSetup> setups;
+	std::vector<std::vector<unsigned int>> bins;	// setups per bin, in submission order
+	RasterStats stats;
+	// bins [begin, end) this thread has left in the raster phase, begin in the low half.
+	// The owner takes from begin, thieves from end, each with one compare-exchange
+	std::atomic<unsigned long long> range;
+	char padding[64];	// keeps the next thread's range off this cache line
+};
+
+static unsigned long long packRange(unsigned int begin, unsigned int end)
+{
+	return (unsigned long long)end << 32 | begin;
+}
+
+static bool takeBin(std::atomic<unsigned long long>& range, int& bin)
+{
+	unsigned long long current = range.load();
+	for (;;)
+	{
+		unsigned int begin = (unsigned int)current, end = (unsigned int)(current >> 32);
+		if (begin >= end)
+			return false;
+		if (range.compare_exchange_weak(current, packRange(begin + 1, end)))
+		{
+			bin = (int)begin;
+			return true;
+		}
+	}
+}
+
+// the back half (rounded up) of what the victim has left
+static bool stealBins(std::atomic<unsigned long long>& victim, unsigned int& begin, unsigned int& end)
+{
+	unsigned long long current = victim.load();
+	for (;;)
+	{
+		unsigned int first = (unsigned int)current, last = (unsigned int)(current >> 32);
+		if (first >= last)
+			return false;
+		unsigned int split = last - (last - first + 1) / 2;
+		if (victim.compare_exchange_weak(current, packRange(first, split)))
+		{
+			begin = split;
+			end = last;
+			return true;
+		}
+	}
+}
+
+static void addStats(RasterStats& total, const RasterStats& part)
+{
+	total.triangles += part.triangles;
+	total.dropped += part.dropped;
+	total.binEntries += part.binEntries;
+	total.fullTiles += part.fullTiles;
+	total.partialTiles += part.partialTiles;
+	total.fragmentCalls += part.fragmentCalls;
+	total.pixels += part.pixels;
+	total.steals += part.steals;
+}
+
+// Rasterizer
+// ----------
+SoftwareRasterizer::SoftwareRasterizer(unsigned int threadCount)
+	: width(0), height(0), pitch(0), storedHeight(0), binsX(0), binsY(0), clearPending(false), clearValue(0),
+	vertexCount(0), triangleCount(0)
+{
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	for (unsigned int t = 0; t < threadCount; t++)
+	{
+		threads.push_back(new RasterThread());
+	}
+	workers = new RasterWorkers(threadCount);
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+	delete workers;
+	for (RasterThread* thread : threads)
+	{
+		delete thread;
+	}
+}
+
+void SoftwareRasterizer::resize(int width, int height)
+{
+	finish();
+	this->width = std::min(std::max(width, 1), RASTER_MAX_SIZE);
+	this->height = std::min(std::max(height, 1), RASTER_MAX_SIZE);
+	binsX = (this->width + RASTER_BIN_SIZE - 1) / RASTER_BIN_SIZE;
+	binsY = (this->height + RASTER_BIN_SIZE - 1) / RASTER_BIN_SIZE;
+	pitch = binsX * RASTER_BIN_SIZE;
+	storedHeight = binsY * RASTER_BIN_SIZE;
+	if (color.size() < (std::size_t)pitch * storedHeight)
+		color.resize((std::size_t)pitch * storedHeight);
+}
+
+void SoftwareRasterizer::clear(float r, float g, float b, float a)
+{
+	// draws queued before it are drawn before it
+	if (!draws.empty())
+		finish();
+	clearPending = true;
+	clearValue = packColor(r, g, b, a);
+}
+
+void SoftwareRasterizer::draw(const RasterPipeline& pipeline, const unsigned int* indices, unsigned int indexCount)
+{
+	if (width == 0 || !pipeline.vertex || !pipeline.fragment || pipeline.varyingCount > RASTER_MAX_VARYINGS)
+	{
+		std::cout << "ERROR::SOFTWARE_RASTERIZER::INVALID_DRAW" << std::endl;
+		return;
+	}
+
+	Draw draw;
+	draw.pipeline = pipeline;
+	draw.indices.assign(indices, indices + indexCount - indexCount % 3);
+	// the vertex stage runs once for every vertex up to the largest index
+	draw.vertexCount = 0;
+	for (unsigned int index : draw.indices)
+	{
+		draw.vertexCount = std::max(draw.vertexCount, index + 1);
+	}
+	draw.vertexOffset = vertexCount;
+	draw.triangleOffset = triangleCount;
+	vertexCount += draw.vertexCount;
+	triangleCount += (unsigned int)draw.indices.size() / 3;
+	draws.push_back(std::move(draw));
+}
+
+void SoftwareRasterizer::shadeVertices(unsigned int thread)
+{
+	unsigned int count = (unsigned int)threads.size();
+	unsigned int begin = (unsigned int)((unsigned long long)vertexCount * thread / count);
+	unsigned int end = (unsigned int)((unsigned long long)vertexCount * (thread + 1) / count);
+	for (const Draw& draw : draws)
+	{
+		unsigned int first = std::max(begin, draw.vertexOffset);
+		unsigned int last = std::min(end, draw.vertexOffset + draw.vertexCount);
+		for (unsigned int i = first; i < last; i++)
+		{
+			draw.pipeline.vertex(i - draw.vertexOffset, vertices[i]);
+		}
+	}
+}
+
+void SoftwareRasterizer::binTriangles(unsigned int thread)
+{
+	RasterThread& state = *threads[thread];
+	state.setups.clear();
+	state.bins.resize((std::size_t)binsX * binsY);
+	for (std::vector<unsigned int>& bin : state.bins)
+	{
+		bin.clear();
+	}
+
+	// a contiguous run of triangles, so the bins of thread 0, 1, ... in turn are in
+	// submission order
+	unsigned int count = (unsigned int)threads.size();
+	unsigned int begin = (unsigned int)((unsigned long long)triangleCount * thread / count);
+	unsigned int end = (unsigned int)((unsigned long long)triangleCount * (thread + 1) / count);
+	TriangleSetup setup;
+	for (const Draw& draw : draws)
+	{
+		unsigned int first = std::max(begin, draw.triangleOffset);
+		unsigned int last = std::min(end, draw.triangleOffset + (unsigned int)draw.indices.size() / 3);
+		const RasterVertex* drawVertices = &vertices[draw.vertexOffset];
+		for (unsigned int t = first; t < last; t++)
+		{
+			const unsigned int* triangle = &draw.indices[(t - draw.triangleOffset) * 3];
+			state.stats.triangles++;
+			SetupResult result = setupTriangle(width, height, draw.pipeline,
+				drawVertices[triangle[0]], drawVertices[triangle[1]], drawVertices[triangle[2]], setup);
+			if (result == SetupResult::Dropped)
+				state.stats.dropped++;
+			if (result != SetupResult::Visible)
+				continue;
+
+			unsigned int index = (unsigned int)state.setups.size();
+			state.setups.push_back(setup);
+			for (int binY = setup.minY / RASTER_BIN_SIZE; binY <= setup.maxY / RASTER_BIN_SIZE; binY++)
+			{
+				for (int binX = setup.minX / RASTER_BIN_SIZE; binX <= setup.maxX / RASTER_BIN_SIZE; binX++)
+				{
+					state.bins[binY * binsX + binX].push_back(index);
+					state.stats.binEntries++;
+				}
+			}
+		}
+	}
+}
+
+void SoftwareRasterizer::rasterBin(RasterThread& thread, int bin)
+{
+	int x0 = bin % binsX * RASTER_BIN_SIZE, y0 = bin / binsX * RASTER_BIN_SIZE;
+	if (clearPending)
+	{
+		for (int y = y0; y < y0 + RASTER_BIN_SIZE; y++)
+		{
+			unsigned int* row = &color[(std::size_t)y * pitch + x0];
+			std::fill(row, row + RASTER_BIN_SIZE, clearValue);
+		}
+	}
+
+	int x1 = std::min(x0 + RASTER_BIN_SIZE, width), y1 = std::min(y0 + RASTER_BIN_SIZE, height);
+	for (const RasterThread* source : threads)
+	{
+		for (unsigned int index : source->bins[bin])
+		{
+			rasterTriangle(source->setups[index], x0, y0, x1, y1, color.data(), pitch, thread.stats);
+		}
+	}
+}
+
+void SoftwareRasterizer::rasterBins(unsigned int thread)
+{
+	RasterThread& state = *threads[thread];
+	unsigned int count = (unsigned int)threads.size();
+	for (;;)
+	{
+		int bin;
+		while (takeBin(state.range, bin))
+		{
+			rasterBin(state, bin);
+		}
+
+		// out of bins, take half of someone else's
+		bool stolen = false;
+		for (unsigned int k = 1; k < count && !stolen; k++)
+		{
+			unsigned int begin, end;
+			if (stealBins(threads[(thread + k) % count]->range, begin, end))
+			{
+				state.range.store(packRange(begin, end));
+				state.stats.steals++;
+				stolen = true;
+			}
+		}
+		if (!stolen)
+			return;
+	}
+}
+
+void SoftwareRasterizer::finish()
+{
+	if (draws.empty() && !clearPending)
+		return;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	vertices.resize(vertexCount);
+	workers->run([this](unsigned int thread) { shadeVertices(thread); });
+	stats.vertexMs += millisecondsSince(start);
+
+	start = std::chrono::steady_clock::now();
+	workers->run([this](unsigned int thread) { binTriangles(thread); });
+	stats.binningMs += millisecondsSince(start);
+
+	// an even split of the bins to start from
+	start = std::chrono::steady_clock::now();
+	unsigned int count = (unsigned int)threads.size(), binCount = (unsigned int)(binsX * binsY);
+	for (unsigned int t = 0; t < count; t++)
+	{
+		threads[t]->range.store(packRange(binCount * t / count, binCount * (t + 1) / count));
+	}
+	workers->run([this](unsigned int thread) { rasterBins(thread); });
+	stats.rasterMs += millisecondsSince(start);
+
+	for (RasterThread* thread : threads)
+	{
+		addStats(stats, thread->stats);
+		thread->stats = RasterStats();
+	}
+	stats.frames++;
+	draws.clear();
+	vertexCount = 0;
+	triangleCount = 0;
+	clearPending = false;
+}
+
+void SoftwareRasterizer::readPixels(unsigned char* rgba) const
+{
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned int* row = &color[(std::size_t)y * pitch];
+		for (int x = 0; x < width; x++)
+		{
+			unsigned int pixel = row[x];
+			unsigned char* out = &rgba[((std::size_t)y * width + x) * 4];
+			out[0] = (unsigned char)(pixel & 0xff);
+			out[1] = (unsigned char)((pixel >> 8) & 0xff);
+			out[2] = (unsigned char)((pixel >> 16) & 0xff);
+			out[3] = (unsigned char)(pixel >> 24);
+		}
+	}
+}
+
+void SoftwareRasterizer::printStats() const
+{
+	std::cout << "SOFTWARE::STATS simd=" << simdLanesName()
+		<< " threads=" << threads.size()
+		<< " triangles=" << stats.triangles
+		<< " dropped=" << stats.dropped
+		<< " bin_entries=" << stats.binEntries
+		<< " full_tiles=" << stats.fullTiles
+		<< " partial_tiles=" << stats.partialTiles
+		<< " fragment_calls=" << stats.fragmentCalls
+		<< " pixels=" << stats.pixels
+		<< " lane_use=" << (stats.fragmentCalls > 0 ? (double)stats.pixels / (stats.fragmentCalls * SIMD_LANES) : 0.0)
+		<< " steals=" << stats.steals << std::endl;
+
+	double frames = stats.frames > 0 ? (double)stats.frames : 1.0;
+	std::cout << "SOFTWARE::PHASES frames=" << stats.frames
+		<< " vertex_ms=" << stats.vertexMs / frames
+		<< " binning_ms=" << stats.binningMs / frames
+		<< " raster_ms=" << stats.rasterMs / frames
+		<< " total_ms=" << (stats.vertexMs + stats.binningMs + stats.rasterMs) / frames << std::endl;
+}
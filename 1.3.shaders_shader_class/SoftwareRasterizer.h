@@ -0,0 +1,161 @@
+#pragma once
+#include <functional>
+#include <vector>
+
+#include "SimdLanes.h"
+
+// Software rasterizer
+// -------------------
+/// \note: the CPU backend, a reference that needs no GPU and renders the same image on every
+///		   machine. draw() only queues; finish() renders everything queued since the last one
+///		   in three phases (sort-middle, as tiled GPUs do):
+///		   - vertex: the vertex stage once per vertex, vertices split evenly over the threads
+///		   - binning: each thread sets up a contiguous run of triangles (positions snapped to
+///		     1/16 pixel, edge functions, varying planes) and files them into its own bins,
+///		     one per 64x64 pixel block they overlap, so nothing is shared while binning
+///		   - raster: threads take whole bins, starting from an even split of them and
+///		     stealing half of what another thread has left once theirs run out, and draw
+///		     the bin's triangles from every thread's bins in submission order. Inside a bin a
+///		     triangle is walked in 8x8 tiles: integer edge functions at the tile corners
+///		     reject it or accept it whole, only tiles an edge crosses test coverage per pixel.
+///		     The fragment stage shades one tile row (8 pixels, Float8 lanes) per call.
+///		   Bins never overlap, so the raster phase writes without locks, and the image is the
+///		   same whatever the thread count.
+///		   Follows GL where the samples can tell: pixel centers at +0.5, the origin bottom
+///		   left, both windings drawn, a top-left fill rule so shared edges are drawn once,
+///		   perspective correct varyings. Not implemented: clipping (triangles with a vertex at
+///		   w <= 0 or beyond the guard band are dropped and counted), depth, blending.
+///		   The stages run during finish(), on any thread, so they must not refer to anything
+///		   that is gone by then (capture uniforms by value) and must not write shared state.
+///
+///		   SoftwareRasterizer raster(0);   // all cores
+///		   RasterPipeline pipeline;
+///		   pipeline.varyingCount = 3;
+///		   pipeline.vertex = [&](unsigned int i, RasterVertex& out) { ... };
+///		   pipeline.fragment = [=](const FragmentLanes& in, FragmentColor& out) { ... };
+///		   raster.resize(800, 600);
+///		   raster.clear(0.2f, 0.3f, 0.3f, 1.0f);
+///		   raster.draw(pipeline, indices, 6);
+///		   raster.finish();
+const int RASTER_TILE_SIZE = 8;
+const int RASTER_BIN_SIZE = 64;
+const int RASTER_MAX_VARYINGS = 8;
+const int RASTER_MAX_SIZE = 8192;
+
+struct RasterVertex
+{
+	float position[4];	// clip space, like gl_Position
+	float varyings[RASTER_MAX_VARYINGS];
+};
+
+// 8 horizontally adjacent pixels, x and y at the pixel centers. covered has every bit set
+// in the lanes inside the triangle, the stage may skip the others or shade them anyway
+struct FragmentLanes
+{
+	Float8 x;
+	Float8 y;
+	Float8 varyings[RASTER_MAX_VARYINGS];
+	Int8 covered;
+};
+
+struct FragmentColor
+{
+	Float8 r, g, b, a;
+};
+
+typedef std::function<void(unsigned int index, RasterVertex& out)> VertexStage;
+typedef std::function<void(const FragmentLanes& in, FragmentColor& out)> FragmentStage;
+
+struct RasterPipeline
+{
+	VertexStage vertex;
+	FragmentStage fragment;
+	int varyingCount{ 0 };
+};
+
+struct RasterStats
+{
+	unsigned long long triangles{ 0 };
+	unsigned long long dropped{ 0 };		// degenerate, behind the eye or outside the guard band
+	unsigned long long binEntries{ 0 };		// triangle x bin pairs
+	unsigned long long fullTiles{ 0 };		// inside all three edges, no coverage test
+	unsigned long long partialTiles{ 0 };
+	unsigned long long fragmentCalls{ 0 };	// rows of 8 shaded
+	unsigned long long pixels{ 0 };			// covered pixels written
+	unsigned long long steals{ 0 };
+	// finish() calls and the time in each phase over all of them, wall clock
+	unsigned long long frames{ 0 };
+	double vertexMs{ 0.0 };
+	double binningMs{ 0.0 };
+	double rasterMs{ 0.0 };
+};
+
+class RasterWorkers;
+struct RasterThread;
+
+class SoftwareRasterizer
+{
+	struct Draw
+	{
+		RasterPipeline pipeline;
+		std::vector<unsigned int> indices;
+		unsigned int vertexOffset;		// into vertices
+		unsigned int vertexCount;
+		unsigned int triangleOffset;	// over every queued draw
+	};
+
+	int width;
+	int height;
+	int pitch;				// pixels per stored row, whole bins
+	int storedHeight;
+	int binsX;
+	int binsY;
+	std::vector<unsigned int> color;	// RGBA8 (R in the low byte), bottom row first
+	bool clearPending;
+	unsigned int clearValue;
+
+	std::vector<Draw> draws;			// queued since the last finish()
+	unsigned int vertexCount;
+	unsigned int triangleCount;
+	std::vector<RasterVertex> vertices;
+
+	RasterWorkers* workers;
+	std::vector<RasterThread*> threads;
+	RasterStats stats;
+
+public:
+	// threadCount 0 uses every core
+	SoftwareRasterizer(unsigned int threadCount = 1);
+	~SoftwareRasterizer();
+
+	SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+	SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+	// keeps the storage when it shrinks, clamps to RASTER_MAX_SIZE. Finishes first
+	void resize(int width, int height);
+	// applied by the next finish(), before the draws queued after it
+	void clear(float r, float g, float b, float a);
+	// copies the indices, the pipeline is kept until finish()
+	void draw(const RasterPipeline& pipeline, const unsigned int* indices, unsigned int indexCount);
+	void finish();
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	int getPitch() const { return pitch; }
+	unsigned int getThreadCount() const { return (unsigned int)threads.size(); }
+	// pitch pixels per row, bottom row first, the layout glTexSubImage2D takes with
+	// GL_UNPACK_ROW_LENGTH = pitch. As of the last finish()
+	const unsigned int* getPixels() const { return color.data(); }
+	// width * height RGBA8, bottom row first, what glReadPixels returns
+	void readPixels(unsigned char* rgba) const;
+
+	RasterStats getStats() const { return stats; }
+	void resetStats() { stats = RasterStats(); }
+	void printStats() const;
+
+private:
+	void shadeVertices(unsigned int thread);
+	void binTriangles(unsigned int thread);
+	void rasterBins(unsigned int thread);
+	void rasterBin(RasterThread& thread, int bin);
+};
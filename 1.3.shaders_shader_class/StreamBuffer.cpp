@@ -0,0 +1,183 @@
+#include "StreamBuffer.h"
+#include "GLExtensions.h"
+#include "GLDebug.h"
+
+#include <iostream>
+
+static GLintptr alignUp(GLintptr offset, GLsizeiptr alignment)
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+StreamBuffer::StreamBuffer(GLsizeiptr capacity)
+	: ID(0), capacity(capacity), persistent(false), persistentPtr(NULL),
+	  head(0), tail(0), frameStart(0), mapOffset(0), mapSize(0)
+{
+	// edits go through GL_COPY_WRITE_BUFFER so they never touch the VAO / draw bindings
+	glGenBuffers(1, &ID);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+
+	if (GLExt.bufferStorage)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, capacity, NULL, flags);
+		persistentPtr = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, capacity, flags);
+		persistent = persistentPtr != NULL;
+
+		if (!persistent)
+		{
+			// immutable storage can't be respecified, start over with a mutable buffer
+			std::cout << "WARNING::STREAM_BUFFER::PERSISTENT_MAP_FAILED: falling back to orphaning" << std::endl;
+			glDeleteBuffers(1, &ID);
+			glGenBuffers(1, &ID);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+		}
+	}
+
+	if (!persistent)
+	{
+		glBufferData(GL_COPY_WRITE_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glCheckError();
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	for (const FrameFence& fence : fences)
+	{
+		glDeleteSync(fence.sync);
+	}
+
+	if (persistent)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+	glDeleteBuffers(1, &ID);
+}
+
+StreamAllocation StreamBuffer::map(GLsizeiptr size, GLsizeiptr alignment)
+{
+	StreamAllocation allocation;
+	if (size <= 0 || size > capacity)
+	{
+		std::cout << "ERROR::STREAM_BUFFER::ALLOCATION_TOO_LARGE: " << size << " > " << capacity << std::endl;
+		return allocation;
+	}
+
+	GLintptr offset;
+	if (persistent)
+	{
+		for (;;)
+		{
+			// nothing in flight, start again from the beginning for the most contiguous space
+			if (head == tail)
+			{
+				head = tail = frameStart = 0;
+			}
+
+			offset = alignUp(head, alignment);
+			if (head >= tail && offset + size > capacity)
+			{
+				offset = 0;	// wrap, the bytes left at the end stay unused for this lap
+			}
+			if (fits(offset, size))
+				break;
+
+			// the ring caught up with a frame the GPU is still reading, wait for it
+			if (!retireOldestFrame())
+			{
+				std::cout << "ERROR::STREAM_BUFFER::FRAME_OVERFLOW: more than " << capacity << " bytes in one frame" << std::endl;
+				return allocation;
+			}
+		}
+		allocation.ptr = persistentPtr + offset;
+	}
+	else
+	{
+		// 3.3 path, orphan on wrap so the driver hands out fresh storage instead of stalling
+		glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+		offset = alignUp(head, alignment);
+		if (offset + size > capacity)
+		{
+			glBufferData(GL_COPY_WRITE_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+			offset = 0;
+		}
+		allocation.ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	mapOffset = offset;
+	mapSize = size;
+	allocation.offset = offset;
+	return allocation;
+}
+
+void StreamBuffer::unmap(GLsizeiptr usedSize)
+{
+	if (usedSize > mapSize)
+		usedSize = mapSize;
+
+	if (!persistent)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+		if (usedSize > 0)
+			glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, 0, usedSize);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	// coherent mapping, the writes are visible to the next draw without a flush
+	head = mapOffset + usedSize;
+	mapSize = 0;
+}
+
+void StreamBuffer::endFrame()
+{
+	if (!persistent || head == frameStart)
+		return;
+
+	FrameFence fence;
+	fence.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	fence.end = head;
+	fences.push_back(fence);
+	frameStart = head;
+}
+
+bool StreamBuffer::fits(GLintptr offset, GLsizeiptr size) const
+{
+	// head == tail always means empty, so a full ring is never allowed to close up
+	if (head >= tail)
+	{
+		if (offset >= head)
+			return offset + size <= capacity;
+		return offset + size < tail;	// wrapped to the front
+	}
+	return offset >= head && offset + size < tail;
+}
+
+bool StreamBuffer::retireOldestFrame()
+{
+	if (fences.empty())
+		return false;
+
+	FrameFence fence = fences.front();
+	fences.pop_front();
+
+	GLenum result = glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+	while (result == GL_TIMEOUT_EXPIRED)
+	{
+		result = glClientWaitSync(fence.sync, 0, 1000000000);
+	}
+	if (result == GL_WAIT_FAILED)
+	{
+		std::cout << "ERROR::STREAM_BUFFER::FENCE_WAIT_FAILED" << std::endl;
+	}
+	glDeleteSync(fence.sync);
+
+	tail = fence.end;
+	return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <glad/glad.h>
+
+// Streaming ring buffer
+// ---------------------
+/// \note: for data that changes every frame (particles, sprites, text, per frame uniforms).
+///		   With GL 4.4 / ARB_buffer_storage the whole buffer is mapped once with
+///		   MAP_PERSISTENT | MAP_COHERENT and every endFrame() drops a fence behind the
+///		   frame's range. map() only waits when the ring catches up with a frame the GPU
+///		   has not finished yet, so the driver never has to synchronize on its own.
+///		   On plain 3.3 each map() is an unsynchronized glMapBufferRange and the buffer
+///		   is orphaned (glBufferData NULL) whenever the ring wraps.
+///
+///		   usage:
+///			StreamAllocation a = stream.map(maxBytes);
+///			memcpy(a.ptr, data, bytes);
+///			stream.unmap(bytes);                       // before drawing from a.offset
+///			...
+///			stream.endFrame();                         // after the frame's draws
+struct StreamAllocation
+{
+	void* ptr{ NULL };
+	GLintptr offset{ 0 };
+};
+
+class StreamBuffer
+{
+	unsigned int ID;
+	GLsizeiptr capacity;
+	bool persistent;
+	char* persistentPtr;
+
+	// ring state, the range [tail, head) (wrapping at capacity) may still be read by the GPU
+	GLintptr head;
+	GLintptr tail;
+	GLintptr frameStart;
+	GLintptr mapOffset;
+	GLsizeiptr mapSize;
+
+	struct FrameFence
+	{
+		GLsync sync;
+		GLintptr end;
+	};
+	std::deque<FrameFence> fences;
+
+public:
+	StreamBuffer(GLsizeiptr capacity);
+	~StreamBuffer();
+
+	StreamBuffer(const StreamBuffer&) = delete;
+	StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+	// reserves size bytes at an offset aligned to alignment, returns a NULL ptr if size can never fit
+	StreamAllocation map(GLsizeiptr size, GLsizeiptr alignment = 16);
+	// commits the first usedSize bytes of the last map()
+	void unmap(GLsizeiptr usedSize);
+	// fences everything written since the last endFrame()
+	void endFrame();
+
+	unsigned int getID() const { return ID; }
+	GLsizeiptr getCapacity() const { return capacity; }
+	bool isPersistent() const { return persistent; }
+
+private:
+	bool fits(GLintptr offset, GLsizeiptr size) const;
+	bool retireOldestFrame();
+};
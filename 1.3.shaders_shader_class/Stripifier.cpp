@@ -0,0 +1,172 @@
+#include "Stripifier.h"
+#include "GLExtensions.h"
+#include "MeshOptimizer.h"
+
+#include <unordered_map>
+
+static unsigned long long directedEdge(unsigned int from, unsigned int to)
+{
+	return ((unsigned long long)from << 32) | to;
+}
+
+std::size_t stripify(unsigned int* destination, const unsigned int* indices, std::size_t indexCount,
+	unsigned int restartIndex)
+{
+	std::size_t triangleCount = indexCount / 3;
+
+	// every directed edge of every triangle, the third vertex is implied by the triangle
+	std::unordered_multimap<unsigned long long, unsigned int> edges;
+	edges.reserve(indexCount);
+	for (std::size_t t = 0; t < triangleCount; t++)
+	{
+		for (int k = 0; k < 3; k++)
+			edges.insert(std::make_pair(directedEdge(indices[t * 3 + k], indices[t * 3 + (k + 1) % 3]), (unsigned int)t));
+	}
+
+	std::vector<bool> used(triangleCount, false);
+
+	auto hasUnused = [&](unsigned int from, unsigned int to) -> bool
+	{
+		auto range = edges.equal_range(directedEdge(from, to));
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (!used[it->second])
+				return true;
+		}
+		return false;
+	};
+
+	// unused triangle with the directed edge from -> to, writes its third vertex
+	auto findNext = [&](unsigned int from, unsigned int to, unsigned int& third) -> bool
+	{
+		auto range = edges.equal_range(directedEdge(from, to));
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			unsigned int t = it->second;
+			if (used[t])
+				continue;
+			for (int k = 0; k < 3; k++)
+			{
+				if (indices[t * 3 + k] == from && indices[t * 3 + (k + 1) % 3] == to)
+				{
+					third = indices[t * 3 + (k + 2) % 3];
+					used[t] = true;
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+
+	std::size_t written = 0;
+	for (std::size_t start = 0; start < triangleCount; start++)
+	{
+		if (used[start])
+			continue;
+		used[start] = true;
+
+		// rotate the first triangle so the strip can continue over its last edge if possible
+		const unsigned int* tri = &indices[start * 3];
+		int rotation = 0;
+		for (int r = 0; r < 3; r++)
+		{
+			if (hasUnused(tri[(r + 2) % 3], tri[(r + 1) % 3]))
+			{
+				rotation = r;
+				break;
+			}
+		}
+
+		if (written > 0)
+			destination[written++] = restartIndex;
+
+		unsigned int a = tri[(rotation + 1) % 3];
+		unsigned int b = tri[(rotation + 2) % 3];
+		destination[written++] = tri[rotation];
+		destination[written++] = a;
+		destination[written++] = b;
+
+		// triangle n of a strip is (v[n], v[n+1], v[n+2]) for even n and (v[n+1], v[n], v[n+2]) for odd n
+		for (std::size_t n = 1;; n++)
+		{
+			unsigned int c;
+			bool found = (n % 2 == 1) ? findNext(b, a, c) : findNext(a, b, c);
+			if (!found)
+				break;
+			destination[written++] = c;
+			a = b;
+			b = c;
+		}
+	}
+	return written;
+}
+
+std::size_t unstripify(unsigned int* destination, const unsigned int* strip, std::size_t stripCount, unsigned int restartIndex)
+{
+	std::size_t written = 0;
+	std::size_t n = 0;	// position in the current strip
+	for (std::size_t i = 0; i < stripCount; i++)
+	{
+		if (strip[i] == restartIndex)
+		{
+			n = 0;
+			continue;
+		}
+		if (n >= 2)
+		{
+			unsigned int a = strip[i - 2], b = strip[i - 1], c = strip[i];
+			if (n % 2 == 1)
+				std::swap(a, b);
+			if (a != b && b != c && a != c)
+			{
+				destination[written++] = a;
+				destination[written++] = b;
+				destination[written++] = c;
+			}
+		}
+		n++;
+	}
+	return written;
+}
+
+IndexEncoding chooseIndexEncoding(const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount, float maxAcmrIncrease)
+{
+	IndexEncoding list;
+	list.mode = GL_TRIANGLES;
+	list.indices.assign(indices, indices + indexCount);
+	list.acmr = analyzeVertexCache(indices, indexCount, vertexCount).acmr;
+
+	IndexEncoding strip;
+	strip.mode = GL_TRIANGLE_STRIP;
+	strip.indices.resize(stripifyBound(indexCount));
+	strip.indices.resize(stripify(strip.indices.data(), indices, indexCount));
+
+	// the post transform cache sees the strip as the triangles it expands to
+	std::vector<unsigned int> expanded(indexCount);
+	expanded.resize(unstripify(expanded.data(), strip.indices.data(), strip.indices.size()));
+	strip.acmr = analyzeVertexCache(expanded.data(), expanded.size(), vertexCount).acmr;
+
+	if (strip.indices.size() < list.indices.size() && strip.acmr <= list.acmr * maxAcmrIncrease)
+		return strip;
+	return list;
+}
+
+void enablePrimitiveRestart(GLenum indexType)
+{
+	if (GLExt.primitiveRestartFixedIndex)
+	{
+		glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+		return;
+	}
+
+	glEnable(GL_PRIMITIVE_RESTART);
+	glPrimitiveRestartIndex(indexType == GL_UNSIGNED_SHORT ? 0xFFFF : indexType == GL_UNSIGNED_BYTE ? 0xFF : 0xFFFFFFFF);
+}
+
+void disablePrimitiveRestart()
+{
+	if (GLExt.primitiveRestartFixedIndex)
+		glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+	else
+		glDisable(GL_PRIMITIVE_RESTART);
+}
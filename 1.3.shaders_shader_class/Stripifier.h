@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+
+// Triangle strips
+// ---------------
+/// \note: converts indexed triangle lists (like the indices[] of 1.2.hello_triangle_ebo) into
+///		   GL_TRIANGLE_STRIP runs separated by a restart index. A long strip needs about one
+///		   index per triangle instead of three, but every restart costs one more, and the
+///		   strip order can be worse for the vertex cache than an optimized list. So
+///		   chooseIndexEncoding() builds both and keeps the strip only when it is smaller
+///		   without giving back the cache gains. It never draws anything: --bench-strips
+///		   times both on the current driver and prints whether the choice was the faster one.
+///		   The restart index is the all ones value of the index type, what
+///		   GL_PRIMITIVE_RESTART_FIXED_INDEX uses on 4.3+. On 3.3 the same value is set with
+///		   glPrimitiveRestartIndex.
+
+// worst case strip length, every triangle on its own plus a restart
+inline std::size_t stripifyBound(std::size_t indexCount) { return indexCount / 3 * 4; }
+
+// returns the number of strip indices written, winding is preserved
+std::size_t stripify(unsigned int* destination, const unsigned int* indices, std::size_t indexCount,
+	unsigned int restartIndex = 0xFFFFFFFF);
+
+// strip back to a triangle list (drops degenerate triangles), returns the indices written
+std::size_t unstripify(unsigned int* destination, const unsigned int* strip, std::size_t stripCount, unsigned int restartIndex = 0xFFFFFFFF);
+
+struct IndexEncoding
+{
+	GLenum mode;	// GL_TRIANGLES or GL_TRIANGLE_STRIP
+	std::vector<unsigned int> indices;
+	float acmr;
+};
+
+// indices should already be cache optimized (optimizeVertexCache)
+IndexEncoding chooseIndexEncoding(const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount, float maxAcmrIncrease = 1.05f);
+
+// GL_TRIANGLE_STRIP draws with restart indices of indexType need this enabled
+void enablePrimitiveRestart(GLenum indexType);
+void disablePrimitiveRestart();
@@ -0,0 +1,312 @@
+// Generated by ShaderTranspiler.h from the shaders below, don't edit: change the shader
+// and run
+//   1.3.shaders_shader_class --transpile TranspiledShaders.cpp position.vert vertex_shader.vert vertex_color_flipped.vert vertex_color_offset.vert position_color.vert vertex_shader_quantized.vert bench.vert fragment_shader.frag position_color.frag solid_color.frag
+#include "ShaderLanes.h"
+
+#include <cstring>
+
+// position.vert
+template <typename T>
+static void positionVert(const T* shaderIn, const float* shaderUniforms, T* shaderPosition, T* shaderOut)
+{
+	(void)shaderUniforms;
+	(void)shaderOut;
+	Vec<4, T> gl_Position = splat<4>(T(0.0f));
+	Vec<3, T> aPos = loadVec<3>(shaderIn + 0);
+
+	gl_Position = makeVec<4, T>(aPos, T(1.0f));
+
+	storeVec(shaderPosition, gl_Position);
+}
+
+static const ShaderVariable POSITION_VERT_INPUTS[] =
+{
+	{ "aPos", 3, 0 },
+};
+
+// vertex_shader.vert
+template <typename T>
+static void vertexShaderVert(const T* shaderIn, const float* shaderUniforms, T* shaderPosition, T* shaderOut)
+{
+	(void)shaderUniforms;
+	Vec<4, T> gl_Position = splat<4>(T(0.0f));
+	Vec<3, T> aPos = loadVec<3>(shaderIn + 0);
+	Vec<3, T> aColor = loadVec<3>(shaderIn + 4);
+	Vec<3, T> vertexColor = splat<3>(T(0.0f));
+
+	vertexColor = aColor;
+	gl_Position = makeVec<4, T>(aPos, T(1.0f));
+
+	storeVec(shaderPosition, gl_Position);
+	storeVec(shaderOut + 0, vertexColor);
+}
+
+static const ShaderVariable VERTEX_SHADER_VERT_INPUTS[] =
+{
+	{ "aPos", 3, 0 },
+	{ "aColor", 3, 1 },
+};
+
+static const ShaderVariable VERTEX_SHADER_VERT_OUTPUTS[] =
+{
+	{ "vertexColor", 3, -1 },
+};
+
+static const ShaderVariable VERTEX_SHADER_VERT_UNIFORMS[] =
+{
+	{ "uTime", 1, -1 },
+};
+
+// vertex_color_flipped.vert
+template <typename T>
+static void vertexColorFlippedVert(const T* shaderIn, const float* shaderUniforms, T* shaderPosition, T* shaderOut)
+{
+	(void)shaderUniforms;
+	Vec<4, T> gl_Position = splat<4>(T(0.0f));
+	Vec<3, T> aPos = loadVec<3>(shaderIn + 0);
+	Vec<3, T> aColor = loadVec<3>(shaderIn + 4);
+	Vec<3, T> vertexColor = splat<3>(T(0.0f));
+
+	vertexColor = aColor;
+	gl_Position = makeVec<4, T>(aPos.c[0], (-aPos.c[1]), aPos.c[2], T(1.0f));
+
+	storeVec(shaderPosition, gl_Position);
+	storeVec(shaderOut + 0, vertexColor);
+}
+
+static const ShaderVariable VERTEX_COLOR_FLIPPED_VERT_INPUTS[] =
+{
+	{ "aPos", 3, 0 },
+	{ "aColor", 3, 1 },
+};
+
+static const ShaderVariable VERTEX_COLOR_FLIPPED_VERT_OUTPUTS[] =
+{
+	{ "vertexColor", 3, -1 },
+};
+
+// vertex_color_offset.vert
+template <typename T>
+static void vertexColorOffsetVert(const T* shaderIn, const float* shaderUniforms, T* shaderPosition, T* shaderOut)
+{
+	Vec<4, T> gl_Position = splat<4>(T(0.0f));
+	Vec<3, T> aPos = loadVec<3>(shaderIn + 0);
+	Vec<3, T> aColor = loadVec<3>(shaderIn + 4);
+	T uOffsetX = T(shaderUniforms[0]);
+	Vec<3, T> vertexColor = splat<3>(T(0.0f));
+
+	vertexColor = aColor;
+	gl_Position = makeVec<4, T>((aPos.c[0] + uOffsetX), aPos.c[1], aPos.c[2], T(1.0f));
+
+	storeVec(shaderPosition, gl_Position);
+	storeVec(shaderOut + 0, vertexColor);
+}
+
+static const ShaderVariable VERTEX_COLOR_OFFSET_VERT_INPUTS[] =
+{
+	{ "aPos", 3, 0 },
+	{ "aColor", 3, 1 },
+};
+
+static const ShaderVariable VERTEX_COLOR_OFFSET_VERT_OUTPUTS[] =
+{
+	{ "vertexColor", 3, -1 },
+};
+
+static const ShaderVariable VERTEX_COLOR_OFFSET_VERT_UNIFORMS[] =
+{
+	{ "uOffsetX", 1, -1 },
+};
+
+// position_color.vert
+template <typename T>
+static void positionColorVert(const T* shaderIn, const float* shaderUniforms, T* shaderPosition, T* shaderOut)
+{
+	(void)shaderUniforms;
+	Vec<4, T> gl_Position = splat<4>(T(0.0f));
+	Vec<3, T> aPos = loadVec<3>(shaderIn + 0);
+	Vec<3, T> vertexPosition = splat<3>(T(0.0f));
+
+	vertexPosition = aPos;
+	gl_Position = makeVec<4, T>(aPos, T(1.0f));
+
+	storeVec(shaderPosition, gl_Position);
+	storeVec(shaderOut + 0, vertexPosition);
+}
+
+static const ShaderVariable POSITION_COLOR_VERT_INPUTS[] =
+{
+	{ "aPos", 3, 0 },
+};
+
+static const ShaderVariable POSITION_COLOR_VERT_OUTPUTS[] =
+{
+	{ "vertexPosition", 3, -1 },
+};
+
+// vertex_shader_quantized.vert
+template <typename T>
+static void vertexShaderQuantizedVert(const T* shaderIn, const float* shaderUniforms, T* shaderPosition, T* shaderOut)
+{
+	Vec<4, T> gl_Position = splat<4>(T(0.0f));
+	Vec<4, T> aPos = loadVec<4>(shaderIn + 0);
+	Vec<4, T> aColor = loadVec<4>(shaderIn + 4);
+	Vec<3, T> uPositionScale = loadUniform<3, T>(shaderUniforms + 1);
+	Vec<3, T> uPositionBias = loadUniform<3, T>(shaderUniforms + 4);
+	Vec<3, T> vertexColor = splat<3>(T(0.0f));
+
+	vertexColor = swizzle<0, 1, 2>(aColor);
+	gl_Position = makeVec<4, T>(((swizzle<0, 1, 2>(aPos) * uPositionScale) + uPositionBias), T(1.0f));
+
+	storeVec(shaderPosition, gl_Position);
+	storeVec(shaderOut + 0, vertexColor);
+}
+
+static const ShaderVariable VERTEX_SHADER_QUANTIZED_VERT_INPUTS[] =
+{
+	{ "aPos", 4, 0 },
+	{ "aColor", 4, 1 },
+};
+
+static const ShaderVariable VERTEX_SHADER_QUANTIZED_VERT_OUTPUTS[] =
+{
+	{ "vertexColor", 3, -1 },
+};
+
+static const ShaderVariable VERTEX_SHADER_QUANTIZED_VERT_UNIFORMS[] =
+{
+	{ "uTime", 1, -1 },
+	{ "uPositionScale", 3, -1 },
+	{ "uPositionBias", 3, -1 },
+};
+
+// bench.vert
+template <typename T>
+static void benchVert(const T* shaderIn, const float* shaderUniforms, T* shaderPosition, T* shaderOut)
+{
+	Vec<4, T> gl_Position = splat<4>(T(0.0f));
+	Vec<3, T> aPos = loadVec<3>(shaderIn + 0);
+	T uTime = T(shaderUniforms[0]);
+	Vec<3, T> uOffset = loadUniform<3, T>(shaderUniforms + 1);
+	Vec<3, T> vertexColor = splat<3>(T(0.0f));
+
+	vertexColor = makeVec<3, T>((T(0.5f) + (T(0.5f) * glslSin(uTime))), ((swizzle<0, 1>(uOffset) * T(0.5f)) + T(0.5f)));
+	gl_Position = makeVec<4, T>(((aPos * uOffset.c[2]) + makeVec<3, T>(swizzle<0, 1>(uOffset), T(0.0f))), T(1.0f));
+
+	storeVec(shaderPosition, gl_Position);
+	storeVec(shaderOut + 0, vertexColor);
+}
+
+static const ShaderVariable BENCH_VERT_INPUTS[] =
+{
+	{ "aPos", 3, 0 },
+};
+
+static const ShaderVariable BENCH_VERT_OUTPUTS[] =
+{
+	{ "vertexColor", 3, -1 },
+};
+
+static const ShaderVariable BENCH_VERT_UNIFORMS[] =
+{
+	{ "uTime", 1, -1 },
+	{ "uOffset", 3, -1 },
+};
+
+// fragment_shader.frag
+template <typename T>
+static void fragmentShaderFrag(const T* shaderIn, const float* shaderUniforms, T* shaderOut)
+{
+	(void)shaderUniforms;
+	Vec<3, T> vertexColor = loadVec<3>(shaderIn + 0);
+	Vec<4, T> fragColor = splat<4>(T(0.0f));
+
+	fragColor = makeVec<4, T>(vertexColor, T(1.0f));
+
+	storeVec(shaderOut + 0, fragColor);
+}
+
+static const ShaderVariable FRAGMENT_SHADER_FRAG_INPUTS[] =
+{
+	{ "vertexColor", 3, -1 },
+};
+
+static const ShaderVariable FRAGMENT_SHADER_FRAG_OUTPUTS[] =
+{
+	{ "fragColor", 4, -1 },
+};
+
+static const ShaderVariable FRAGMENT_SHADER_FRAG_UNIFORMS[] =
+{
+	{ "uTime", 1, -1 },
+};
+
+// position_color.frag
+template <typename T>
+static void positionColorFrag(const T* shaderIn, const float* shaderUniforms, T* shaderOut)
+{
+	(void)shaderUniforms;
+	Vec<3, T> vertexPosition = loadVec<3>(shaderIn + 0);
+	Vec<4, T> fragColor = splat<4>(T(0.0f));
+
+	fragColor = makeVec<4, T>(vertexPosition, T(1.0f));
+
+	storeVec(shaderOut + 0, fragColor);
+}
+
+static const ShaderVariable POSITION_COLOR_FRAG_INPUTS[] =
+{
+	{ "vertexPosition", 3, -1 },
+};
+
+static const ShaderVariable POSITION_COLOR_FRAG_OUTPUTS[] =
+{
+	{ "fragColor", 4, -1 },
+};
+
+// solid_color.frag
+template <typename T>
+static void solidColorFrag(const T* shaderIn, const float* shaderUniforms, T* shaderOut)
+{
+	(void)shaderIn;
+	Vec<3, T> uColor = loadUniform<3, T>(shaderUniforms + 0);
+	Vec<4, T> fragColor = splat<4>(T(0.0f));
+
+	fragColor = makeVec<4, T>(uColor, T(1.0f));
+
+	storeVec(shaderOut + 0, fragColor);
+}
+
+static const ShaderVariable SOLID_COLOR_FRAG_OUTPUTS[] =
+{
+	{ "fragColor", 4, -1 },
+};
+
+static const ShaderVariable SOLID_COLOR_FRAG_UNIFORMS[] =
+{
+	{ "uColor", 3, -1 },
+};
+
+static const TranspiledShader TRANSPILED_SHADERS[] =
+{
+	{ "position.vert", POSITION_VERT_INPUTS, 1, NULL, 0, NULL, 0, positionVert<float>, NULL },
+	{ "vertex_shader.vert", VERTEX_SHADER_VERT_INPUTS, 2, VERTEX_SHADER_VERT_OUTPUTS, 1, VERTEX_SHADER_VERT_UNIFORMS, 1, vertexShaderVert<float>, NULL },
+	{ "vertex_color_flipped.vert", VERTEX_COLOR_FLIPPED_VERT_INPUTS, 2, VERTEX_COLOR_FLIPPED_VERT_OUTPUTS, 1, NULL, 0, vertexColorFlippedVert<float>, NULL },
+	{ "vertex_color_offset.vert", VERTEX_COLOR_OFFSET_VERT_INPUTS, 2, VERTEX_COLOR_OFFSET_VERT_OUTPUTS, 1, VERTEX_COLOR_OFFSET_VERT_UNIFORMS, 1, vertexColorOffsetVert<float>, NULL },
+	{ "position_color.vert", POSITION_COLOR_VERT_INPUTS, 1, POSITION_COLOR_VERT_OUTPUTS, 1, NULL, 0, positionColorVert<float>, NULL },
+	{ "vertex_shader_quantized.vert", VERTEX_SHADER_QUANTIZED_VERT_INPUTS, 2, VERTEX_SHADER_QUANTIZED_VERT_OUTPUTS, 1, VERTEX_SHADER_QUANTIZED_VERT_UNIFORMS, 3, vertexShaderQuantizedVert<float>, NULL },
+	{ "bench.vert", BENCH_VERT_INPUTS, 1, BENCH_VERT_OUTPUTS, 1, BENCH_VERT_UNIFORMS, 2, benchVert<float>, NULL },
+	{ "fragment_shader.frag", FRAGMENT_SHADER_FRAG_INPUTS, 1, FRAGMENT_SHADER_FRAG_OUTPUTS, 1, FRAGMENT_SHADER_FRAG_UNIFORMS, 1, NULL, fragmentShaderFrag<Float8> },
+	{ "position_color.frag", POSITION_COLOR_FRAG_INPUTS, 1, POSITION_COLOR_FRAG_OUTPUTS, 1, NULL, 0, NULL, positionColorFrag<Float8> },
+	{ "solid_color.frag", NULL, 0, SOLID_COLOR_FRAG_OUTPUTS, 1, SOLID_COLOR_FRAG_UNIFORMS, 1, NULL, solidColorFrag<Float8> }
+};
+
+const TranspiledShader* findTranspiledShader(const char* path)
+{
+	for (const TranspiledShader& shader : TRANSPILED_SHADERS)
+	{
+		if (std::strcmp(shader.path, path) == 0)
+			return &shader;
+	}
+	return NULL;
+}
@@ -0,0 +1,86 @@
+#include "VertexFormat.h"
+#include "GLExtensions.h"
+#include "GLDebug.h"
+#include "GLResources.h"
+
+void setupVertexAttributes(const VertexLayout& layout)
+{
+	for (int i = 0; i < layout.count; i++)
+	{
+		const AttributeDesc& attribute = layout.attributes[i];
+		if (attribute.integer)
+			glVertexAttribIPointer(i, attribute.components, attribute.type, layout.stride, (void*)(GLintptr)attribute.offset);
+		else
+			glVertexAttribPointer(i, attribute.components, attribute.type, attribute.normalized, layout.stride, (void*)(GLintptr)attribute.offset);
+		glEnableVertexAttribArray(i);
+	}
+}
+
+void setupVertexAttribFormat(const VertexLayout& layout, GLuint bindingIndex)
+{
+	for (int i = 0; i < layout.count; i++)
+	{
+		const AttributeDesc& attribute = layout.attributes[i];
+		if (attribute.integer)
+			glVertexAttribIFormat(i, attribute.components, attribute.type, attribute.offset);
+		else
+			glVertexAttribFormat(i, attribute.components, attribute.type, attribute.normalized, attribute.offset);
+		glVertexAttribBinding(i, bindingIndex);
+		glEnableVertexAttribArray(i);
+	}
+}
+
+VertexArrayCache::~VertexArrayCache()
+{
+	for (const std::pair<const Key, Entry>& entry : vertexArrays)
+	{
+		deleteVertexArray(entry.second.VAO);
+	}
+}
+
+unsigned int VertexArrayCache::bind(const VertexLayout& layout, unsigned int VBO, unsigned int EBO)
+{
+	const bool shared = GLExt.vertexAttribBinding;
+	Key key{ layout.hash, shared ? 0u : VBO, shared ? 0u : EBO };
+
+	std::map<Key, Entry>::iterator it = vertexArrays.find(key);
+	if (it == vertexArrays.end())
+	{
+		Entry entry{ 0, key.VBO, key.EBO };
+		if (shared && !GLExt.directStateAccess)
+		{
+			glGenVertexArrays(1, &entry.VAO);
+			bindVertexArray(entry.VAO);
+			setupVertexAttribFormat(layout);
+		}
+		else
+		{
+			entry.VAO = createVertexArray(layout, key.VBO, key.EBO);
+		}
+		it = vertexArrays.insert(std::make_pair(key, entry)).first;
+	}
+
+	Entry& entry = it->second;
+	bindVertexArray(entry.VAO);
+	if (!shared || (entry.VBO == VBO && entry.EBO == EBO))
+		return entry.VAO;
+
+	// shared format VAO, attach this mesh's buffers
+	glBindVertexBuffer(0, VBO, 0, layout.stride);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	entry.VBO = VBO;
+	entry.EBO = EBO;
+	glCheckError();
+	return entry.VAO;
+}
+
+void VertexArrayCache::detach(unsigned int buffer)
+{
+	for (std::pair<const Key, Entry>& entry : vertexArrays)
+	{
+		if (entry.second.VBO == buffer)
+			entry.second.VBO = 0;
+		if (entry.second.EBO == buffer)
+			entry.second.EBO = 0;
+	}
+}
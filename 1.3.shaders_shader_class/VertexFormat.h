@@ -0,0 +1,180 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <glad/glad.h>
+
+// Vertex formats
+// --------------
+/// \note: describes a vertex struct once at compile time instead of hand writing
+///		   glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), ...) everywhere.
+///		   Attribute i goes to location i, offsets are packed in declaration order and
+///		   padded to 4 bytes (like the C++ struct would be), the stride is their sum.
+///
+///		   struct ColorVertex
+///		   {
+///			float position[3];
+///			float color[3];
+///			typedef VertexFormat<attrib::Float<3>, attrib::Float<3>> Format;
+///		   };
+///		   VERTEX_FORMAT_CHECK(ColorVertex);
+///
+///		   setupVertexAttributes<ColorVertex::Format>();   // with the VAO and VBO bound
+
+struct AttributeDesc
+{
+	GLint components;
+	GLenum type;
+	GLboolean normalized;
+	bool integer;	// read as ivec/uvec in the shader (glVertexAttribIPointer)
+	GLsizei size;	// bytes
+	GLsizei offset;
+};
+
+namespace attrib
+{
+	template <GLint Components, GLenum Type, GLsizei ComponentSize, GLboolean Normalized, bool Integer = false>
+	struct Attribute
+	{
+		static constexpr AttributeDesc desc()
+		{
+			return AttributeDesc{ Components, Type, Normalized, Integer, Components * ComponentSize, 0 };
+		}
+	};
+
+	template <GLint N> struct Float : Attribute<N, GL_FLOAT, 4, GL_FALSE> {};
+	template <GLint N> struct Half : Attribute<N, GL_HALF_FLOAT, 2, GL_FALSE> {};
+	template <GLint N> struct UNorm8 : Attribute<N, GL_UNSIGNED_BYTE, 1, GL_TRUE> {};
+	template <GLint N> struct SNorm8 : Attribute<N, GL_BYTE, 1, GL_TRUE> {};
+	template <GLint N> struct UNorm16 : Attribute<N, GL_UNSIGNED_SHORT, 2, GL_TRUE> {};
+	template <GLint N> struct SNorm16 : Attribute<N, GL_SHORT, 2, GL_TRUE> {};
+	template <GLint N> struct Int : Attribute<N, GL_INT, 4, GL_FALSE, true> {};
+	template <GLint N> struct UInt : Attribute<N, GL_UNSIGNED_INT, 4, GL_FALSE, true> {};
+
+	// packed 10:10:10:2 in a single 32 bit word, read as a normalized vec4
+	struct SNorm10_10_10_2 : Attribute<4, GL_INT_2_10_10_10_REV, 1, GL_TRUE> {};
+	struct UNorm10_10_10_2 : Attribute<4, GL_UNSIGNED_INT_2_10_10_10_REV, 1, GL_TRUE> {};
+}
+
+template <std::size_t N>
+struct AttributeTable
+{
+	AttributeDesc items[N];
+	GLsizei stride;
+	unsigned long long hash;
+};
+
+template <std::size_t N>
+constexpr AttributeTable<N> makeAttributeTable(const AttributeDesc (&descs)[N])
+{
+	AttributeTable<N> table{};
+	GLsizei offset = 0;
+	// FNV-1a over everything that makes two layouts incompatible
+	unsigned long long hash = 14695981039346656037ull;
+	for (std::size_t i = 0; i < N; i++)
+	{
+		table.items[i] = descs[i];
+		table.items[i].offset = offset;
+		offset += (descs[i].size + 3) / 4 * 4;
+
+		const unsigned long long fields[] = { (unsigned long long)descs[i].components, descs[i].type,
+			descs[i].normalized, descs[i].integer, (unsigned long long)table.items[i].offset };
+		for (unsigned long long field : fields)
+		{
+			hash = (hash ^ field) * 1099511628211ull;
+		}
+	}
+	table.stride = offset;
+	table.hash = (hash ^ (unsigned long long)offset) * 1099511628211ull;
+	return table;
+}
+
+// runtime view of a format, what the VAO cache and buffer arena work with
+struct VertexLayout
+{
+	const AttributeDesc* attributes;
+	int count;
+	GLsizei stride;
+	unsigned long long hash;
+};
+
+template <typename... Attributes>
+struct VertexFormat
+{
+	static constexpr std::size_t count = sizeof...(Attributes);
+	static_assert(count > 0, "a vertex format needs at least one attribute");
+
+	static constexpr AttributeDesc descs[count] = { Attributes::desc()... };
+	static constexpr AttributeTable<count> table = makeAttributeTable(descs);
+	static constexpr GLsizei stride = table.stride;
+	static constexpr unsigned long long hash = table.hash;
+
+	static constexpr GLsizei offset(std::size_t i) { return table.items[i].offset; }
+
+	static VertexLayout layout()
+	{
+		return VertexLayout{ table.items, (int)count, stride, hash };
+	}
+};
+
+template <typename... Attributes>
+constexpr AttributeDesc VertexFormat<Attributes...>::descs[];
+template <typename... Attributes>
+constexpr AttributeTable<VertexFormat<Attributes...>::count> VertexFormat<Attributes...>::table;
+
+// the vertex struct and its format have to agree on the size
+#define VERTEX_FORMAT_CHECK(Vertex) \
+	static_assert(sizeof(Vertex) == Vertex::Format::stride, #Vertex " does not match its VertexFormat")
+
+// Attribute setup
+// ---------------
+// bind-to-edit path, expects the VAO and the VBO to be bound
+void setupVertexAttributes(const VertexLayout& layout);
+
+// 4.3+ path, only the format is stored in the VAO and buffers are attached per binding
+void setupVertexAttribFormat(const VertexLayout& layout, GLuint bindingIndex = 0);
+
+template <typename Format>
+void setupVertexAttributes()
+{
+	setupVertexAttributes(Format::layout());
+}
+
+// Vertex array cache
+// ------------------
+/// \note: one VAO per layout hash. With vertex_attrib_binding the VAO only holds the format,
+///		   so every buffer using the layout shares it and bind() just swaps the buffers, and
+///		   only when they aren't the ones already attached.
+///		   On 3.3 the buffers are part of the VAO, so it's one VAO per (layout, VBO, EBO).
+class VertexArrayCache
+{
+	struct Key
+	{
+		unsigned long long hash;
+		unsigned int VBO;
+		unsigned int EBO;
+		bool operator<(const Key& other) const
+		{
+			if (hash != other.hash) return hash < other.hash;
+			if (VBO != other.VBO) return VBO < other.VBO;
+			return EBO < other.EBO;
+		}
+	};
+	struct Entry
+	{
+		unsigned int VAO;
+		unsigned int VBO, EBO;	// attached to a shared VAO
+	};
+	std::map<Key, Entry> vertexArrays;
+
+public:
+	~VertexArrayCache();
+
+	// binds a VAO that reads layout from VBO (and indices from EBO, may be 0)
+	unsigned int bind(const VertexLayout& layout, unsigned int VBO, unsigned int EBO = 0);
+	// before deleting a buffer passed to bind(): a new buffer can get its name, and must not
+	// look attached already
+	void detach(unsigned int buffer);
+
+	std::size_t size() const { return vertexArrays.size(); }
+};
@@ -0,0 +1,14 @@
+#version 330
+
+layout (location = 0) in vec3 aPos;
+
+uniform float uTime;
+uniform vec3 uOffset;	// xy: position, z: scale
+
+out vec3 vertexColor;
+
+void main()
+{
+	vertexColor = vec3(0.5 + 0.5 * sin(uTime), uOffset.xy * 0.5 + 0.5);
+	gl_Position = vec4(aPos * uOffset.z + vec3(uOffset.xy, 0.0), 1.0);
+}
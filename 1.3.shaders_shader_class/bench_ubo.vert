@@ -0,0 +1,17 @@
+#version 330
+
+layout (location = 0) in vec3 aPos;
+
+// one range of the frame's buffer per draw, bound with glBindBufferRange
+layout (std140) uniform DrawData
+{
+	vec4 uOffset;	// xy: position, z: scale, w: time
+};
+
+out vec3 vertexColor;
+
+void main()
+{
+	vertexColor = vec3(0.5 + 0.5 * sin(uOffset.w), uOffset.xy * 0.5 + 0.5);
+	gl_Position = vec4(aPos * uOffset.z + vec3(uOffset.xy, 0.0), 1.0);
+}
@@ -0,0 +1,8 @@
+#version 330
+
+layout (location = 0) in vec3 aPos;
+
+void main()
+{
+	gl_Position = vec4(aPos, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#version 330
+
+in vec3 vertexPosition;
+out vec4 fragColor;
+
+void main()
+{
+	fragColor = vec4(vertexPosition, 1.0);
+}
\ No newline at end of file
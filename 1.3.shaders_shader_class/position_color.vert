@@ -0,0 +1,11 @@
+#version 330
+
+layout (location = 0) in vec3 aPos;
+
+out vec3 vertexPosition;
+
+void main()
+{
+	vertexPosition = aPos;
+	gl_Position = vec4(aPos, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 330
+
+uniform vec3 uColor;
+
+out vec4 fragColor;
+
+void main()
+{
+	fragColor = vec4(uColor, 1.0);
+}
\ No newline at end of file
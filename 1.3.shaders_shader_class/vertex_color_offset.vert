@@ -0,0 +1,14 @@
+#version 330
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+
+uniform float uOffsetX;
+
+out vec3 vertexColor;
+
+void main()
+{
+	vertexColor = aColor;
+	gl_Position = vec4(aPos.x + uOffsetX, aPos.y, aPos.z, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#version 330
+
+// cooked vertices (MeshCooker): unorm16 position in the mesh bounds, rgba8 color
+layout (location = 0) in vec4 aPos;
+layout (location = 1) in vec4 aColor;
+
+uniform float uTime;
+uniform vec3 uPositionScale;
+uniform vec3 uPositionBias;
+
+out vec3 vertexColor;
+
+void main()
+{
+	vertexColor = aColor.rgb;
+	gl_Position = vec4(aPos.xyz * uPositionScale + uPositionBias, 1.0);
+}
\ No newline at end of file